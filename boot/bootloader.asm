@@ -6,7 +6,7 @@
 ;
 ; Boot Sequence:
 ;   1. Initialize segment registers and stack
-;   2. Display boot messages with delays
+;   2. Display boot messages with delays (none in a FAST_BOOT build)
 ;   3. Recalibrate disk drive
 ;   4. Load loader from sector 2 into memory at 0x7E00
 ;   5. Transfer control to loader via far jump
@@ -24,6 +24,7 @@
 ; ============================================================================
 %include "boot/kernel_sectors.inc"
 %include "boot/loader_sectors.inc"
+%include "boot/boot_stamps.inc"
 
 %ifndef LOADER_SECTORS
 %assign LOADER_SECTORS 1
@@ -43,13 +44,17 @@ start:
     mov ss, ax          ; Stack segment
     mov sp, 0x7000      ; Stack pointer (stack grows downward from 0x7000)
     
+    ; First boot timeline stamp: the BIOS has just handed over
+    mov dword [BOOT_STAMPS_ADDR], BOOT_STAMPS_MAGIC
+    BOOT_STAMP BOOT_STAGE_BOOTSECTOR
+    
     ; Re-enable interrupts
     sti
 
     ; Display boot start message
     mov si, msg_start
     call print_string
-    call delay
+    BOOT_PAUSE
 
     ; Save boot drive number (BIOS passes it in DL)
     ; DL = 0x00 for floppy, 0x80 for hard drive
@@ -58,7 +63,7 @@ start:
     ; Display loading message
     mov si, msg_loading
     call print_string
-    call delay
+    BOOT_PAUSE
 
     ; ========================================================================
     ; Load Second-Stage Loader from Disk
@@ -95,7 +100,7 @@ start:
     ; Display success message
     mov si, msg_success
     call print_string
-    call delay
+    BOOT_PAUSE
 
     ; Ensure data segment is correct before transfer
     xor ax, ax
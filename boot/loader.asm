@@ -6,16 +6,26 @@
 ;
 ; Loader Sequence:
 ;   1. Initialize segment registers and stack in real mode
-;   2. Display loader messages with delays
-;   3. Load kernel from disk using LBA (Logical Block Addressing)
-;   4. Set up Global Descriptor Table (GDT) for protected mode
-;   5. Switch to 32-bit protected mode
-;   6. Transfer control to kernel at 0x00001000
+;   2. Display loader messages with delays (none in a FAST_BOOT build)
+;   3. Enable the A20 line and fill the boot information block (memory map,
+;      video mode, command line) for the kernel
+;   4. Load kernel and initrd from disk using LBA (Logical Block Addressing),
+;      copying each chunk above 1 MiB through unreal mode
+;   5. Set up Global Descriptor Table (GDT) for protected mode
+;   6. Switch to 32-bit protected mode
+;   7. In a KERNEL_LZ4 build, decompress the kernel into place and move the
+;      initrd after it
+;   8. Transfer control to kernel at 0x00100000 (EAX = BOOT_INFO_MAGIC,
+;      EBX = boot information block)
 ;
 ; Memory Layout:
-;   0x7E00 - 0x8FFF: Loader code and data (this code)
-;   0x9000:          Stack (grows downward)
-;   0x1000+:         Kernel (loaded from disk)
+;   0x1000 - 0x152F:   Boot information block (boot/boot_info.inc)
+;   0x7E00 - 0x8FFF:   Loader code and data (this code)
+;   0x9000:            Stack (grows downward)
+;   0x10000 - 0x1FFFF: Bounce buffer for disk reads (BIOS reads below 1 MiB only)
+;   0x100000+:         Kernel, then initrd (copied from the bounce buffer)
+;   0x400000+:         KERNEL_LZ4 only: compressed kernel, then initrd, as
+;                      read from disk (dead once the kernel runs)
 ; ============================================================================
 
 [org 0x7E00]
@@ -25,6 +35,35 @@
 ; Includes
 ; ============================================================================
 %include "boot/kernel_sectors.inc"
+%include "boot/boot_stamps.inc"
+%include "boot/boot_info.inc"
+
+; ============================================================================
+; Constants
+; ============================================================================
+; Constants tested with %if must be preprocessor symbols (%define/%assign):
+; the preprocessor cannot see equ values
+%define KERNEL_LOAD_ADDR     0x00100000 ; Kernel is copied to 1 MiB (linker.ld)
+BOUNCE_SEGMENT       equ 0x1000    ; Disk reads land at 0x1000:0000 = 0x00010000 first
+BOUNCE_ADDR          equ BOUNCE_SEGMENT * 16
+KERNEL_CHUNK_SECTORS equ 127       ; Sectors per INT 13h read (63.5 KB; the BIOS limit)
+LOADER_STACK_TOP     equ 0x9000    ; Real-mode stack grows down from here
+LOADER_STACK_RESERVE equ 0x200     ; Kept free below LOADER_STACK_TOP (see the size check)
+%assign IMAGE_SECTORS PAYLOAD_SECTORS + INITRD_SECTORS  ; Initrd follows the kernel on disk
+
+%ifdef KERNEL_LZ4
+%define LZ4_STAGING_ADDR     0x00400000 ; Disk image lands here; unpacked to KERNEL_LOAD_ADDR
+IMAGE_LOAD_ADDR      equ LZ4_STAGING_ADDR
+%if KERNEL_LOAD_ADDR + (KERNEL_SECTORS + INITRD_SECTORS) * 512 > LZ4_STAGING_ADDR
+%error "Unpacked kernel + initrd would overrun the LZ4 staging area"
+%endif
+%else
+IMAGE_LOAD_ADDR      equ KERNEL_LOAD_ADDR
+%endif
+
+%if IMAGE_SECTORS > 0xFFFF
+%error "Kernel + initrd too large for the 16-bit sector count"
+%endif
 
 ; ============================================================================
 ; Loader Entry Point (16-bit Real Mode)
@@ -39,7 +78,8 @@ loader_start:
     mov ds, ax              ; Data segment
     mov es, ax              ; Extra segment
     mov ss, ax              ; Stack segment
-    mov sp, 0x9000          ; Stack pointer (stack grows downward from 0x9000)
+    mov sp, LOADER_STACK_TOP ; Stack pointer (stack grows downward from 0x9000)
+    BOOT_STAMP BOOT_STAGE_LOADER
     
     ; Skip over protected mode code (we're in 16-bit mode now)
     jmp real_mode_start
@@ -64,11 +104,81 @@ pm_entry_32:
     
     ; Set up 32-bit stack pointer
     mov esp, 0x00089000     ; Stack pointer (below loader area)
+    BOOT_STAMP BOOT_STAGE_PMODE
+%ifdef KERNEL_LZ4
+    call unpack_kernel
+    rdtsc
+%endif
+    mov [BOOT_INFO_ADDR + boot_info.handoff_tsc], eax
+    mov [BOOT_INFO_ADDR + boot_info.handoff_tsc + 4], edx
     
-    ; Far jump to kernel entry point at 0x00001000
+    ; Far jump to kernel entry point at 0x00100000, handing over the boot
+    ; information block
     ; CS selector 0x08 = code segment (GDT entry 1, offset 0x08)
-    jmp 0x08:0x00001000
+    mov eax, BOOT_INFO_MAGIC
+    mov ebx, BOOT_INFO_ADDR
+    jmp 0x08:KERNEL_LOAD_ADDR
     
+%ifdef KERNEL_LZ4
+    ; ------------------------------------------------------------------------
+    ; Unpack the Kernel (32-bit)
+    ; ------------------------------------------------------------------------
+    ; Decompresses the LZ4 block at LZ4_STAGING_ADDR (scripts/lz4pack.py) to
+    ; KERNEL_LOAD_ADDR, then moves the initrd to the next sector boundary
+    ; after the unpacked image, where crt0.s looks for it.
+    ; Clobbers: EAX, EBX, ECX, EDX, ESI, EDI, EBP
+    ; ------------------------------------------------------------------------
+unpack_kernel:
+    cld
+    mov esi, LZ4_STAGING_ADDR
+    mov edx, LZ4_STAGING_ADDR + PAYLOAD_SIZE_BYTES  ; End of the block
+    mov edi, KERNEL_LOAD_ADDR
+.sequence:
+    movzx ebx, byte [esi]       ; Token: literal length << 4 | match length - 4
+    inc esi
+    mov eax, ebx
+    shr eax, 4
+    call lz4_length
+    mov ecx, eax
+    rep movsb                   ; Literals
+    cmp esi, edx
+    jae .unpacked               ; The last sequence has no match
+    movzx ebp, word [esi]       ; Match offset (back from EDI)
+    add esi, 2
+    mov eax, ebx
+    and eax, 0x0F
+    call lz4_length
+    lea ecx, [eax + 4]
+    push esi
+    mov esi, edi
+    sub esi, ebp
+    rep movsb                   ; Byte-wise, so overlapping matches repeat correctly
+    pop esi
+    jmp .sequence
+.unpacked:
+%if INITRD_SECTORS > 0
+    mov esi, LZ4_STAGING_ADDR + PAYLOAD_SECTORS * 512
+    mov edi, KERNEL_LOAD_ADDR + KERNEL_SECTORS * 512
+    mov ecx, INITRD_SECTORS * 128
+    rep movsd
+%endif
+    ret
+
+    ; EAX = 4-bit length from the token; 15 means more length bytes follow,
+    ; each added in, until one is below 255
+lz4_length:
+    cmp eax, 15
+    jne .done
+.more:
+    movzx ecx, byte [esi]
+    inc esi
+    add eax, ecx
+    cmp ecx, 255
+    je .more
+.done:
+    ret
+%endif
+
     ; Unreachable - return to 16-bit mode for NASM segment tracking
     bits 16
 
@@ -87,15 +197,15 @@ real_mode_start:
     ; ========================================================================
     mov si, msg_loader_start
     call print_string
-    call delay
+    BOOT_PAUSE
 
     mov si, msg_kernel_loading
     call print_string
-    call delay
+    BOOT_PAUSE
 
     mov si, msg_chs
     call print_string
-    call delay
+    BOOT_PAUSE
     
     ; Hide cursor during loading for cleaner output
     mov ah, 0x01            ; INT 10h AH=0x01: Set cursor shape
@@ -103,6 +213,18 @@ real_mode_start:
     mov cl, 0x00            ; End scanline
     int 0x10
     
+    ; ========================================================================
+    ; Enable A20 (the kernel lives above 1 MiB)
+    ; ========================================================================
+    call enable_a20
+    jnc .a20_ok
+    mov si, msg_a20_err
+    call print_string
+    cli
+    hlt
+.a20_ok:
+    call collect_boot_info
+    
     ; ========================================================================
     ; Initialize Disk Read Parameters
     ; ========================================================================
@@ -114,19 +236,42 @@ real_mode_start:
     mov byte [sectors_per_track], 63    ; Sectors per track
     mov byte [heads], 16                ; Number of heads
     
-    ; Small delay to allow disk to stabilize
+%ifndef FAST_BOOT
+    ; Small delay to allow disk to stabilize. Not needed for correctness:
+    ; the BIOS polls the controller status itself on every INT 13h call.
     mov cx, 0xFFFF
 .delay_loop:
     loop .delay_loop
+%endif
     
     ; ========================================================================
     ; Load Kernel Using LBA (Logical Block Addressing)
     ; ========================================================================
-    ; Kernel starts at sector 3 (LBA 3 = after bootloader (sector 0) and loader (sectors 1-2))
-    ; The DAP (Disk Address Packet) structure is set up below
-    mov word [dap + 8], 3       ; LBA address low word (sector 3)
-    mov word [dap + 10], 0      ; LBA address high word (0 for < 2TB drives)
-    
+    ; The kernel starts right after the loader; kernel_start_sector is patched
+    ; by the build (scripts/patch_loader_dap.py). It is read in chunks of
+    ; KERNEL_CHUNK_SECTORS: many BIOSes cap one extended read at 127 sectors
+    ; and a transfer must not cross a 64 KB segment. The BIOS can only write
+    ; below 1 MiB, so every chunk goes to the 64 KB-aligned bounce buffer and
+    ; is then copied to load_address in unreal mode.
+    ; The initrd directly follows the kernel and is read in the same pass.
+    mov eax, [kernel_start_sector]
+    mov [dap + 8], eax          ; LBA address low dword
+    mov dword [dap + 12], 0     ; LBA address high dword (0 for < 2TB drives)
+    mov word [dap + 4], 0x0000  ; Destination offset
+    mov word [dap + 6], BOUNCE_SEGMENT
+    mov word [remaining], IMAGE_SECTORS
+    mov dword [load_address], IMAGE_LOAD_ADDR
+
+.read_chunk:
+    mov cx, [remaining]
+    test cx, cx
+    jz .kernel_loaded           ; All sectors read
+    cmp cx, KERNEL_CHUNK_SECTORS
+    jbe .chunk_size_ok
+    mov cx, KERNEL_CHUNK_SECTORS
+.chunk_size_ok:
+    mov [dap + 2], cx           ; Sectors in this chunk
+
     ; Use INT 13h Extended Read (AH=0x42) with LBA addressing
     mov ah, 0x42                ; Extended Read Sectors
     mov dl, [boot_drive]        ; Drive number
@@ -135,14 +280,29 @@ real_mode_start:
     
     ; Check for read errors
     jc .read_error
+
+    movzx ecx, word [dap + 2]   ; Sectors transferred
+    add dword [dap + 8], ecx    ; Advance LBA
+    sub [remaining], cx
+
+    ; Copy the chunk above 1 MiB. The BIOS call may have reloaded DS/ES,
+    ; so unreal mode is re-entered every time (it costs a few instructions).
+    call enter_unreal
+    shl ecx, 7                  ; Sectors -> dwords (512 / 4)
+    mov esi, BOUNCE_ADDR
+    mov edi, [load_address]
+    a32 rep movsd               ; DS:ESI -> ES:EDI with 32-bit offsets
+    mov [load_address], edi
+    jmp .read_chunk
     
     ; ========================================================================
     ; Kernel Loaded Successfully
     ; ========================================================================
 .kernel_loaded:
+    BOOT_STAMP BOOT_STAGE_LOADED
     mov si, msg_kernel_loaded
     call print_string
-    call delay
+    BOOT_PAUSE
 
     ; Proceed to protected mode setup
     jmp .kernel_valid
@@ -163,7 +323,7 @@ real_mode_start:
     ; Display protected mode transition message
     mov si, msg_entering_pm
     call print_string
-    call delay
+    BOOT_PAUSE
 
     ; Load Global Descriptor Table (GDT) pointer
     ; The GDT defines memory segments for protected mode
@@ -191,6 +351,10 @@ msg_chs:            db "[LOADER] Loading kernel with LBA...", 0x0D, 0x0A, 0
 msg_kernel_loaded:  db "[LOADER] Kernel loaded successfully!", 0x0D, 0x0A, 0
 msg_entering_pm:    db "[LOADER] Entering protected mode...", 0x0D, 0x0A, 0
 msg_kernel_err:     db "[LOADER] Failed to read kernel from disk", 0x0D, 0x0A, 0
+msg_a20_err:        db "[LOADER] Could not enable the A20 line", 0x0D, 0x0A, 0
+
+; Kernel command line, copied into the boot information block
+kernel_cmdline:     db KERNEL_CMDLINE, 0
 
 ; Unused messages (kept for potential future use)
 msg_loader_here:    db "[LOADER] Loader executing", 0
@@ -251,6 +415,249 @@ delay:
     pop ax
     ret
 
+; ----------------------------------------------------------------------------
+; Enable the A20 Line
+; ----------------------------------------------------------------------------
+; With A20 masked, bit 20 of every address is forced to zero and writes above
+; 1 MiB wrap around onto low memory. Tries, cheapest first: already enabled
+; (QEMU and most modern firmware), the BIOS (INT 15h AX=2401h), the "fast
+; A20" bit in system control port 0x92, and the keyboard controller output
+; port. Each method is confirmed with a20_check.
+; Output: CF clear if A20 is enabled
+; Preserves: All registers except AX
+; ----------------------------------------------------------------------------
+enable_a20:
+    call a20_check
+    jnc .done
+
+    mov ax, 0x2401          ; INT 15h AX=2401h: Enable A20 gate
+    int 0x15
+    call a20_check
+    jnc .done
+
+    in al, 0x92             ; System control port A
+    test al, 0x02
+    jnz .kbc                ; Bit already set without effect: not this chipset
+    or al, 0x02             ; Bit 1: A20 enable
+    and al, 0xFE            ; Bit 0 would reset the machine
+    out 0x92, al
+    call a20_check
+    jnc .done
+
+.kbc:
+    call kbc_wait_input
+    mov al, 0xD1            ; Command: write output port
+    out 0x64, al
+    call kbc_wait_input
+    mov al, 0xDF            ; Output port value with A20 enabled
+    out 0x60, al
+    call kbc_wait_input
+    call a20_check
+.done:
+    ret
+
+; ----------------------------------------------------------------------------
+; Check Whether A20 is Enabled
+; ----------------------------------------------------------------------------
+; Writes to 0x107DFE and checks whether the boot signature at 0x007DFE
+; changed with it (address wrap-around).
+; Output: CF clear if enabled, set if addresses wrap at 1 MiB
+; Preserves: All registers except AX
+; ----------------------------------------------------------------------------
+a20_check:
+    push ds
+    push es
+    push si
+    push di
+    xor ax, ax
+    mov ds, ax
+    not ax
+    mov es, ax              ; ES = 0xFFFF
+    mov si, 0x7DFE          ; DS:SI = 0x007DFE
+    mov di, 0x7E0E          ; ES:DI = 0x107DFE
+    mov al, [es:di]
+    push ax
+    mov al, [ds:si]
+    push ax
+    mov byte [es:di], 0x00
+    mov byte [ds:si], 0xFF
+    cmp byte [es:di], 0xFF  ; ZF set: the write to low memory showed up above 1 MiB
+    pop ax
+    mov [ds:si], al
+    pop ax
+    mov [es:di], al
+    pop di
+    pop si
+    pop es
+    pop ds
+    clc
+    jne .enabled
+    stc
+.enabled:
+    ret
+
+; ----------------------------------------------------------------------------
+; Wait Until the Keyboard Controller Accepts Input
+; ----------------------------------------------------------------------------
+; Polls status bit 1 (input buffer full); gives up after 65535 reads so a
+; machine without an 8042 cannot hang the loader.
+; Preserves: All registers except AX
+; ----------------------------------------------------------------------------
+kbc_wait_input:
+    push cx
+    mov cx, 0xFFFF
+.poll:
+    in al, 0x64
+    test al, 0x02
+    jz .ready
+    loop .poll
+.ready:
+    pop cx
+    ret
+
+; ----------------------------------------------------------------------------
+; Fill the Boot Information Block
+; ----------------------------------------------------------------------------
+; Clears the block at BOOT_INFO_ADDR and records the boot drive, where the
+; kernel goes, the BIOS memory map, the video mode and the command line.
+; The handoff TSC is added in pm_entry_32.
+; Preserves: Segment registers
+; ----------------------------------------------------------------------------
+collect_boot_info:
+    push es
+    xor ax, ax
+    mov es, ax
+    mov di, BOOT_INFO_ADDR
+    mov cx, boot_info_size / 2
+    rep stosw
+    mov dword [BOOT_INFO_ADDR + boot_info.magic], BOOT_INFO_MAGIC
+    mov dword [BOOT_INFO_ADDR + boot_info.version], BOOT_INFO_VERSION
+    mov dword [BOOT_INFO_ADDR + boot_info.size], boot_info_size
+    movzx eax, byte [boot_drive]
+    mov [BOOT_INFO_ADDR + boot_info.boot_drive], eax
+    mov dword [BOOT_INFO_ADDR + boot_info.kernel_addr], KERNEL_LOAD_ADDR
+    mov dword [BOOT_INFO_ADDR + boot_info.kernel_size], KERNEL_SIZE_BYTES
+    mov dword [BOOT_INFO_ADDR + boot_info.image_size], IMAGE_SECTORS * 512
+    call detect_memory
+    call detect_vbe
+    call copy_cmdline
+    pop es
+    ret
+
+; ----------------------------------------------------------------------------
+; Read the BIOS Memory Map (INT 15h AX=E820h)
+; ----------------------------------------------------------------------------
+; Stores up to BOOT_E820_MAX non-empty ranges in the boot information block.
+; Input:  ES = 0
+; Preserves: Segment registers
+; ----------------------------------------------------------------------------
+detect_memory:
+    mov di, BOOT_INFO_ADDR + boot_info.e820
+    xor ebx, ebx                ; Continuation value (0 = first range)
+    xor bp, bp                  ; Ranges stored
+.next:
+    mov dword [es:di + 20], 1   ; ACPI 3.0 attributes: valid unless the BIOS says otherwise
+    mov eax, 0xE820
+    mov edx, 0x534D4150         ; "SMAP"
+    mov ecx, BOOT_E820_ENTRY_SIZE
+    int 0x15
+    jc .done                    ; Unsupported, or past the last range
+    cmp eax, 0x534D4150
+    jne .done
+    mov eax, [es:di + 8]        ; Skip empty ranges
+    or eax, [es:di + 12]
+    jz .skip
+    inc bp
+    add di, BOOT_E820_ENTRY_SIZE
+    cmp bp, BOOT_E820_MAX
+    je .done
+.skip:
+    test ebx, ebx               ; 0: that was the last range
+    jnz .next
+.done:
+    mov [BOOT_INFO_ADDR + boot_info.e820_count], bp
+    test bp, bp
+    jz .none
+    or dword [BOOT_INFO_ADDR + boot_info.flags], BOOT_INFO_HAS_E820
+.none:
+    ret
+
+; ----------------------------------------------------------------------------
+; Record the Current Video Mode (VBE)
+; ----------------------------------------------------------------------------
+; Input:  ES = 0
+; Preserves: Segment registers
+; ----------------------------------------------------------------------------
+detect_vbe:
+    mov ax, 0x4F03              ; INT 10h AX=4F03h: Return current VBE mode
+    int 0x10
+    cmp ax, 0x004F
+    jne .none
+    mov [BOOT_INFO_ADDR + boot_info.vbe_mode], bx
+    mov cx, bx
+    and cx, 0x3FFF              ; Mode number without the LFB/no-clear flags
+    mov ax, 0x4F01              ; INT 10h AX=4F01h: Return mode information
+    mov di, BOOT_INFO_ADDR + boot_info.vbe_mode_info
+    int 0x10
+    cmp ax, 0x004F
+    jne .none
+    or dword [BOOT_INFO_ADDR + boot_info.flags], BOOT_INFO_HAS_VBE
+.none:
+    ret
+
+; ----------------------------------------------------------------------------
+; Copy the Kernel Command Line
+; ----------------------------------------------------------------------------
+; Input:  ES = 0 (the block was cleared, so the copy is NUL-terminated)
+; Preserves: Segment registers
+; ----------------------------------------------------------------------------
+copy_cmdline:
+    mov si, kernel_cmdline
+    mov di, BOOT_INFO_ADDR + boot_info.cmdline
+    mov cx, BOOT_CMDLINE_MAX - 1
+.copy:
+    lodsb
+    test al, al
+    jz .end
+    stosb
+    loop .copy
+.end:
+    cmp di, BOOT_INFO_ADDR + boot_info.cmdline
+    je .empty
+    or dword [BOOT_INFO_ADDR + boot_info.flags], BOOT_INFO_HAS_CMDLINE
+.empty:
+    ret
+
+; ----------------------------------------------------------------------------
+; Enter Unreal Mode
+; ----------------------------------------------------------------------------
+; Briefly switches to protected mode to load DS and ES with the flat 4 GB
+; data descriptor, then returns to real mode. The CPU keeps the 4 GB limit
+; in its segment descriptor caches while real-mode code reloads the
+; selectors with 0, so 32-bit offsets (a32 prefix) reach all of memory
+; from then on. CS is never reloaded, so execution stays in 16-bit code.
+; Preserves: All registers except EAX, BX
+; ----------------------------------------------------------------------------
+enter_unreal:
+    pushf
+    cli
+    push ds
+    push es
+    lgdt [gdt_ptr]
+    mov eax, cr0
+    or al, 0x01             ; PE on
+    mov cr0, eax
+    jmp $ + 2               ; Serialize before the segment loads
+    mov bx, 0x10            ; Flat data descriptor
+    mov ds, bx
+    mov es, bx
+    and al, 0xFE            ; PE off
+    mov cr0, eax
+    pop es                  ; Back to segment 0, keeping the 4 GB limit
+    pop ds
+    popf
+    ret
+
 ; ----------------------------------------------------------------------------
 ; Print 32-bit Hexadecimal Number
 ; ----------------------------------------------------------------------------
@@ -401,10 +808,11 @@ sectors_per_track: db 63       ; Sectors per track (standard hard disk)
 heads:             db 16       ; Number of heads (standard hard disk)
 boot_drive:        db 0        ; Boot drive number (saved from bootloader)
 
-; Variables for kernel loading (currently unused but kept for reference)
-kernel_start_sector: dq 0x1122334455667788  ; Placeholder (patched by build script if needed)
-current_lba:        dw 0                     ; Current LBA being read
+; Variables for kernel loading
+kernel_start_sector: dq 0x1122334455667788  ; Placeholder (patched by build script with the kernel LBA)
+current_lba:        dw 0                     ; Current LBA being read (unused)
 remaining:          dw 0                     ; Remaining sectors to read
+load_address:       dd 0                     ; Where the next chunk is copied (above 1 MiB)
 
 ; ============================================================================
 ; Disk Address Packet (DAP) for LBA Reading
@@ -424,10 +832,10 @@ remaining:          dw 0                     ; Remaining sectors to read
 dap:
     db 0x10                ; Size of DAP (16 bytes)
     db 0x00                ; Reserved/unused (must be 0)
-    dw KERNEL_SECTORS      ; Number of sectors to read (from kernel_sectors.inc)
-    dw 0x1000              ; Destination offset in segment (0x1000 = where kernel loads)
-    dw 0x0000              ; Destination segment (0x0000)
-    dq 0x0000000000000000  ; LBA address (64-bit) - set at runtime to sector 3
+    dw 0                   ; Number of sectors to read (set per chunk at runtime)
+    dw 0x0000              ; Destination offset in segment (set at runtime)
+    dw BOUNCE_SEGMENT      ; Destination segment (the bounce buffer)
+    dq 0x0000000000000000  ; LBA address (64-bit) - set at runtime from kernel_start_sector
 
 ; ============================================================================
 ; GDT Pointer (for LGDT instruction)
@@ -440,3 +848,14 @@ gdt_ptr:
     dd gdt                 ; GDT base address (32-bit pointer to gdt)
 
 gdt_end:                   ; Label marking end of GDT (for reference)
+
+; ============================================================================
+; Size Check
+; ============================================================================
+; The bootloader reads the loader in whole sectors to 0x7E00, and the stack
+; grows down from LOADER_STACK_TOP. The loader must end LOADER_STACK_RESERVE
+; bytes below that, rounded down to a sector. If it does not, the TIMES count
+; below is negative and NASM stops with an error.
+; ============================================================================
+LOADER_MAX_SIZE      equ (LOADER_STACK_TOP - LOADER_STACK_RESERVE - 0x7E00) & ~511
+    times -(($ - $$) > LOADER_MAX_SIZE) db 0
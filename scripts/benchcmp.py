@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""Compare RusticOS "bench" results captured from the serial port.
+
+Usage: benchcmp.py <baseline.log> <current.log> [threshold_percent]
+
+Every line of the form {"bench": ...} is a result (other serial output is
+ignored). Benchmarks whose median grew by more than the threshold (default
+10%) are reported as regressions and make the script exit with status 1.
+"""
+import json, sys
+
+def load(path):
+    results = {}
+    with open(path, errors='replace') as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith('{"bench"'):
+                continue
+            try:
+                entry = json.loads(line)
+            except ValueError:
+                continue
+            results[entry['bench']] = entry
+    return results
+
+if len(sys.argv) < 3:
+    print("Usage: benchcmp.py <baseline.log> <current.log> [threshold_percent]", file=sys.stderr)
+    sys.exit(2)
+
+baseline = load(sys.argv[1])
+current = load(sys.argv[2])
+threshold = float(sys.argv[3]) if len(sys.argv) > 3 else 10.0
+
+regressions = 0
+print("%-20s %10s %10s %8s" % ("benchmark", "baseline", "current", "change"))
+for name, entry in current.items():
+    if name not in baseline:
+        print("%-20s %10s %10d %8s" % (name, "-", entry['median'], "new"))
+        continue
+    old = baseline[name]['median']
+    new = entry['median']
+    change = (new - old) * 100.0 / old if old else 0.0
+    flag = ""
+    if change > threshold:
+        flag = "  REGRESSION"
+        regressions += 1
+    print("%-20s %10d %10d %+7.1f%%%s" % (name, old, new, change, flag))
+
+sys.exit(1 if regressions else 0)
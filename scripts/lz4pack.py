@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Compress the flat kernel image into a raw LZ4 block for the loader.
+
+Usage: lz4pack.py <kernel.bin> <kernel.lz4>
+
+The output is a single LZ4 block (no frame header): the loader already
+knows the compressed and uncompressed sizes from boot/kernel_sectors.inc.
+Matches are found with a hash chain over 4-byte prefixes; the result is
+decompressed again and compared before it is written.
+"""
+import sys
+
+MIN_MATCH = 4
+LAST_LITERALS = 5       # The block must end with at least 5 literals ..
+MF_LIMIT = 12           # .. and the last match must start 12 bytes before the end
+MAX_OFFSET = 0xFFFF
+HASH_BITS = 16
+MAX_CHAIN = 64          # Candidates tried per position
+
+def write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+def emit(out, literals, match_length, offset):
+    lit_len = len(literals)
+    token = min(lit_len, 15) << 4
+    if match_length:
+        token |= min(match_length - MIN_MATCH, 15)
+    out.append(token)
+    if lit_len >= 15:
+        write_length(out, lit_len - 15)
+    out += literals
+    if match_length:
+        out += offset.to_bytes(2, 'little')
+        if match_length - MIN_MATCH >= 15:
+            write_length(out, match_length - MIN_MATCH - 15)
+
+def compress(data):
+    n = len(data)
+    out = bytearray()
+    head = {}
+    prev = [0] * n
+    anchor = pos = 0
+    limit = n - MF_LIMIT
+    while pos < limit:
+        key = data[pos:pos + MIN_MATCH]
+        best_len = best_off = 0
+        candidate = head.get(key, -1)
+        tries = MAX_CHAIN
+        while candidate >= 0 and pos - candidate <= MAX_OFFSET and tries:
+            length = MIN_MATCH
+            end = n - LAST_LITERALS
+            while pos + length < end and data[candidate + length] == data[pos + length]:
+                length += 1
+            if length > best_len:
+                best_len, best_off = length, pos - candidate
+            candidate = prev[candidate]
+            tries -= 1
+        prev[pos] = head.get(key, -1)
+        head[key] = pos
+        if best_len < MIN_MATCH:
+            pos += 1
+            continue
+        emit(out, data[anchor:pos], best_len, best_off)
+        for p in range(pos + 1, min(pos + best_len, limit)):
+            k = data[p:p + MIN_MATCH]
+            prev[p] = head.get(k, -1)
+            head[k] = p
+        pos += best_len
+        anchor = pos
+    emit(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+def decompress(block):
+    out = bytearray()
+    pos = 0
+    while pos < len(block):
+        token = block[pos]
+        pos += 1
+        length = token >> 4
+        if length == 15:
+            while True:
+                extra = block[pos]
+                pos += 1
+                length += extra
+                if extra != 255:
+                    break
+        out += block[pos:pos + length]
+        pos += length
+        if pos >= len(block):
+            break
+        offset = int.from_bytes(block[pos:pos + 2], 'little')
+        pos += 2
+        length = token & 15
+        if length == 15:
+            while True:
+                extra = block[pos]
+                pos += 1
+                length += extra
+                if extra != 255:
+                    break
+        for _ in range(length + MIN_MATCH):
+            out.append(out[-offset])
+    return bytes(out)
+
+if len(sys.argv) != 3:
+    print("Usage: lz4pack.py <kernel.bin> <kernel.lz4>", file=sys.stderr)
+    sys.exit(2)
+
+with open(sys.argv[1], 'rb') as f:
+    data = f.read()
+block = compress(data)
+if decompress(block) != data:
+    print("lz4pack: round trip failed", file=sys.stderr)
+    sys.exit(1)
+with open(sys.argv[2], 'wb') as f:
+    f.write(block)
+sectors = lambda size: (size + 511) // 512
+print("lz4pack: %d -> %d bytes (%d -> %d sectors, %.1f%%)" % (
+    len(data), len(block), sectors(len(data)), sectors(len(block)),
+    100.0 * len(block) / max(len(data), 1)))
@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+"""Pack files into a RusticOS initrd archive (format: src/initrd.h).
+
+Usage: mkinitrd.py <output.img> <file>...
+
+Each file is stored under its base name with any extension removed
+(build/user/hello.elf -> hello) and starts on a 4 KB boundary so the
+kernel can map it into processes without copying.
+"""
+import os, struct, sys
+
+MAGIC = 0x44524952      # "RIRD"
+VERSION = 1
+NAME_LENGTH = 32
+PAGE = 4096
+HEADER = struct.Struct('<IIII')
+ENTRY = struct.Struct('<%dsII' % NAME_LENGTH)
+
+def align(value, boundary):
+    return (value + boundary - 1) // boundary * boundary
+
+if len(sys.argv) < 2:
+    print("Usage: mkinitrd.py <output.img> <file>...", file=sys.stderr)
+    sys.exit(2)
+
+files = []
+for path in sys.argv[2:]:
+    name = os.path.splitext(os.path.basename(path))[0].encode()
+    if len(name) >= NAME_LENGTH:
+        print("mkinitrd: name too long: %s" % path, file=sys.stderr)
+        sys.exit(1)
+    with open(path, 'rb') as f:
+        files.append((name, f.read()))
+
+offset = align(HEADER.size + ENTRY.size * len(files), PAGE)
+entries, blobs = [], []
+for name, data in files:
+    entries.append(ENTRY.pack(name, offset, len(data)))
+    blobs.append((offset, data))
+    offset = align(offset + len(data), PAGE)
+total = offset if files else align(HEADER.size, PAGE)
+
+image = bytearray(total)
+image[0:HEADER.size] = HEADER.pack(MAGIC, VERSION, len(files), total)
+pos = HEADER.size
+for entry in entries:
+    image[pos:pos + ENTRY.size] = entry
+    pos += ENTRY.size
+for off, data in blobs:
+    image[off:off + len(data)] = data
+
+with open(sys.argv[1], 'wb') as f:
+    f.write(image)
+print("initrd: %d file(s), %d bytes" % (len(files), total))
@@ -0,0 +1,384 @@
+/*
+ * ============================================================================
+ * RusticOS Microbenchmark Implementation (bench.cpp)
+ * ============================================================================
+ *
+ * The registry below lists every benchmark; adding one is a function that
+ * performs count operations plus a table entry. Each sample is timed with
+ * two RDTSC reads and the measured cost of an empty read pair is subtracted,
+ * so short operations (memcpy of 64 bytes) are not dominated by the timer.
+ *
+ * Benchmarks run with interrupts enabled: a timer tick landing in a sample
+ * shows up in p99, not in the median.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "bench.h"
+#include "interrupt.h"
+#include "filesystem.h"
+#include "terminal.h"
+#include "syscall.h"
+#include "serial.h"
+#include "task.h"
+#include "format.h"
+#include "textproc.h"
+#include "output.h"
+#include "checksum.h"
+
+extern Terminal terminal;
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+static uint8_t bench_src[4096];
+static uint8_t bench_dst[4096];
+static char* volatile bench_heap_sink;          // Keeps new/delete pairs from being elided
+
+static void bench_memcpy_64(uint32_t count)   { while (count--) memcpy(bench_dst, bench_src, 64); }
+static void bench_memcpy_1k(uint32_t count)   { while (count--) memcpy(bench_dst, bench_src, 1024); }
+static void bench_memcpy_4k(uint32_t count)   { while (count--) memcpy(bench_dst, bench_src, 4096); }
+static void bench_memset_64(uint32_t count)   { while (count--) memset(bench_dst, (int)count, 64); }
+static void bench_memset_1k(uint32_t count)   { while (count--) memset(bench_dst, (int)count, 1024); }
+static void bench_memset_4k(uint32_t count)   { while (count--) memset(bench_dst, (int)count, 4096); }
+
+static void bench_heap_64(uint32_t count) {
+    while (count--) {
+        bench_heap_sink = new char[64];
+        delete[] bench_heap_sink;
+    }
+}
+
+static void bench_heap_1k(uint32_t count) {
+    while (count--) {
+        bench_heap_sink = new char[1024];
+        delete[] bench_heap_sink;
+    }
+}
+
+/**
+ * Failed lookup in the current directory (scans every entry)
+ */
+static void bench_lookup_miss(uint32_t count) {
+    while (count--) {
+        filesystem.lookup("~bench~");
+    }
+}
+
+static void bench_file_create_delete(uint32_t count) {
+    while (count--) {
+        filesystem.create_file("~bench~", "benchmark");
+        filesystem.delete_file("~bench~");
+    }
+}
+
+/**
+ * 79 characters and a carriage return: rewrites the same screen line, so
+ * the benchmark measures drawing rather than scrolling
+ */
+static const char bench_line[] =
+    "The quick brown fox jumps over the lazy dog. 0123456789 ABCDEFGHIJKLMNOPQRSTUVW\r";
+
+static void bench_terminal_write(uint32_t count) {
+    while (count--) {
+        terminal.write(bench_line, sizeof(bench_line) - 1);
+    }
+}
+
+static void bench_terminal_finish() {
+    static const char blank[] =
+        "                                                                               \r";
+    terminal.write(blank, sizeof(blank) - 1);
+}
+
+/**
+ * One line of the "bench" table: padding, 32- and 64-bit numbers (ops/s
+ * is lines per second)
+ */
+static void bench_ksnprintf(uint32_t count) {
+    char line[80];
+    while (count--) {
+        ksnprintf(line, sizeof(line), "%-20s%7u%9llu%9llu\n", "memcpy_64", count, 1234567ull, 0x123456789ull);
+    }
+}
+
+static void bench_format_u64(uint32_t count) {
+    char digits[FORMAT_MAX_DIGITS + 1];
+    while (count--) {
+        format_u64(18446744073709551557ull - count, digits);
+    }
+}
+
+/**
+ * Generated Text for the Text Processing Kernels
+ *
+ * 16 KB of lines made of pseudo-random lowercase words (a fixed LCG, so
+ * every run measures the same input), built on first use.
+ */
+#define BENCH_TEXT_SIZE     16384
+#define BENCH_TEXT_LINES    1024
+
+static char bench_text[BENCH_TEXT_SIZE];
+static LineRef bench_text_lines[BENCH_TEXT_LINES];
+static LineRef bench_sort_lines[BENCH_TEXT_LINES];
+static uint32_t bench_text_line_count;
+
+static void bench_text_init() {
+    if (bench_text_line_count) return;
+    uint32_t seed = 12345;
+    uint32_t column = 0;
+    for (uint32_t i = 0; i < BENCH_TEXT_SIZE; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t r = (seed >> 16) & 0x3F;
+        char c = (char)('a' + r % 26);
+        if (r >= 52) c = ' ';
+        if (column >= 24 && r >= 58) c = '\n';
+        bench_text[i] = c;
+        column = (c == '\n') ? 0 : column + 1;
+    }
+    bench_text[BENCH_TEXT_SIZE - 1] = '\n';
+    bench_text_line_count = text_split_lines(bench_text, BENCH_TEXT_SIZE, bench_text_lines, BENCH_TEXT_LINES);
+}
+
+static volatile uint32_t bench_text_sink;
+
+static void bench_wc_lines(uint32_t count) {
+    bench_text_init();
+    while (count--) {
+        bench_text_sink = text_count_lines(bench_text, BENCH_TEXT_SIZE);
+    }
+}
+
+static void bench_wc(uint32_t count) {
+    bench_text_init();
+    while (count--) {
+        TextCounts counts = {};
+        text_count(bench_text, BENCH_TEXT_SIZE, counts);
+        bench_text_sink = counts.words;
+    }
+}
+
+static void bench_sort(uint32_t count) {
+    bench_text_init();
+    while (count--) {
+        memcpy(bench_sort_lines, bench_text_lines, bench_text_line_count * sizeof(LineRef));
+        text_sort_lines(bench_text, bench_sort_lines, bench_text_line_count);
+    }
+}
+
+static void bench_tail(uint32_t count) {
+    bench_text_init();
+    while (count--) {
+        bench_text_sink = text_tail_offset(bench_text, BENCH_TEXT_SIZE, 10);
+    }
+}
+
+/**
+ * head -n 1024 of the 16 KB text: more lines than it has, so every byte is
+ * scanned (the file path of head)
+ */
+static void bench_head(uint32_t count) {
+    bench_text_init();
+    while (count--) {
+        uint32_t lines = BENCH_TEXT_LINES;
+        bench_text_sink = text_head_length(bench_text, BENCH_TEXT_SIZE, &lines);
+    }
+}
+
+/**
+ * Output sink that only counts bytes, so uniq is measured without a device
+ */
+class BenchCountSink : public OutputSink {
+public:
+    using OutputSink::write;
+    void write(const char*, uint32_t len) override { bench_text_sink += len; }
+};
+
+static void bench_uniq(uint32_t count) {
+    bench_text_init();
+    BenchCountSink sink;
+    while (count--) {
+        LineReader reader(bench_text, BENCH_TEXT_SIZE);
+        text_uniq(reader, nullptr, false, sink);     // File data: lines persist
+    }
+}
+
+/**
+ * Checksums of 4 KB (the generated text; cycles/op convert to MB/s)
+ */
+static void bench_crc32(uint32_t count) {
+    bench_text_init();
+    while (count--) {
+        bench_text_sink = crc32_update(0, bench_text, 4096);
+    }
+}
+
+static void bench_adler32(uint32_t count) {
+    bench_text_init();
+    while (count--) {
+        bench_text_sink = adler32_update(1, bench_text, 4096);
+    }
+}
+
+static void bench_sha256(uint32_t count) {
+    bench_text_init();
+    while (count--) {
+        Sha256Context ctx;
+        uint8_t digest[SHA256_DIGEST_SIZE];
+        sha256_init(ctx);
+        sha256_update(ctx, bench_text, 4096);
+        sha256_final(ctx, digest);
+        bench_text_sink = digest[0];
+    }
+}
+
+/**
+ * INT 0x80 from ring 0: interrupt entry, null system call dispatch, IRET
+ */
+static void bench_int80(uint32_t count) {
+    while (count--) {
+        uint32_t result;
+        asm volatile("int $0x80" : "=a"(result) : "a"(SYS_NULL) : "memory");
+    }
+}
+
+static const Benchmark bench_table[] = {
+    { "memcpy_64",          64, bench_memcpy_64,          nullptr },
+    { "memcpy_1k",          16, bench_memcpy_1k,          nullptr },
+    { "memcpy_4k",          4,  bench_memcpy_4k,          nullptr },
+    { "memset_64",          64, bench_memset_64,          nullptr },
+    { "memset_1k",          16, bench_memset_1k,          nullptr },
+    { "memset_4k",          4,  bench_memset_4k,          nullptr },
+    { "heap_alloc_free_64", 64, bench_heap_64,            nullptr },
+    { "heap_alloc_free_1k", 64, bench_heap_1k,            nullptr },
+    { "lookup_miss",        32, bench_lookup_miss,        nullptr },
+    { "file_create_delete", 16, bench_file_create_delete, nullptr },
+    { "terminal_write_80",  4,  bench_terminal_write,     bench_terminal_finish },
+    { "ksnprintf_line",     32, bench_ksnprintf,          nullptr },
+    { "format_u64",         32, bench_format_u64,         nullptr },
+    { "wc_lines_16k",       4,  bench_wc_lines,           nullptr },
+    { "wc_16k",             4,  bench_wc,                 nullptr },
+    { "sort_16k",           1,  bench_sort,               nullptr },
+    { "tail_10_16k",        16, bench_tail,               nullptr },
+    { "head_1024_16k",      4,  bench_head,               nullptr },
+    { "uniq_16k",           1,  bench_uniq,               nullptr },
+    { "crc32_4k",           4,  bench_crc32,              nullptr },
+    { "adler32_4k",         4,  bench_adler32,            nullptr },
+    { "sha256_4k",          1,  bench_sha256,             nullptr },
+    { "int80_round_trip",   32, bench_int80,              nullptr },
+};
+
+static const uint32_t BENCH_COUNT = sizeof(bench_table) / sizeof(bench_table[0]);
+
+uint32_t bench_count() {
+    return BENCH_COUNT;
+}
+
+const Benchmark& bench_get(uint32_t index) {
+    return bench_table[index];
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+/**
+ * Cost of an Empty RDTSC Pair
+ *
+ * The minimum over a few tries, so an interrupt cannot inflate it.
+ */
+static uint64_t timer_overhead() {
+    uint64_t best = ~0ull;
+    for (uint32_t i = 0; i < 16; ++i) {
+        uint64_t start = read_tsc();
+        uint64_t cycles = read_tsc() - start;
+        if (cycles < best) best = cycles;
+    }
+    return best;
+}
+
+/**
+ * Run a Benchmark
+ *
+ * @param bench Registry entry
+ * @param samples Timed samples (clamped to 1..BENCH_MAX_SAMPLES)
+ * @param result Receives the per-operation cycle statistics
+ * @return true on success, false if the task was cancelled (Ctrl+C)
+ */
+bool bench_run(const Benchmark& bench, uint32_t samples, BenchResult* result) {
+    uint64_t cycles[BENCH_MAX_SAMPLES];     // 2 KB of the task stack: runs in several jobs stay apart
+    if (samples == 0) samples = 1;
+    if (samples > BENCH_MAX_SAMPLES) samples = BENCH_MAX_SAMPLES;
+
+    uint64_t overhead = timer_overhead();
+    bool cancelled = false;
+    for (uint32_t i = 0; i < BENCH_WARMUP_SAMPLES + samples; ++i) {
+        // Yield between samples, never inside one
+        if (task_poll()) {
+            cancelled = true;
+            break;
+        }
+        uint64_t start = read_tsc();
+        bench.run(bench.batch);
+        uint64_t elapsed = read_tsc() - start;
+        if (i >= BENCH_WARMUP_SAMPLES) {
+            elapsed = (elapsed > overhead) ? elapsed - overhead : 0;
+            cycles[i - BENCH_WARMUP_SAMPLES] = div_u64(elapsed, bench.batch);
+        }
+    }
+    if (bench.finish) {
+        bench.finish();
+    }
+    if (cancelled) {
+        return false;
+    }
+
+    // Insertion sort: at most BENCH_MAX_SAMPLES values
+    for (uint32_t i = 1; i < samples; ++i) {
+        uint64_t value = cycles[i];
+        uint32_t j = i;
+        for (; j > 0 && cycles[j - 1] > value; --j) {
+            cycles[j] = cycles[j - 1];
+        }
+        cycles[j] = value;
+    }
+    result->samples = samples;
+    result->min = cycles[0];
+    result->median = cycles[samples / 2];
+    result->p99 = cycles[(samples * 99 + 99) / 100 - 1];    // Nearest rank
+    return true;
+}
+
+/**
+ * Report a Result on COM1
+ *
+ * One line per benchmark, e.g.
+ *   {"bench":"memcpy_64","batch":64,"samples":32,"min":40,"median":42,"p99":97,"tsc_khz":2400000}
+ */
+void bench_report_serial(const Benchmark& bench, const BenchResult& result) {
+    char line[160];
+    uint32_t len = ksnprintf(line, sizeof(line),
+                             "{\"bench\":\"%s\",\"batch\":%u,\"samples\":%u,\"min\":%llu,"
+                             "\"median\":%llu,\"p99\":%llu,\"tsc_khz\":%u}\n",
+                             bench.name, bench.batch, result.samples, result.min,
+                             result.median, result.p99, get_tsc_khz());
+    serial_write(line, len < sizeof(line) ? len : sizeof(line) - 1);
+}
+
+/**
+ * Operations per Second at the Median
+ *
+ * Converts cycles per operation with the calibrated TSC rate, e.g. lines
+ * per second for ksnprintf_line.
+ *
+ * @return Rate, or 0 if the TSC is uncalibrated or the median is 0
+ */
+uint64_t bench_per_second(const BenchResult& result) {
+    uint32_t khz = get_tsc_khz();
+    if (khz == 0 || result.median == 0 || result.median > 0xFFFFFFFFull) {
+        return 0;
+    }
+    return div_u64((uint64_t)khz * 1000, (uint32_t)result.median);
+}
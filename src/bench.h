@@ -0,0 +1,58 @@
+/*
+ * ============================================================================
+ * RusticOS Microbenchmark Header (bench.h)
+ * ============================================================================
+ *
+ * A registry of kernel microbenchmarks run by the "bench" command. Each
+ * benchmark performs a batch of operations per timed sample; after
+ * BENCH_WARMUP_SAMPLES untimed samples the TSC cost of every sample is
+ * divided by the batch size, and the median and 99th percentile of these
+ * per-operation costs are reported.
+ *
+ * Results are also written to the serial port as one JSON object per line
+ * so a host script can collect them and track regressions.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "types.h"
+
+// ============================================================================
+// Benchmark Constants
+// ============================================================================
+#define BENCH_MAX_SAMPLES       256
+#define BENCH_DEFAULT_SAMPLES   32
+#define BENCH_WARMUP_SAMPLES    4
+
+/**
+ * Benchmark - one registry entry
+ */
+struct Benchmark {
+    const char* name;
+    uint32_t batch;                     // Operations per timed sample
+    void (*run)(uint32_t count);        // Perform count operations
+    void (*finish)();                   // Clean up after the last sample (may be nullptr)
+};
+
+/**
+ * Result of one benchmark, in TSC cycles per operation
+ */
+struct BenchResult {
+    uint32_t samples;
+    uint64_t min;
+    uint64_t median;
+    uint64_t p99;
+};
+
+// Benchmark functions
+uint32_t bench_count();                                     // Number of registered benchmarks
+const Benchmark& bench_get(uint32_t index);
+bool bench_run(const Benchmark& bench, uint32_t samples, BenchResult* result);  // false if cancelled
+void bench_report_serial(const Benchmark& bench, const BenchResult& result);   // JSON line on COM1
+uint64_t bench_per_second(const BenchResult& result);      // Operations per second at the median (0 if unknown)
+
+#endif // BENCH_H
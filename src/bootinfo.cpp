@@ -0,0 +1,115 @@
+/*
+ * ============================================================================
+ * RusticOS Boot Information Implementation (bootinfo.cpp)
+ * ============================================================================
+ *
+ * The block the loader left in low memory is copied into the kernel image
+ * so later code never depends on that memory staying untouched.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "bootinfo.h"
+#include "multiboot.h"
+#include "output.h"
+#include "format.h"
+
+static_assert(sizeof(E820Entry) == 24, "E820Entry must match boot/boot_info.inc");
+static_assert(sizeof(VbeModeInfo) == 256, "VbeModeInfo must be the VBE 256-byte block");
+static_assert(__builtin_offsetof(BootInfo, e820) == 48, "BootInfo must match boot/boot_info.inc");
+static_assert(sizeof(BootInfo) == 1328, "BootInfo must match boot/boot_info.inc");
+
+static BootInfo info_copy;
+static bool info_valid;             // Set by boot_info_init()
+
+bool boot_info_init(uint32_t magic, uint32_t info_addr) {
+    info_valid = false;
+    if (multiboot_magic(magic)) {
+        info_valid = multiboot_read_info(magic, info_addr, &info_copy);
+        return info_valid;
+    }
+    const BootInfo* info = (const BootInfo*)(uintptr_t)info_addr;
+    if (magic != BOOT_INFO_MAGIC || !info ||
+        info->magic != BOOT_INFO_MAGIC || info->version != BOOT_INFO_VERSION ||
+        info->size != sizeof(BootInfo)) {
+        return false;
+    }
+    memcpy(&info_copy, info, sizeof(BootInfo));
+    if (info_copy.e820_count > BOOT_E820_MAX) {
+        info_copy.e820_count = BOOT_E820_MAX;
+    }
+    info_copy.cmdline[BOOT_CMDLINE_MAX - 1] = '\0';
+    info_valid = true;
+    return true;
+}
+
+const BootInfo* boot_info() {
+    return info_valid ? &info_copy : nullptr;
+}
+
+const char* boot_cmdline() {
+    return info_valid ? info_copy.cmdline : "";
+}
+
+/**
+ * Total Usable RAM According to the BIOS Memory Map
+ */
+uint64_t boot_usable_memory() {
+    if (!info_valid || !(info_copy.flags & BOOT_INFO_HAS_E820)) {
+        return 0;
+    }
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < info_copy.e820_count; ++i) {
+        const E820Entry& entry = info_copy.e820[i];
+        if (entry.type == E820_USABLE && (entry.acpi & 1)) {
+            total += entry.length;
+        }
+    }
+    return total;
+}
+
+static const char* e820_type_name(uint32_t type) {
+    switch (type) {
+        case E820_USABLE:           return "usable";
+        case E820_RESERVED:         return "reserved";
+        case E820_ACPI_RECLAIMABLE: return "ACPI reclaimable";
+        case E820_ACPI_NVS:         return "ACPI NVS";
+        case E820_BAD:              return "bad";
+        default:                    return "unknown";
+    }
+}
+
+void boot_info_print(OutputSink& out) {
+    if (!info_valid) {
+        out.write("No boot information (kernel not started by the RusticOS loader)\n");
+        return;
+    }
+    const BootInfo& info = info_copy;
+    kprintf(out, "Boot information (version %u, from the %s):\n", info.version,
+            (info.flags & BOOT_INFO_MULTIBOOT) ? "Multiboot loader" : "RusticOS loader");
+    kprintf(out, "  Boot drive:   0x%02x\n", info.boot_drive);
+    kprintf(out, "  Kernel:       %u bytes at 0x%08x (%u bytes with initrd)\n",
+            info.kernel_size, info.kernel_addr, info.image_size);
+    kprintf(out, "  Handoff TSC:  %llu\n", info.handoff_tsc);
+    kprintf(out, "  Command line: %s\n", (info.flags & BOOT_INFO_HAS_CMDLINE) ? info.cmdline : "(none)");
+
+    if (info.flags & BOOT_INFO_HAS_VBE) {
+        const VbeModeInfo& vbe = info.vbe_mode_info;
+        kprintf(out, "  Video mode:   0x%04x, %ux%u, %u bpp\n", info.vbe_mode, vbe.width, vbe.height, vbe.bpp);
+    } else {
+        out.write("  Video mode:   no VBE mode information\n");
+    }
+
+    if (!(info.flags & BOOT_INFO_HAS_E820)) {
+        out.write("  Memory map:   not available\n");
+        return;
+    }
+    kprintf(out, "  Memory map:   %u ranges, %llu KiB usable\n",
+            info.e820_count, boot_usable_memory() >> 10);
+    for (uint32_t i = 0; i < info.e820_count; ++i) {
+        const E820Entry& entry = info.e820[i];
+        kprintf(out, "    %016llx-%016llx  %s\n",
+                entry.base, entry.base + entry.length - 1, e820_type_name(entry.type));
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * ============================================================================
+ * RusticOS Boot Information Header (bootinfo.h)
+ * ============================================================================
+ *
+ * What the loader found out before the kernel started: the BIOS memory map
+ * (E820), the boot drive, the video mode, where the kernel was loaded, the
+ * TSC at the handoff and the kernel command line. The loader passes the
+ * block's address in EBX (EAX = BOOT_INFO_MAGIC) and crt0.s hands both to
+ * kernel_main, which calls boot_info_init() to keep a copy. When a Multiboot
+ * loader started the kernel, the copy is translated from its information
+ * structure instead (multiboot.h).
+ *
+ * The layout matches boot/boot_info.inc field for field.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef BOOTINFO_H
+#define BOOTINFO_H
+
+#include "types.h"
+
+class OutputSink;
+
+// ============================================================================
+// Boot Information Constants (boot/boot_info.inc)
+// ============================================================================
+#define BOOT_INFO_MAGIC         0x4E494252  // "RBIN"
+#define BOOT_INFO_VERSION       1
+#define BOOT_E820_MAX           32
+#define BOOT_CMDLINE_MAX        256
+
+// BootInfo.flags
+#define BOOT_INFO_HAS_E820      0x01
+#define BOOT_INFO_HAS_VBE       0x02
+#define BOOT_INFO_HAS_CMDLINE   0x04
+#define BOOT_INFO_MULTIBOOT     0x08        // Translated from Multiboot information (kernel only)
+
+// E820 range types
+#define E820_USABLE             1
+#define E820_RESERVED           2
+#define E820_ACPI_RECLAIMABLE   3
+#define E820_ACPI_NVS           4
+#define E820_BAD                5
+
+/**
+ * One range of the BIOS memory map
+ */
+struct E820Entry {
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;                  // E820_*
+    uint32_t acpi;                  // ACPI 3.0 extended attributes
+} __attribute__((packed));
+
+/**
+ * VBE mode information (INT 10h AX=4F01h); only the fields used are named
+ */
+struct VbeModeInfo {
+    uint16_t attributes;
+    uint8_t window_a, window_b;
+    uint16_t granularity, window_size;
+    uint16_t segment_a, segment_b;
+    uint32_t window_function;
+    uint16_t pitch;                 // Bytes per scan line
+    uint16_t width, height;         // Pixels (characters in text modes)
+    uint8_t char_width, char_height, planes, bpp, banks, memory_model;
+    uint8_t bank_size, image_pages, reserved0;
+    uint8_t color_masks[9];
+    uint32_t framebuffer;           // Linear frame buffer address
+    uint8_t reserved1[212];
+} __attribute__((packed));
+
+/**
+ * Boot Information Block
+ */
+struct BootInfo {
+    uint32_t magic;                 // BOOT_INFO_MAGIC
+    uint32_t version;               // BOOT_INFO_VERSION
+    uint32_t size;                  // Bytes in this block
+    uint32_t flags;                 // BOOT_INFO_HAS_*
+    uint32_t boot_drive;            // BIOS drive number
+    uint32_t kernel_addr;           // Physical load address
+    uint32_t kernel_size;           // Kernel image bytes
+    uint32_t image_size;            // Kernel + initrd bytes read from disk
+    uint64_t handoff_tsc;           // TSC at the jump to the kernel
+    uint16_t vbe_mode;
+    uint16_t reserved;
+    uint32_t e820_count;
+    E820Entry e820[BOOT_E820_MAX];
+    VbeModeInfo vbe_mode_info;
+    char cmdline[BOOT_CMDLINE_MAX];
+} __attribute__((packed));
+
+// Boot information functions
+bool boot_info_init(uint32_t magic, uint32_t info_addr);   // Keep a copy; false if none was passed
+const BootInfo* boot_info();                // nullptr if the loader passed none
+const char* boot_cmdline();                 // "" without a command line
+uint64_t boot_usable_memory();              // Bytes of E820 usable RAM (0 if unknown)
+void boot_info_print(OutputSink& out);      // Human-readable dump (bootinfo command)
+
+#endif // BOOTINFO_H
@@ -0,0 +1,113 @@
+/*
+ * ============================================================================
+ * RusticOS Boot Timeline Implementation (boottime.cpp)
+ * ============================================================================
+ *
+ * The loader stamps are copied out of low memory by boot_timeline_init()
+ * before anything else can reuse that area. A missing magic word (booted
+ * by something other than our boot sector) leaves those stages out.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "boottime.h"
+#include "interrupt.h"
+#include "output.h"
+#include "format.h"
+
+/**
+ * Boot stamp area written by the boot sector and loader
+ */
+struct BootStamps {
+    uint32_t magic;
+    uint32_t reserved;
+    uint64_t tsc[BOOT_FIRMWARE_STAGES];
+};
+
+/**
+ * One Recorded Stage
+ */
+struct BootStage {
+    const char* name;
+    uint64_t tsc;                   // TSC when the stage was complete
+};
+
+static const char* const firmware_stage_names[BOOT_FIRMWARE_STAGES] = {
+    "boot sector entry",
+    "loader entry",
+    "kernel read from disk",
+    "protected mode",
+};
+
+// Filled in by boot_timeline_init()
+static BootStage stages[BOOT_MAX_STAGES];
+static uint32_t stage_count;
+
+void boot_timeline_init() {
+    stage_count = 0;
+    // GCC takes pointers into the first page for null-pointer arithmetic;
+    // passing the address through an empty asm hides where it came from
+    uintptr_t address = BOOT_STAMPS_ADDR;
+    asm("" : "+r"(address));
+    const BootStamps* stamps = (const BootStamps*)address;
+    if (stamps->magic == BOOT_STAMPS_MAGIC) {
+        for (uint32_t i = 0; i < BOOT_FIRMWARE_STAGES; ++i) {
+            stages[stage_count].name = firmware_stage_names[i];
+            stages[stage_count].tsc = stamps->tsc[i];
+            stage_count++;
+        }
+    }
+    boot_stamp("kernel entry");
+}
+
+void boot_stamp(const char* stage) {
+    if (stage_count < BOOT_MAX_STAGES) {
+        stages[stage_count].name = stage;
+        stages[stage_count].tsc = read_tsc();
+        stage_count++;
+    }
+}
+
+/**
+ * Print a Duration in Milliseconds with Three Decimals
+ */
+static void print_ms(OutputSink& out, uint64_t cycles) {
+    uint32_t us = (uint32_t)tsc_to_us(cycles);
+    kprintf(out, "%7u.%03u ms", us / 1000, us % 1000);
+}
+
+/**
+ * Print the Timeline
+ *
+ * Each row shows when a stage was complete, relative to the first stamp,
+ * and how long it took since the previous one. The TSC counts from CPU
+ * reset, so the first stamp also tells how long the firmware ran.
+ */
+void boot_timeline_print(OutputSink& out) {
+    if (stage_count == 0) {
+        out.write("No boot timeline recorded\n");
+        return;
+    }
+    if (get_tsc_khz() == 0) {
+        out.write("Boot timeline unavailable: TSC not calibrated\n");
+        return;
+    }
+
+    uint64_t base = stages[0].tsc;
+    kprintf(out, "Boot timeline (TSC %u kHz):\n", get_tsc_khz());
+    kprintf(out, "  %-28s ", "firmware before first stamp");
+    print_ms(out, base);
+    out.put('\n');
+    kprintf(out, "  %-28s %14s %14s\n", "stage", "at", "took");
+    for (uint32_t i = 0; i < stage_count; ++i) {
+        kprintf(out, "  %-28s ", stages[i].name);
+        print_ms(out, stages[i].tsc - base);
+        out.put(' ');
+        print_ms(out, i > 0 ? stages[i].tsc - stages[i - 1].tsc : 0);
+        out.put('\n');
+    }
+    kprintf(out, "  %-28s ", "total");
+    print_ms(out, stages[stage_count - 1].tsc - base);
+    out.put('\n');
+}
@@ -0,0 +1,41 @@
+/*
+ * ============================================================================
+ * RusticOS Boot Timeline Header (boottime.h)
+ * ============================================================================
+ *
+ * Time-stamp counter readings for every boot stage, from the BIOS handing
+ * over to the boot sector up to the first shell prompt. The boot sector and
+ * the loader leave their stamps in low memory (boot/boot_stamps.inc); the
+ * kernel adds one per kernel_main phase with boot_stamp(). The timeline is
+ * written to the serial port once the kernel is ready and is shown again by
+ * the boottime command.
+ *
+ * Stamps are raw TSC values, so phases before calibrate_tsc() can be
+ * recorded too; they are converted to microseconds only when printed.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef BOOTTIME_H
+#define BOOTTIME_H
+
+#include "types.h"
+
+class OutputSink;
+
+// ============================================================================
+// Boot Timeline Constants
+// ============================================================================
+#define BOOT_STAMPS_ADDR        0x0500      // Must match boot/boot_stamps.inc
+#define BOOT_STAMPS_MAGIC       0x4D545342  // "BSTM"
+#define BOOT_FIRMWARE_STAGES    4           // Stamps taken by the boot sector and loader
+#define BOOT_MAX_STAGES         24          // Firmware plus kernel stages
+
+// Boot timeline functions
+void boot_timeline_init();                  // Collect the loader stamps (first thing in kernel_main)
+void boot_stamp(const char* stage);         // Record the end of a kernel boot stage
+void boot_timeline_print(OutputSink& out);  // Stage table with offsets and durations
+                                            // (serial_sink at boot, the boottime command)
+
+#endif // BOOTTIME_H
@@ -0,0 +1,272 @@
+/*
+ * ============================================================================
+ * RusticOS Checksum Implementation (checksum.cpp)
+ * ============================================================================
+ *
+ * Multi-byte loads go through an unaligned, may_alias type so the kernels
+ * can run directly on file data at any offset.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "checksum.h"
+
+typedef uint32_t __attribute__((may_alias, aligned(1))) unaligned_u32;
+
+// ============================================================================
+// CRC-32
+// ============================================================================
+
+#define CRC32_POLYNOMIAL    0xEDB88320u     // Reflected IEEE polynomial
+
+/**
+ * Slicing-by-8 Tables
+ *
+ * table[0] is the classic byte-at-a-time table; table[k][b] is the CRC of
+ * byte b followed by k zero bytes, so eight table lookups advance the CRC
+ * by eight bytes.
+ */
+struct Crc32Tables {
+    uint32_t table[8][256];
+};
+
+static constexpr Crc32Tables build_crc32_tables() {
+    Crc32Tables t = {};
+    for (uint32_t b = 0; b < 256; ++b) {
+        uint32_t crc = b;
+        for (uint32_t bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32_POLYNOMIAL : 0);
+        }
+        t.table[0][b] = crc;
+    }
+    for (uint32_t k = 1; k < 8; ++k) {
+        for (uint32_t b = 0; b < 256; ++b) {
+            uint32_t previous = t.table[k - 1][b];
+            t.table[k][b] = (previous >> 8) ^ t.table[0][previous & 0xFF];
+        }
+    }
+    return t;
+}
+
+static constexpr Crc32Tables crc32_tables = build_crc32_tables();
+
+/**
+ * Continue a CRC-32
+ *
+ * @param crc Result of the previous call (0 to start)
+ * @return CRC-32 of everything fed so far
+ */
+uint32_t crc32_update(uint32_t crc, const void* data, uint32_t len) {
+    const uint32_t (*t)[256] = crc32_tables.table;
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    for (; len >= 8; p += 8, len -= 8) {
+        uint32_t one = *(const unaligned_u32*)p ^ crc;
+        uint32_t two = *(const unaligned_u32*)(p + 4);
+        crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^
+              t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24] ^
+              t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^
+              t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return ~crc;
+}
+
+// ============================================================================
+// Adler-32
+// ============================================================================
+
+#define ADLER32_MOD     65521u
+#define ADLER32_NMAX    5552u       // Most bytes before b can overflow 32 bits
+
+/**
+ * Continue an Adler-32
+ *
+ * @param adler Result of the previous call (1 to start)
+ */
+uint32_t adler32_update(uint32_t adler, const void* data, uint32_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    while (len > 0) {
+        uint32_t chunk = (len < ADLER32_NMAX) ? len : ADLER32_NMAX;
+        len -= chunk;
+        for (; chunk >= 8; p += 8, chunk -= 8) {
+            a += p[0]; b += a;
+            a += p[1]; b += a;
+            a += p[2]; b += a;
+            a += p[3]; b += a;
+            a += p[4]; b += a;
+            a += p[5]; b += a;
+            a += p[6]; b += a;
+            a += p[7]; b += a;
+        }
+        while (chunk--) {
+            a += *p++;
+            b += a;
+        }
+        a %= ADLER32_MOD;
+        b %= ADLER32_MOD;
+    }
+    return (b << 16) | a;
+}
+
+// ============================================================================
+// SHA-256
+// ============================================================================
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(x, n)      (((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x, y, z)     ((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x, y, z)    (((x) & (y)) | ((z) & ((x) | (y))))
+#define SIGMA0(x)       (ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define SIGMA1(x)       (ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+#define GAMMA0(x)       (ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define GAMMA1(x)       (ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+
+// One round; the caller rotates the variable names instead of the values
+#define SHA256_ROUND(a, b, c, d, e, f, g, h, i) do {                        \
+        uint32_t t1 = h + SIGMA1(e) + CH(e, f, g) + sha256_k[i] + w[i];     \
+        d += t1;                                                            \
+        h = t1 + SIGMA0(a) + MAJ(a, b, c);                                  \
+    } while (0)
+
+static inline uint32_t load_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void sha256_block(uint32_t* state, const uint8_t* block) {
+    uint32_t w[64];
+    for (uint32_t i = 0; i < 16; ++i) {
+        w[i] = load_be32(block + i * 4);
+    }
+    for (uint32_t i = 16; i < 64; ++i) {
+        w[i] = GAMMA1(w[i - 2]) + w[i - 7] + GAMMA0(w[i - 15]) + w[i - 16];
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (uint32_t i = 0; i < 64; i += 8) {
+        SHA256_ROUND(a, b, c, d, e, f, g, h, i);
+        SHA256_ROUND(h, a, b, c, d, e, f, g, i + 1);
+        SHA256_ROUND(g, h, a, b, c, d, e, f, i + 2);
+        SHA256_ROUND(f, g, h, a, b, c, d, e, i + 3);
+        SHA256_ROUND(e, f, g, h, a, b, c, d, i + 4);
+        SHA256_ROUND(d, e, f, g, h, a, b, c, i + 5);
+        SHA256_ROUND(c, d, e, f, g, h, a, b, i + 6);
+        SHA256_ROUND(b, c, d, e, f, g, h, a, i + 7);
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+void sha256_init(Sha256Context& ctx) {
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(ctx.state, initial, sizeof(initial));
+    ctx.block_len = 0;
+    ctx.total = 0;
+}
+
+/**
+ * Feed Data
+ *
+ * Whole blocks are hashed straight from data; only the bytes of a block
+ * split between calls are copied.
+ */
+void sha256_update(Sha256Context& ctx, const void* data, uint32_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    ctx.total += len;
+    if (ctx.block_len > 0) {
+        uint32_t take = SHA256_BLOCK_SIZE - ctx.block_len;
+        if (take > len) take = len;
+        memcpy(ctx.block + ctx.block_len, p, take);
+        ctx.block_len += take;
+        p += take;
+        len -= take;
+        if (ctx.block_len < SHA256_BLOCK_SIZE) {
+            return;
+        }
+        sha256_block(ctx.state, ctx.block);
+        ctx.block_len = 0;
+    }
+    for (; len >= SHA256_BLOCK_SIZE; p += SHA256_BLOCK_SIZE, len -= SHA256_BLOCK_SIZE) {
+        sha256_block(ctx.state, p);
+    }
+    memcpy(ctx.block, p, len);
+    ctx.block_len = len;
+}
+
+void sha256_final(Sha256Context& ctx, uint8_t digest[SHA256_DIGEST_SIZE]) {
+    uint64_t bits = ctx.total * 8;
+    ctx.block[ctx.block_len++] = 0x80;
+    if (ctx.block_len > SHA256_BLOCK_SIZE - 8) {
+        memset(ctx.block + ctx.block_len, 0, SHA256_BLOCK_SIZE - ctx.block_len);
+        sha256_block(ctx.state, ctx.block);
+        ctx.block_len = 0;
+    }
+    memset(ctx.block + ctx.block_len, 0, SHA256_BLOCK_SIZE - 8 - ctx.block_len);
+    for (uint32_t i = 0; i < 8; ++i) {
+        ctx.block[SHA256_BLOCK_SIZE - 1 - i] = (uint8_t)(bits >> (i * 8));
+    }
+    sha256_block(ctx.state, ctx.block);
+    for (uint32_t i = 0; i < 8; ++i) {
+        digest[i * 4] = (uint8_t)(ctx.state[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(ctx.state[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(ctx.state[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)ctx.state[i];
+    }
+}
+
+// ============================================================================
+// Common Interface
+// ============================================================================
+
+void checksum_init(Checksum& sum, ChecksumKind kind) {
+    sum.kind = kind;
+    sum.value = (kind == CHECKSUM_ADLER32) ? 1 : 0;
+    if (kind == CHECKSUM_SHA256) {
+        sha256_init(sum.sha);
+    }
+}
+
+void checksum_update(Checksum& sum, const void* data, uint32_t len) {
+    switch (sum.kind) {
+        case CHECKSUM_CRC32:   sum.value = crc32_update(sum.value, data, len); break;
+        case CHECKSUM_ADLER32: sum.value = adler32_update(sum.value, data, len); break;
+        case CHECKSUM_SHA256:  sha256_update(sum.sha, data, len); break;
+    }
+}
+
+void checksum_format(Checksum& sum, char* text) {
+    static const char hex[] = "0123456789abcdef";
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    uint32_t len = 4;
+    if (sum.kind == CHECKSUM_SHA256) {
+        sha256_final(sum.sha, digest);
+        len = SHA256_DIGEST_SIZE;
+    } else {
+        for (uint32_t i = 0; i < 4; ++i) {
+            digest[i] = (uint8_t)(sum.value >> (24 - i * 8));
+        }
+    }
+    for (uint32_t i = 0; i < len; ++i) {
+        text[i * 2] = hex[digest[i] >> 4];
+        text[i * 2 + 1] = hex[digest[i] & 0xF];
+    }
+    text[len * 2] = '\0';
+}
@@ -0,0 +1,68 @@
+/*
+ * ============================================================================
+ * RusticOS Checksum Header (checksum.h)
+ * ============================================================================
+ *
+ * CRC-32 (IEEE 802.3, as in zlib/PNG), Adler-32 and SHA-256 for the crc32,
+ * adler32 and sha256sum commands. All three are incremental: data can be
+ * fed in blocks of any size (file contents in place, pipe reads, disk
+ * sectors) and the result equals a single pass over the concatenation.
+ *
+ *   CRC-32    slicing-by-8: eight bytes per step through eight 256-entry
+ *             tables, which are generated by the compiler
+ *   Adler-32  sums deferred for 5552 bytes between modulo reductions,
+ *             inner loop unrolled by 8
+ *   SHA-256   rounds unrolled by 8 with the working variables renamed
+ *             instead of shifted
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include "types.h"
+
+#define SHA256_BLOCK_SIZE   64
+#define SHA256_DIGEST_SIZE  32
+
+/**
+ * SHA-256 state between blocks
+ */
+struct Sha256Context {
+    uint32_t state[8];
+    uint8_t block[SHA256_BLOCK_SIZE];       // Partial block
+    uint32_t block_len;
+    uint64_t total;                         // Bytes fed so far
+};
+
+// CRC-32 and Adler-32 (pass the previous result to continue; start with 0 and 1)
+uint32_t crc32_update(uint32_t crc, const void* data, uint32_t len);
+uint32_t adler32_update(uint32_t adler, const void* data, uint32_t len);
+
+// SHA-256
+void sha256_init(Sha256Context& ctx);
+void sha256_update(Sha256Context& ctx, const void* data, uint32_t len);
+void sha256_final(Sha256Context& ctx, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+/**
+ * Checksum - one of the algorithms above behind a common interface
+ */
+enum ChecksumKind {
+    CHECKSUM_CRC32,
+    CHECKSUM_ADLER32,
+    CHECKSUM_SHA256
+};
+
+struct Checksum {
+    ChecksumKind kind;
+    uint32_t value;                         // CRC-32 / Adler-32
+    Sha256Context sha;
+};
+
+void checksum_init(Checksum& sum, ChecksumKind kind);
+void checksum_update(Checksum& sum, const void* data, uint32_t len);
+void checksum_format(Checksum& sum, char* text);   // Lowercase hex; text >= 65 bytes
+
+#endif // CHECKSUM_H
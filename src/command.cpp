@@ -9,10 +9,36 @@
  * Supported Commands:
  *   - help, clear, echo
  *   - makedir, cd, lsd, pwd
- *   - makefile, cat, write
+ *   - makefile, cat, write, hexdump, edit, more/less
+ *   - wc, sort, uniq, head, tail (see textproc.h)
+ *   - crc32, adler32, sha256sum (see checksum.h)
  *   - remove, move, copy
+ *   - time, syscallbench
+ *   - exec, execbench (programs in /bin also run by name)
+ *   - pipebench, bench
+ *   - jobs, fg, kill
+ *   - run, test (shell scripts, see script.h)
+ * 
  *   - shutdown
  * 
+ * Pipelines: "cmd1 | cmd2 | ..." runs every stage on its own kernel task,
+ * connected by bounded pipes. Commands write to out(), which is the
+ * terminal, a redirected file or the next stage's pipe, and may read in()
+ * (the previous stage).
+ * 
+ * Redirection: "cmd > file" replaces and "cmd >> file" appends to file;
+ * with a pipeline the redirection applies to the last stage.
+ * 
+ * Here-documents: "write file <<END" switches the shell's input to the
+ * file. Every following line is appended as it is entered (lines longer
+ * than the input buffer are appended in pieces) until a line reading END;
+ * Ctrl+C stops early and keeps what was entered.
+ * 
+ * Job control: a line ending in '&' runs as a background job on its own
+ * task (jobs, fg, kill). Ctrl+C cancels the foreground job; commands with
+ * long loops check task_poll() so they stay cancellable and let the shell
+ * run.
+ * 
  * Version: 1.0.1
  * ============================================================================
  */
@@ -21,17 +47,38 @@
 #include "terminal.h"
 #include "filesystem.h"
 #include "interrupt.h"
+#include "process.h"
+#include "paging.h"
+#include "syscall.h"
+#include "elf.h"
+#include "output.h"
+#include "pipe.h"
+#include "task.h"
+#include "script.h"
+#include "bench.h"
+#include "virtual_disk.h"
+#include "format.h"
+#include "hexdump.h"
+#include "editor.h"
+#include "pager.h"
+#include "textproc.h"
+#include "checksum.h"
+#include "boottime.h"
+#include "bootinfo.h"
+#include "params.h"
 
 extern Terminal terminal;
 extern FileSystem filesystem;
 
+static bool program_exists(const char* name);
+static bool parse_uint32(const char* str, uint32_t* value);
+
 CommandSystem::CommandSystem()
-    : input_pos(0), input_complete(false)
+    : input_pos(0), input_complete(false), heredoc_file(nullptr), heredoc_split(false), script_depth(0)
 {
     for (int i = 0; i < MAX_COMMAND_LENGTH; ++i) {
         input_buffer[i] = '\0';
     }
-    clear_command(current_command);
 }
 
 void CommandSystem::process_input(char c)
@@ -56,6 +103,16 @@ void CommandSystem::process_input(char c)
         return;
     }
     
+    // A full buffer in a here-document goes to the file, so lines have no length limit
+    if (heredoc_file && input_pos == MAX_COMMAND_LENGTH - 1) {
+        if (!filesystem.append(heredoc_file, input_buffer, input_pos)) {
+            out().write("\nError: out of memory writing to file\n");
+            end_heredoc();
+        }
+        input_pos = 0;
+        heredoc_split = true;
+    }
+    
     // Handle printable characters (including space)
     if (c >= 32 && c <= 126 && input_pos < MAX_COMMAND_LENGTH - 1) {
         input_buffer[input_pos++] = c;
@@ -65,377 +122,2006 @@ void CommandSystem::process_input(char c)
     }
 }
 
+/**
+ * Pipeline Stage - one command of a pipeline, run on its own task
+ */
+struct PipelineStage {
+    const Command* cmd;
+    Pipe* in;                       // Read end (nullptr for the first stage)
+    Pipe* out;                      // Write end (nullptr for the last stage)
+};
+
+/**
+ * Job - one command line (a single command or a pipeline)
+ * 
+ * jobs[0] is the line running in the foreground on the shell task; slots
+ * 1..MAX_JOBS hold background jobs ("cmd &"), each led by its own task. The
+ * slot index is the job number used by jobs, fg and kill.
+ */
+struct Job {
+    bool active;                                // Background slot in use
+    bool killed;                                // Cancelled with "kill"
+    char text[MAX_COMMAND_LENGTH];              // Command line (for "jobs")
+    char line[MAX_COMMAND_LENGTH];              // Tokenized copy; stages point into it
+    Command stages[MAX_PIPELINE_STAGES];
+    uint32_t stage_count;
+    PipelineStage pipeline[MAX_PIPELINE_STAGES];
+    FileNode* file;                             // Redirection target (nullptr = none)
+    FileSink sink;                              // Appends to file
+    Task* leader;                               // Task running a background job
+};
+
+static Job jobs[MAX_JOBS + 1];
+static Job script_job;              // Line being run by a script (one script at a time)
+
+/**
+ * Task entry for a background job
+ */
+static void job_task_entry(void* arg) {
+    command_system.run_job(*(Job*)arg);
+}
+
 void CommandSystem::execute_command()
 {
-    parse_command(input_buffer, current_command);
-    
-    if (current_command.name[0] == '\0') {
-        return;
-    }
-    
-    // Command dispatch
-    if (strcmp(current_command.name, "help") == 0) {
-        cmd_help();
-    } else if (strcmp(current_command.name, "clear") == 0) {
-        cmd_clear();
-    } else if (strcmp(current_command.name, "echo") == 0) {
-        cmd_echo();
-    } else if (strcmp(current_command.name, "makedir") == 0) {
-        if (current_command.arg_count >= 1) {
-            cmd_mkdir(current_command.args[0]);
-        }
-    } else if (strcmp(current_command.name, "cd") == 0) {
-        if (current_command.arg_count >= 1) {
-            cmd_cd(current_command.args[0]);
-        }
-    } else if (strcmp(current_command.name, "lsd") == 0) {
-        cmd_ls();
-    } else if (strcmp(current_command.name, "pwd") == 0) {
-        cmd_pwd();
-    } else if (strcmp(current_command.name, "makefile") == 0) {
-        if (current_command.arg_count >= 1) {
-            cmd_touch(current_command.args[0]);
-        }
-    } else if (strcmp(current_command.name, "cat") == 0) {
-        if (current_command.arg_count >= 1) {
-            cmd_cat(current_command.args[0]);
-        }
-    } else if (strcmp(current_command.name, "write") == 0) {
-        if (current_command.arg_count >= 2) {
-            char content[256] = {0};
-            uint32_t pos = 0;
-            for (uint32_t ai = 1; ai < current_command.arg_count && pos < 255; ++ai) {
-                const char* part = current_command.args[ai];
-                for (uint32_t pi = 0; part[pi] && pos < 255; ++pi) {
-                    content[pos++] = part[pi];
-                }
-                if (ai + 1 < current_command.arg_count && pos < 255) {
-                    content[pos++] = ' ';
+    if (heredoc_file) {
+        heredoc_input();
+        return;
+    }
+    if (heredoc_split) {
+        return;  // Rest of a here-document line whose append failed: not a command
+    }
+    
+    // A trailing '&' runs the line as a background job, unless an odd run
+    // of backslashes escapes it ("a\\&" is an escaped backslash, then '&')
+    uint32_t len = strlen(input_buffer);
+    while (len > 0 && input_buffer[len - 1] == ' ') input_buffer[--len] = '\0';
+    bool background = false;
+    if (len > 0 && input_buffer[len - 1] == '&') {
+        uint32_t backslashes = 0;
+        while (backslashes + 1 < len && input_buffer[len - 2 - backslashes] == '\\') backslashes++;
+        background = (backslashes % 2 == 0);
+    }
+    if (background) {
+        input_buffer[--len] = '\0';
+    }
+    
+    uint32_t slot = 0;
+    if (background) {
+        for (slot = 1; slot <= MAX_JOBS && jobs[slot].active; ++slot) {}
+        if (slot > MAX_JOBS || task_free_slots() == 0) {
+            out().write("Error: too many background jobs\n");
+            return;
+        }
+    }
+    Job& job = jobs[slot];
+    if (!parse_line(input_buffer, job)) {
+        return;
+    }
+    
+    if (!background) {
+        run_job(job);
+        return;
+    }
+    
+    job.active = true;
+    job.killed = false;
+    job.leader = task_create(job.stages[0].name, job_task_entry, &job);
+    job.leader->job = slot;
+    job.leader->in = nullptr;
+    print_job(slot, "Running");
+}
+
+// ============================================================================
+// Tokenizer
+// ============================================================================
+
+/**
+ * Tokenize a Command Line in Place
+ * 
+ * Splits line into words and the operators '|', '>' and '>>'. Inside a
+ * word, "double quotes" group text including spaces and operators, and a
+ * backslash takes the next character literally. Quotes and backslashes are
+ * removed by compacting each word within the buffer and NUL-terminating it,
+ * so every token points into line: nothing is copied and there is no
+ * per-argument length limit. A word that contained either is marked quoted,
+ * so later stages can keep it literal ("*" or "$x" in a script).
+ * 
+ * @param line Command line; overwritten with the unquoted, terminated words
+ * @param tokens Receives the tokens
+ * @param max_tokens Capacity of tokens
+ * @param count Receives the number of tokens
+ * @return nullptr on success, or an error message
+ */
+const char* tokenize(char* line, Token* tokens, uint32_t max_tokens, uint32_t* count) {
+    uint32_t n = 0;
+    char* r = line;
+    while (true) {
+        while (*r == ' ') r++;
+        if (*r == '\0') break;
+        if (n == max_tokens) {
+            return "too many words";
+        }
+        
+        char c = *r;                    // Operator character, if any
+        if (c != '|' && c != '>') {
+            // Word: copy down over removed quotes/backslashes (w never passes r)
+            Token& word = tokens[n++];
+            word.type = TOKEN_WORD;
+            word.text = r;
+            word.quoted = false;
+            char* w = r;
+            bool quoted = false;
+            while (*r) {
+                if (*r == '"') {
+                    quoted = !quoted;
+                    word.quoted = true;
+                    r++;
+                } else if (*r == '\\' && r[1]) {
+                    *w++ = r[1];
+                    word.quoted = true;
+                    r += 2;
+                } else if (!quoted && (*r == ' ' || *r == '|' || *r == '>')) {
+                    break;
+                } else {
+                    *w++ = *r++;
                 }
             }
-            content[pos] = '\0';
-            cmd_write(current_command.args[0], content);
+            if (quoted) {
+                return "unterminated quote";
+            }
+            // The terminator may land on the delimiter, so read it first
+            char delimiter = *r;
+            *w = '\0';
+            if (delimiter != '|' && delimiter != '>') {
+                if (delimiter) r++;
+                continue;
+            }
+            if (n == max_tokens) {
+                return "too many words";
+            }
+            c = delimiter;
         }
-    } else if (strcmp(current_command.name, "remove") == 0) {
-        if (current_command.arg_count >= 1) {
-            cmd_remove(current_command.args[0]);
+        
+        // Operator: '|', '>' or '>>'
+        Token& op = tokens[n++];
+        op.text = nullptr;
+        op.quoted = false;
+        if (c == '|') {
+            op.type = TOKEN_PIPE;
+            r++;
+        } else if (r[1] == '>') {
+            op.type = TOKEN_APPEND;
+            r += 2;
         } else {
-            terminal.write("Usage: remove <filename>\n");
+            op.type = TOKEN_REDIRECT;
+            r++;
         }
-    } else if (strcmp(current_command.name, "move") == 0) {
-        if (current_command.arg_count >= 2) {
-            cmd_move(current_command.args[0], current_command.args[1]);
-        } else {
-            terminal.write("Usage: move <source> <destination>\n");
+    }
+    *count = n;
+    return nullptr;
+}
+
+/**
+ * Parse a Command Line into a Job
+ * 
+ * Tokenizes a private copy of the line in place (the job's commands point
+ * into job.line) and builds the job from the tokens.
+ * 
+ * @param line Command line (not modified)
+ * @param job Job to fill
+ * @return true if the job is ready to run, false for an empty line or an
+ *         error (already printed)
+ */
+bool CommandSystem::parse_line(const char* line, Job& job)
+{
+    strncpy(job.text, line, MAX_COMMAND_LENGTH - 1);
+    job.text[MAX_COMMAND_LENGTH - 1] = '\0';
+    strncpy(job.line, line, MAX_COMMAND_LENGTH - 1);
+    job.line[MAX_COMMAND_LENGTH - 1] = '\0';
+    
+    Token tokens[MAX_TOKENS];
+    uint32_t count = 0;
+    const char* error = tokenize(job.line, tokens, MAX_TOKENS, &count);
+    if (error) {
+        out().write("Error: ");
+        out().write(error);
+        out().write("\n");
+        set_status(2);
+        return false;
+    }
+    if (count == 0) {
+        return false;  // Empty line
+    }
+    if (!build_job(tokens, count, job)) {
+        set_status(2);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Build a Job from Tokens
+ * 
+ * Splits the tokens into pipeline stages at '|' and opens (creating or
+ * truncating) the "> file" / ">> file" target, which must end the line.
+ * The job's sink holds the target open from here until run_job() ends, so
+ * it cannot be removed before a background job starts writing. The job's
+ * commands point at the token texts, which must stay valid while the job
+ * runs.
+ * 
+ * @return true if the job is ready to run, false on error (already printed)
+ */
+bool CommandSystem::build_job(const Token* tokens, uint32_t count, Job& job)
+{
+    job.file = nullptr;
+    job.stage_count = 0;
+    Command* cmd = nullptr;             // Stage being filled
+    const char* target = nullptr;
+    bool append = false;
+    for (uint32_t i = 0; i < count; ++i) {
+        const Token& token = tokens[i];
+        if (target) {
+            out().write("Error: expected one file name after '>'\n");
+            return false;
         }
-    } else if (strcmp(current_command.name, "copy") == 0) {
-        if (current_command.arg_count >= 2) {
-            cmd_copy(current_command.args[0], current_command.args[1]);
+        if (token.type == TOKEN_WORD) {
+            if (!cmd) {
+                if (job.stage_count == MAX_PIPELINE_STAGES) {
+                    out().write("Error: too many pipeline stages\n");
+                    return false;
+                }
+                cmd = &job.stages[job.stage_count++];
+                cmd->name = token.text;
+                cmd->arg_count = 0;
+                cmd->quoted_args = 0;
+            } else if (cmd->arg_count == MAX_ARGS) {
+                out().write("Error: too many arguments\n");
+                return false;
+            } else {
+                if (token.quoted) cmd->quoted_args |= 1u << cmd->arg_count;
+                cmd->args[cmd->arg_count++] = token.text;
+            }
+        } else if (token.type == TOKEN_PIPE) {
+            if (!cmd) {
+                out().write("Error: empty command in pipeline\n");
+                return false;
+            }
+            cmd = nullptr;
         } else {
-            terminal.write("Usage: copy <source> <destination>\n");
+            if (!cmd || i + 1 == count || tokens[i + 1].type != TOKEN_WORD) {
+                out().write("Error: expected one file name after '>'\n");
+                return false;
+            }
+            append = (token.type == TOKEN_APPEND);
+            target = tokens[++i].text;
+        }
+    }
+    if (!cmd) {
+        out().write("Error: empty command in pipeline\n");
+        return false;
+    }
+    
+    if (target) {
+        job.file = open_redirect(target, append);
+        if (!job.file) {
+            return false;
         }
-    } else if (strcmp(current_command.name, "time") == 0) {
-        cmd_time();
-    } else if (strcmp(current_command.name, "shutdown") == 0) {
-        cmd_shutdown();
+        job.sink.open(job.file);
+    }
+    return true;
+}
+
+/**
+ * Run a Parsed Job on the Current Task
+ * 
+ * Used directly by the shell for foreground lines and by job_task_entry()
+ * for background jobs.
+ */
+void CommandSystem::run_job(Job& job)
+{
+    Task* self = task_current();
+    OutputSink* previous_out = self->out;
+    if (job.file) {
+        self->out = &job.sink;
+    }
+    
+    if (job.stage_count == 1) {
+        dispatch(job.stages[0]);
     } else {
-        terminal.write("Unknown command: ");
-        terminal.write(current_command.name);
-        terminal.write("\n");
+        run_pipeline(job);
+    }
+    self->out->flush();
+    
+    if (job.file) {
+        job.sink.close();
+        self->out = previous_out;
+        if (!job.sink.ok()) {
+            out().write("Error: out of memory writing to file\n");
+            set_status(1);
+        }
     }
 }
 
-void CommandSystem::reset_input()
+/**
+ * Open the Target of an Output Redirection
+ * 
+ * Creates the file in the current directory if it does not exist yet.
+ * 
+ * @param target File name or path
+ * @param append true for ">>" (keep content), false for ">" (truncate)
+ * @return File node, or nullptr (error already printed)
+ */
+FileNode* CommandSystem::open_redirect(const char* target, bool append)
 {
-    input_pos = 0;
-    input_complete = false;
-    for (int i = 0; i < MAX_COMMAND_LENGTH; ++i) {
-        input_buffer[i] = '\0';
+    FileNode* file = filesystem.lookup(target);
+    if (!file) {
+        bool has_slash = false;
+        for (const char* p = target; *p; ++p) {
+            if (*p == '/') has_slash = true;
+        }
+        if (!has_slash && filesystem.create_file(target, "")) {
+            file = filesystem.lookup(target);
+        }
+        if (!file) {
+            out().write("Error: cannot create ");
+            out().write(target);
+            out().write("\n");
+            return nullptr;
+        }
+    }
+    if (file->type != FILE_TYPE_FILE) {
+        out().write("Error: ");
+        out().write(target);
+        out().write(" is a directory\n");
+        return nullptr;
     }
-    clear_command(current_command);
+    if (!append) {
+        filesystem.truncate(file);
+    }
+    return file;
+}
+
+/**
+ * Task entry for a pipeline stage
+ * Closing the pipe ends lets the neighbours see end-of-stream (downstream)
+ * or stop producing (upstream) once this stage is done.
+ */
+static void pipeline_stage_entry(void* arg) {
+    PipelineStage* stage = (PipelineStage*)arg;
+    command_system.dispatch(*stage->cmd);
+    task_current()->out->flush();
+    if (stage->in) stage->in->close_read();
+    if (stage->out) stage->out->close_write();
 }
 
-void CommandSystem::parse_command(const char* input, Command& cmd)
+void CommandSystem::run_pipeline(Job& job)
 {
-    clear_command(cmd);
-    
-    uint32_t i = 0;
-    uint32_t arg_index = 0;
-    
-    // Parse command name
-    uint32_t np = 0;
-    while (input[i] && input[i] != ' ' && np < 63) {
-        cmd.name[np++] = input[i++];
+    uint32_t stage_count = job.stage_count;
+    Pipe* pipes[MAX_PIPELINE_STAGES - 1];
+    uint32_t pipe_count = 0;
+    for (; pipe_count < stage_count - 1; ++pipe_count) {
+        pipes[pipe_count] = pipe_create();
+        if (!pipes[pipe_count]) break;
+    }
+    if (pipe_count < stage_count - 1 || task_free_slots() < stage_count) {
+        out().write("Error: not enough pipes or tasks for pipeline\n");
+        set_status(1);
+        for (uint32_t i = 0; i < pipe_count; ++i) {
+            pipes[i]->close_write();
+            pipes[i]->close_read();
+        }
+        return;
     }
-    cmd.name[np] = '\0';
-    
-    // Skip spaces
-    while (input[i] == ' ') i++;
     
-    // Parse arguments
-    while (input[i] && arg_index < MAX_ARGS) {
-        uint32_t ap = 0;
-        while (input[i] && input[i] != ' ' && ap < 63) {
-            cmd.args[arg_index][ap++] = input[i++];
+    // Stage i reads pipe i-1 and writes pipe i; the last stage writes to our output
+    Task* tasks[MAX_PIPELINE_STAGES];
+    for (uint32_t i = 0; i < stage_count; ++i) {
+        PipelineStage& stage = job.pipeline[i];
+        stage.cmd = &job.stages[i];
+        stage.in = (i > 0) ? pipes[i - 1] : nullptr;
+        stage.out = (i + 1 < stage_count) ? pipes[i] : nullptr;
+        tasks[i] = task_create(job.stages[i].name, pipeline_stage_entry, &stage);
+        tasks[i]->in = stage.in;
+        if (stage.out) tasks[i]->out = stage.out;
+    }
+    // The pipeline's status is the last stage's
+    int32_t status = 0;
+    for (uint32_t i = 0; i < stage_count; ++i) {
+        status = task_wait(tasks[i]);
+    }
+    set_status(status);
+}
+
+/**
+ * Print a Job Status Line ("[1] Running  pipebench 8192")
+ */
+void CommandSystem::print_job(uint32_t slot, const char* status)
+{
+    kprintf(out(), "[%u] %s  %s\n", slot, status, jobs[slot].text);
+}
+
+/**
+ * Reap Finished Background Jobs
+ * 
+ * Called before each prompt, so a job's completion is reported once.
+ */
+void CommandSystem::report_jobs()
+{
+    for (uint32_t slot = 1; slot <= MAX_JOBS; ++slot) {
+        Job& job = jobs[slot];
+        if (!job.active || job.leader->state != TASK_DONE) {
+            continue;
         }
-        cmd.args[arg_index][ap] = '\0';
-        
-        if (ap > 0) {
-            arg_index++;
+        task_wait(job.leader);
+        job.active = false;
+        print_job(slot, job.killed ? "Terminated" : "Done");
+    }
+}
+
+/**
+ * Resolve a Job Argument ("2" or "%2"; default: most recent job)
+ * 
+ * @return Job slot, or 0 if there is no such job (error already printed)
+ */
+uint32_t CommandSystem::find_job(const char* arg)
+{
+    uint32_t slot = 0;
+    if (arg) {
+        if (*arg == '%') arg++;
+        if (!parse_uint32(arg, &slot) || slot == 0 || slot > MAX_JOBS) {
+            slot = 0;
+        }
+    } else {
+        for (uint32_t i = 1; i <= MAX_JOBS; ++i) {
+            if (jobs[i].active) slot = i;
         }
-        
-        while (input[i] == ' ') i++;
     }
-    
-    cmd.arg_count = arg_index;
+    if (slot == 0 || !jobs[slot].active) {
+        out().write("Error: no such job\n");
+        set_status(1);
+        return 0;
+    }
+    return slot;
+}
+
+OutputSink& CommandSystem::out()
+{
+    return *task_current()->out;
 }
 
-void CommandSystem::clear_command(Command& cmd)
+Pipe* CommandSystem::in()
 {
-    cmd.name[0] = '\0';
-    cmd.arg_count = 0;
-    for (int i = 0; i < MAX_ARGS; ++i) {
-        cmd.args[i][0] = '\0';
+    return task_current()->in;
+}
+
+void CommandSystem::set_status(int32_t status)
+{
+    task_current()->status = status;
+}
+
+int32_t CommandSystem::status()
+{
+    return task_current()->status;
+}
+
+// ============================================================================
+// Command Table
+// ============================================================================
+
+/**
+ * Built-in commands. Dispatch, argument-count checks and `help` are all
+ * driven by this table: adding a command is one entry plus its handler.
+ */
+static constexpr CommandSpec command_table[] = {
+    { "help",         0, 0,        &CommandSystem::cmd_help,         "",                      "Show this help" },
+    { "clear",        0, 0,        &CommandSystem::cmd_clear,        "",                      "Clear the screen" },
+    { "echo",         0, MAX_ARGS, &CommandSystem::cmd_echo,         "[text...]",             "Print the arguments" },
+    { "makedir",      1, 1,        &CommandSystem::cmd_mkdir,        "<name>",                "Create directory" },
+    { "cd",           1, 1,        &CommandSystem::cmd_cd,           "<path>",                "Change directory" },
+    { "lsd",          0, 0,        &CommandSystem::cmd_ls,           "",                      "List directory" },
+    { "pwd",          0, 0,        &CommandSystem::cmd_pwd,          "",                      "Print working directory" },
+    { "makefile",     1, 1,        &CommandSystem::cmd_touch,        "<name>",                "Create file" },
+    { "cat",          0, 1,        &CommandSystem::cmd_cat,          "[file]",                "Display file (or standard input)" },
+    { "wc",           0, 2,        &CommandSystem::cmd_wc,           "[-l|-w|-c] [file]",     "Count lines, words and bytes" },
+    { "sort",         0, 2,        &CommandSystem::cmd_sort,         "[-r] [file]",           "Sort lines (up to 64 KB, 8K lines)" },
+    { "uniq",         0, 2,        &CommandSystem::cmd_uniq,         "[-c] [file]",           "Drop repeated adjacent lines" },
+    { "head",         0, 3,        &CommandSystem::cmd_head,         "[-n lines] [file]",     "First lines (default 10)" },
+    { "tail",         0, 3,        &CommandSystem::cmd_tail,         "[-n lines] [file]",     "Last lines (default 10)" },
+    { "crc32",        0, 4,        &CommandSystem::cmd_checksum,     "[-t] [file | -s <lba> <count>]", "CRC-32 (-t: report MB/s)" },
+    { "adler32",      0, 4,        &CommandSystem::cmd_checksum,     "[-t] [file | -s <lba> <count>]", "Adler-32 (-t: report MB/s)" },
+    { "sha256sum",    0, 4,        &CommandSystem::cmd_checksum,     "[-t] [file | -s <lba> <count>]", "SHA-256 (-t: report MB/s)" },
+    { "hexdump",      0, 3,        &CommandSystem::cmd_hexdump,      "[file] | -s <lba> <count>", "Hex/ASCII dump of a file, standard input or disk sectors" },
+    { "write",        2, MAX_ARGS, &CommandSystem::cmd_write,        "<file> <text...> | <file> <<END", "Write to file (<<END: the lines that follow)" },
+    { "more",         0, 1,        &CommandSystem::cmd_more,         "[file]",                "Page through a file or standard input" },
+    { "less",         0, 1,        &CommandSystem::cmd_more,         "[file]",                "Same as more" },
+    { "edit",         1, 1,        &CommandSystem::cmd_edit,         "<file>",                "Full-screen text editor (^S save, ^Q quit)" },
+    { "remove",       1, 1,        &CommandSystem::cmd_remove,       "<name>",                "Remove file or empty directory" },
+    { "move",         2, 2,        &CommandSystem::cmd_move,         "<source> <destination>", "Move/rename" },
+    { "copy",         2, 2,        &CommandSystem::cmd_copy,         "<source> <destination>", "Copy file" },
+    { "time",         0, MAX_ARGS, &CommandSystem::cmd_time,         "[command...]",          "Show uptime and clock, or what a command costs" },
+    { "bootinfo",     0, 0,        &CommandSystem::cmd_bootinfo,     "",                      "Show what the loader reported (memory map, video, command line)" },
+    { "boottime",     0, 0,        &CommandSystem::cmd_boottime,     "",                      "Show how long each boot stage took" },
+    { "params",       0, 0,        &CommandSystem::cmd_params,       "",                      "Show kernel parameters and the command line they came from" },
+    { "syscallbench", 0, 1,        &CommandSystem::cmd_syscallbench, "[iterations]",          "Null system call round trip" },
+    { "exec",         1, MAX_ARGS, &CommandSystem::cmd_exec,         "<file> [args...]",      "Run an ELF program" },
+    { "execbench",    1, 2,        &CommandSystem::cmd_execbench,    "<file> [iterations]",   "Program load/run latency" },
+    { "pipebench",    0, 1,        &CommandSystem::cmd_pipebench,    "[kilobytes]",           "Pipe throughput between tasks" },
+    { "bench",        0, 2,        &CommandSystem::cmd_bench,        "[name] [samples]",      "Kernel microbenchmarks (JSON on serial)" },
+    { "jobs",         0, 0,        &CommandSystem::cmd_jobs,         "",                      "List background jobs" },
+    { "fg",           0, 1,        &CommandSystem::cmd_fg,           "[job]",                 "Wait for a background job" },
+    { "kill",         1, 1,        &CommandSystem::cmd_kill,         "<job>",                 "Cancel a background job" },
+    { "run",          1, MAX_ARGS, &CommandSystem::cmd_run,          "<file> [args...]",      "Run a shell script" },
+    { "test",         1, 3,        &CommandSystem::cmd_test,         "<a> =|!= <b> | -f|-d|-n|-z <arg>", "Check a condition (status 0 if true)" },
+    { "shutdown",     0, 0,        &CommandSystem::cmd_shutdown,     "",                      "Shutdown the system" },
+};
+
+static constexpr uint32_t COMMAND_COUNT = sizeof(command_table) / sizeof(command_table[0]);
+
+// Slots in the perfect hash (power of two; ~8x the command count keeps the
+// compile-time seed search short)
+#define COMMAND_HASH_SLOTS  256
+
+/**
+ * Seeded FNV-1a hash of a command name, reduced to a slot index
+ */
+static constexpr uint32_t command_hash(const char* name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (; *name; ++name) {
+        hash = (hash ^ (uint8_t)*name) * 16777619u;
     }
+    hash ^= hash >> 16;
+    return hash & (COMMAND_HASH_SLOTS - 1);
 }
 
 /**
- * Helper function to convert uint64_t to string
- * @param value The number to convert
- * @param buffer Buffer to store the string (must be at least 32 bytes)
+ * Perfect hash over command_table: every name lands in its own slot
  */
-static void uint64_to_string(uint64_t value, char* buffer) {
-    if (value == 0) {
-        buffer[0] = '0';
-        buffer[1] = '\0';
-        return;
+struct CommandHashTable {
+    uint32_t seed;
+    uint8_t slots[COMMAND_HASH_SLOTS];      // command_table index + 1 (0 = empty)
+};
+
+/**
+ * Find a seed for which no two commands collide (evaluated by the compiler)
+ */
+static constexpr CommandHashTable build_command_hash() {
+    CommandHashTable table = {};
+    for (uint32_t seed = 0; seed < 4096; ++seed) {
+        for (uint32_t i = 0; i < COMMAND_HASH_SLOTS; ++i) {
+            table.slots[i] = 0;
+        }
+        bool collision = false;
+        for (uint32_t i = 0; i < COMMAND_COUNT && !collision; ++i) {
+            uint32_t slot = command_hash(command_table[i].name, seed);
+            collision = table.slots[slot] != 0;
+            table.slots[slot] = (uint8_t)(i + 1);
+        }
+        if (!collision) {
+            table.seed = seed;
+            return table;
+        }
     }
-    
-    char rev_buf[32];
-    int rev_pos = 0;
-    uint64_t temp = value;
-    
-    while (temp > 0) {
-        rev_buf[rev_pos++] = '0' + (temp % 10);
-        temp /= 10;
+    table.seed = 0xFFFFFFFF;
+    return table;
+}
+
+static constexpr CommandHashTable command_hash_table = build_command_hash();
+static_assert(command_hash_table.seed != 0xFFFFFFFF, "no perfect hash seed for command_table");
+static_assert(COMMAND_COUNT < 255, "command_table index must fit in a slot byte");
+
+/**
+ * Look up a Built-in Command
+ * 
+ * One hash and one string compare, whatever the table size.
+ * 
+ * @return Table entry, or nullptr if name is not a built-in
+ */
+static const CommandSpec* find_command(const char* name) {
+    uint8_t index = command_hash_table.slots[command_hash(name, command_hash_table.seed)];
+    if (index == 0) {
+        return nullptr;
     }
-    
-    int pos = 0;
-    for (int i = rev_pos - 1; i >= 0; i--) {
-        buffer[pos++] = rev_buf[i];
+    const CommandSpec* spec = &command_table[index - 1];
+    return (strcmp(spec->name, name) == 0) ? spec : nullptr;
+}
+
+void CommandSystem::dispatch(const Command& cmd)
+{
+    const CommandSpec* spec = find_command(cmd.name);
+    if (spec) {
+        if (cmd.arg_count < spec->min_args || cmd.arg_count > spec->max_args) {
+            out().write("Usage: ");
+            out().write(spec->name);
+            out().write(" ");
+            out().write(spec->usage);
+            out().write("\n");
+            set_status(2);
+            return;
+        }
+        set_status(0);
+        (this->*spec->handler)(cmd);
+    } else if (program_exists(cmd.name)) {
+        // Not a built-in: run /bin/<name> with the command's arguments
+        char path[MAX_PATH_LENGTH];
+        strncpy(path, "/bin/", sizeof(path));
+        strncpy(path + 5, cmd.name, sizeof(path) - 6);
+        path[sizeof(path) - 1] = '\0';
+        const char* argv[MAX_ARGS + 1];
+        argv[0] = cmd.name;
+        for (uint32_t i = 0; i < cmd.arg_count; ++i) {
+            argv[i + 1] = cmd.args[i];
+        }
+        run_program(path, cmd.arg_count + 1, argv);
+    } else {
+        out().write("Unknown command: ");
+        out().write(cmd.name);
+        out().write("\n");
+        set_status(127);
+    }
+}
+
+void CommandSystem::reset_input()
+{
+    input_pos = 0;
+    input_complete = false;
+    for (int i = 0; i < MAX_COMMAND_LENGTH; ++i) {
+        input_buffer[i] = '\0';
     }
-    buffer[pos] = '\0';
+    heredoc_split = false;
+    if (task_cancelled()) {
+        end_heredoc();              // Ctrl+C ends a here-document; entered lines are kept
+        out().write("^C\n");
+        task_clear_cancel();  // A Ctrl+C only applies to the line it interrupted
+    }
+    report_jobs();
+    out().flush();        // Buffered output must reach the screen before the next prompt
+}
+
+/**
+ * Helper function to parse an unsigned decimal string
+ * @param str String to parse
+ * @param value Receives the parsed value
+ * @return true if str is a non-empty decimal number that fits in 32 bits
+ */
+static bool parse_uint32(const char* str, uint32_t* value) {
+    if (!str || !*str) return false;
+    uint64_t result = 0;
+    for (; *str; ++str) {
+        if (*str < '0' || *str > '9') return false;
+        result = result * 10 + (uint32_t)(*str - '0');
+        if (result > 0xFFFFFFFFull) return false;
+    }
+    *value = (uint32_t)result;
+    return true;
+}
+
+/**
+ * Helper function to check for a program in /bin
+ * @param name Command name
+ * @return true if /bin/<name> is a regular file
+ */
+static bool program_exists(const char* name) {
+    char path[MAX_PATH_LENGTH];
+    if (strlen(name) >= MAX_NAME_LENGTH) return false;
+    strncpy(path, "/bin/", sizeof(path));
+    strncpy(path + 5, name, sizeof(path) - 6);
+    path[sizeof(path) - 1] = '\0';
+    FileNode* node = filesystem.lookup(path);
+    return node && node->type == FILE_TYPE_FILE;
+}
+
+/**
+ * Helper function to create a process from an ELF file
+ * @param out Sink for error messages
+ * @param file File node holding the executable
+ * @param argc Number of arguments
+ * @param argv Argument strings (argv[0] is the program name)
+ * @param info Receives load statistics
+ * @return Process ready to run, or nullptr (error already reported)
+ */
+static Process* spawn_program(OutputSink& out, FileNode* file, uint32_t argc, const char* const* argv, ElfLoadInfo* info) {
+    const uint8_t* image = (const uint8_t*)file->data;
+    if (!elf_check(image, file->size)) {
+        out.write("Error: not an executable: ");
+        out.write(file->name);
+        out.write("\n");
+        return nullptr;
+    }
+    Process* proc = process_create(file->name);
+    if (!proc) {
+        out.write("Error: could not create process\n");
+        return nullptr;
+    }
+    // Only ramdisk data is never freed; other files are copied (rm could free them)
+    if (!elf_load(proc, image, file->size, file->external, info) || !process_push_args(proc, argc, argv)) {
+        out.write("Error: could not load ");
+        out.write(file->name);
+        out.write(" (out of memory)\n");
+        process_destroy(proc);
+        return nullptr;
+    }
+    return proc;
 }
 
 // Stub implementations
-void CommandSystem::cmd_help() {
-    terminal.write("Available commands:\n");
-    terminal.write("  help, clear, echo\n");
-    terminal.write("  makedir - Create directory\n");
-    terminal.write("  cd - Change directory\n");
-    terminal.write("  lsd - List directory\n");
-    terminal.write("  pwd - Print working directory\n");
-    terminal.write("  makefile - Create file\n");
-    terminal.write("  cat - Display file contents\n");
-    terminal.write("  write - Write to file\n");
-    terminal.write("  remove - Remove file or empty directory\n");
-    terminal.write("  move - Move/rename file or directory\n");
-    terminal.write("  copy - Copy file\n");
-    terminal.write("  time - Display system clock (uptime) and real-time clock\n");
-    terminal.write("  shutdown - Shutdown the system\n");
-}
-
-void CommandSystem::cmd_clear() {
+void CommandSystem::cmd_help(const Command&) {
+    out().write("Available commands:\n");
+    for (uint32_t i = 0; i < COMMAND_COUNT; ++i) {
+        const CommandSpec& spec = command_table[i];
+        out().write("  ");
+        out().write(spec.name);
+        if (spec.usage[0]) {
+            out().write(" ");
+            out().write(spec.usage);
+        }
+        out().write(" - ");
+        out().write(spec.help);
+        out().write("\n");
+    }
+    out().write("Programs in /bin also run by name.\n");
+    out().write("  cmd1 | cmd2 - Pipe the output of cmd1 into cmd2 (e.g. lsd | cat)\n");
+    out().write("  cmd > file, cmd >> file - Write or append output to a file\n");
+    out().write("  cmd & - Run in the background; Ctrl+C cancels the foreground job\n");
+}
+
+void CommandSystem::cmd_clear(const Command&) {
     terminal.clear();
 }
 
-void CommandSystem::cmd_echo() {
-    if (current_command.arg_count > 0) {
-        for (uint32_t i = 0; i < current_command.arg_count; ++i) {
-            terminal.write(current_command.args[i]);
-            if (i + 1 < current_command.arg_count) terminal.write(" ");
+void CommandSystem::cmd_echo(const Command& cmd) {
+    if (cmd.arg_count > 0) {
+        for (uint32_t i = 0; i < cmd.arg_count; ++i) {
+            out().write(cmd.args[i]);
+            if (i + 1 < cmd.arg_count) out().write(" ");
         }
     }
-    terminal.write("\n");
+    out().write("\n");
 }
 
-void CommandSystem::cmd_mkdir(const char* name) {
+void CommandSystem::cmd_mkdir(const Command& cmd) {
+    const char* name = cmd.args[0];
     if (filesystem.mkdir(name)) {
-        terminal.write("Directory created: ");
-        terminal.write(name);
-        terminal.write("\n");
+        out().write("Directory created: ");
+        out().write(name);
+        out().write("\n");
     } else {
-        terminal.write("Error: could not create directory ");
-        terminal.write(name);
-        terminal.write("\n");
+        out().write("Error: could not create directory ");
+        out().write(name);
+        out().write("\n");
+        set_status(1);
     }
 }
 
-void CommandSystem::cmd_cd(const char* path) {
-    filesystem.cd(path);
+void CommandSystem::cmd_cd(const Command& cmd) {
+    const char* path = cmd.args[0];
+    if (!filesystem.cd(path)) {
+        out().write("Error: no such directory: ");
+        out().write(path);
+        out().write("\n");
+        set_status(1);
+    }
 }
 
-void CommandSystem::cmd_ls() {
-    filesystem.ls();
+void CommandSystem::cmd_ls(const Command&) {
+    filesystem.ls(out());
 }
 
-void CommandSystem::cmd_pwd() {
-    filesystem.pwd();
+void CommandSystem::cmd_pwd(const Command&) {
+    filesystem.pwd(out());
 }
 
-void CommandSystem::cmd_touch(const char* name) {
+void CommandSystem::cmd_touch(const Command& cmd) {
+    const char* name = cmd.args[0];
     if (filesystem.create_file(name, "")) {
-        terminal.write("File created: ");
-        terminal.write(name);
-        terminal.write("\n");
+        out().write("File created: ");
+        out().write(name);
+        out().write("\n");
     } else {
-        terminal.write("Error: could not create file ");
-        terminal.write(name);
-        terminal.write("\n");
+        out().write("Error: could not create file ");
+        out().write(name);
+        out().write("\n");
+        set_status(1);
     }
 }
 
-void CommandSystem::cmd_cat(const char* name) {
-    char buffer[512] = {0};
-    if (filesystem.read_file(name, buffer, 511)) {
-        terminal.write(buffer);
-        terminal.write("\n");
+void CommandSystem::cmd_cat(const Command& cmd) {
+    const char* name = cmd.arg_count >= 1 ? cmd.args[0] : nullptr;
+    if (!name) {
+        // No file: copy standard input (e.g. "lsd | cat")
+        Pipe* input = in();
+        if (!input) {
+            out().write("Usage: cat <filename>\n");
+            set_status(2);
+            return;
+        }
+        char block[PIPE_BUFFER_SIZE];
+        uint32_t n;
+        while ((n = input->read(block, sizeof(block))) > 0) {
+            out().write(block, n);
+        }
+        return;
+    }
+    FileNode* file = filesystem.lookup(name);
+    if (!file || file->type != FILE_TYPE_FILE) {
+        out().write("Error: file not found: ");
+        out().write(name);
+        out().write("\n");
+        set_status(1);
+        return;
     }
+    // One block write; redirected output already ends in a newline
+    if (file->data && file->size > 0) {
+        out().write(file->data, file->size);
+        if (file->data[file->size - 1] == '\n') {
+            return;
+        }
+    }
+    out().write("\n");
 }
 
-void CommandSystem::cmd_write(const char* name, const char* content) {
-    filesystem.write_file(name, content);
-}
+// ============================================================================
+// Text Processing Commands
+// ============================================================================
 
-void CommandSystem::cmd_remove(const char* name) {
-    if (filesystem.remove(name)) {
-        terminal.write("Removed: ");
-        terminal.write(name);
-        terminal.write("\n");
-    } else {
-        terminal.write("Error: could not remove ");
-        terminal.write(name);
-        terminal.write("\n");
+/**
+ * Input of a Text Command
+ * 
+ * Files are used in place (zero-copy); without a file argument the command
+ * reads standard input.
+ * 
+ * @param arg Index of the optional file argument
+ * @param file Receives the file (nullptr when reading standard input)
+ * @param input Receives standard input (nullptr when reading a file)
+ * @return false if there is no input (error printed, status set)
+ */
+bool CommandSystem::open_text(const Command& cmd, uint32_t arg, FileNode** file, Pipe** input)
+{
+    *file = nullptr;
+    *input = nullptr;
+    if (arg < cmd.arg_count) {
+        FileNode* node = filesystem.lookup(cmd.args[arg]);
+        if (!node || node->type != FILE_TYPE_FILE) {
+            kprintf(out(), "Error: file not found: %s\n", cmd.args[arg]);
+            set_status(1);
+            return false;
+        }
+        *file = node;
+        return true;
+    }
+    *input = in();
+    if (!*input) {
+        kprintf(out(), "Usage: %s %s\n", cmd.name, find_command(cmd.name)->usage);
+        set_status(2);
+        return false;
     }
+    return true;
 }
 
-void CommandSystem::cmd_move(const char* src, const char* dest) {
-    if (filesystem.move(src, dest)) {
-        terminal.write("Moved: ");
-        terminal.write(src);
-        terminal.write(" -> ");
-        terminal.write(dest);
-        terminal.write("\n");
-    } else {
-        terminal.write("Error: could not move ");
-        terminal.write(src);
-        terminal.write(" to ");
-        terminal.write(dest);
-        terminal.write("\n");
+/**
+ * Read all of Standard Input into one Heap Buffer
+ * 
+ * The buffer doubles through the heap size classes (heap_block_capacity),
+ * up to the largest block.
+ * 
+ * @param too_large Set when the input does not fit in SORT_MAX_INPUT bytes
+ * @return Buffer for delete[], or nullptr if the heap ran out or the input
+ *         is too large
+ */
+static char* read_all(Pipe* input, uint32_t* size, bool* too_large) {
+    uint32_t capacity = heap_block_capacity(PIPE_BUFFER_SIZE);
+    uint32_t used = 0;
+    char* buffer = new char[capacity];
+    *too_large = false;
+    while (buffer) {
+        if (used == capacity) {
+            if (capacity == SORT_MAX_INPUT) {
+                char extra;
+                if (input->read(&extra, 1) == 0) break;
+                *too_large = true;
+                delete[] buffer;
+                return nullptr;
+            }
+            // One byte more than a full block is the next class: twice the size
+            capacity = heap_block_capacity(capacity + 1);
+            char* grown = new char[capacity];
+            if (grown) memcpy(grown, buffer, used);
+            delete[] buffer;
+            buffer = grown;
+            continue;
+        }
+        uint32_t n = input->read(buffer + used, capacity - used);
+        if (n == 0) break;
+        used += n;
     }
+    *size = used;
+    return buffer;
 }
 
-void CommandSystem::cmd_copy(const char* src, const char* dest) {
-    if (filesystem.copy_file(src, dest)) {
-        terminal.write("Copied: ");
-        terminal.write(src);
-        terminal.write(" -> ");
-        terminal.write(dest);
-        terminal.write("\n");
-    } else {
-        terminal.write("Error: could not copy ");
-        terminal.write(src);
-        terminal.write(" to ");
-        terminal.write(dest);
-        terminal.write("\n");
+/**
+ * "-n lines" in front of the file argument
+ * 
+ * @param lines Receives the count (10 without the option)
+ * @return Index of the file argument, or -1 if the option is malformed
+ */
+static int32_t parse_lines_option(const Command& cmd, uint32_t* lines) {
+    *lines = 10;
+    if (cmd.arg_count >= 1 && strcmp(cmd.args[0], "-n") == 0) {
+        if (cmd.arg_count < 2 || !parse_uint32(cmd.args[1], lines) || cmd.arg_count > 3) return -1;
+        return 2;
     }
+    return cmd.arg_count > 1 ? -1 : 0;
 }
 
-void CommandSystem::cmd_time() {
-    char num_buf[32];
-    char time_buf[64];
-    
+/**
+ * wc - lines, words and bytes
+ * 
+ * -l counts newlines only (word-at-a-time); -c of a file is its size.
+ */
+void CommandSystem::cmd_wc(const Command& cmd) {
+    char mode = 0;
+    uint32_t arg = 0;
+    if (cmd.arg_count >= 1 && cmd.args[0][0] == '-') {
+        mode = cmd.args[0][1];
+        if ((mode != 'l' && mode != 'w' && mode != 'c') || cmd.args[0][2]) {
+            out().write("Usage: wc [-l|-w|-c] [file]\n");
+            set_status(2);
+            return;
+        }
+        arg = 1;
+    }
+    FileNode* file;
+    Pipe* input;
+    if (!open_text(cmd, arg, &file, &input)) return;
+    
+    TextCounts counts = {};
+    if (file) {
+        if (mode == 'l') {
+            counts.lines = text_count_lines(file->data, file->size);
+        } else if (mode != 'c') {
+            text_count(file->data, file->size, counts);
+        }
+        counts.bytes = file->size;
+    } else {
+        char block[PIPE_BUFFER_SIZE];
+        uint32_t n;
+        while ((n = input->read(block, sizeof(block))) > 0) {
+            if (mode == 'l') {
+                counts.lines += text_count_lines(block, n);
+            } else if (mode != 'c') {
+                text_count(block, n, counts);
+            }
+            counts.bytes += (mode == 'l' || mode == 'c') ? n : 0;
+        }
+    }
+    
+    const char* name = file ? cmd.args[arg] : "";
+    switch (mode) {
+        case 'l': kprintf(out(), "%7u %s\n", counts.lines, name); break;
+        case 'w': kprintf(out(), "%7u %s\n", counts.words, name); break;
+        case 'c': kprintf(out(), "%7u %s\n", counts.bytes, name); break;
+        default:  kprintf(out(), "%7u %7u %7u %s\n", counts.lines, counts.words, counts.bytes, name); break;
+    }
+}
+
+/**
+ * sort - sort lines byte-wise (-r: descending)
+ * 
+ * Sorts a table of line offsets (one allocation, sized to the counted
+ * lines) with introsort; the text itself is never moved. Standard input and
+ * the line table each have to fit in one heap block, so sort takes at most
+ * SORT_MAX_INPUT bytes of input and SORT_MAX_LINES lines, and refuses
+ * larger input with an error.
+ */
+void CommandSystem::cmd_sort(const Command& cmd) {
+    bool reverse = cmd.arg_count >= 1 && strcmp(cmd.args[0], "-r") == 0;
+    uint32_t arg = reverse ? 1 : 0;
+    if (cmd.arg_count > arg + 1) {
+        out().write("Usage: sort [-r] [file]\n");
+        set_status(2);
+        return;
+    }
+    FileNode* file;
+    Pipe* input;
+    if (!open_text(cmd, arg, &file, &input)) return;
+    
+    char* owned = nullptr;
+    const char* data = file ? file->data : nullptr;
+    uint32_t size = file ? file->size : 0;
+    if (input) {
+        bool too_large;
+        owned = read_all(input, &size, &too_large);
+        if (too_large) {
+            kprintf(out(), "Error: sort input is larger than %u bytes\n", SORT_MAX_INPUT);
+            set_status(1);
+            return;
+        }
+        if (!owned) {
+            out().write("Error: out of memory\n");
+            set_status(1);
+            return;
+        }
+        data = owned;
+    }
+    if (!data || size == 0) {
+        delete[] owned;
+        return;
+    }
+    // One entry per line; a last line without a newline counts too
+    uint32_t line_count = text_count_lines(data, size) + (data[size - 1] != '\n' ? 1 : 0);
+    if (line_count > SORT_MAX_LINES) {
+        kprintf(out(), "Error: sort takes at most %u lines\n", SORT_MAX_LINES);
+        delete[] owned;
+        set_status(1);
+        return;
+    }
+    LineRef* lines = new LineRef[line_count];
+    if (!lines) {
+        out().write("Error: out of memory\n");
+        delete[] owned;
+        set_status(1);
+        return;
+    }
+    uint32_t count = text_split_lines(data, size, lines, line_count);
+    text_sort_lines(data, lines, count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const LineRef& line = lines[reverse ? count - 1 - i : i];
+        out().write(data + line.offset, line.length);
+        out().put('\n');
+    }
+    delete[] lines;
+    delete[] owned;
+}
+
+/**
+ * uniq - drop lines equal to the line before (-c: prefix repeat counts)
+ */
+void CommandSystem::cmd_uniq(const Command& cmd) {
+    bool counts = cmd.arg_count >= 1 && strcmp(cmd.args[0], "-c") == 0;
+    uint32_t arg = counts ? 1 : 0;
+    if (cmd.arg_count > arg + 1) {
+        out().write("Usage: uniq [-c] [file]\n");
+        set_status(2);
+        return;
+    }
+    FileNode* file;
+    Pipe* input;
+    if (!open_text(cmd, arg, &file, &input)) return;
+    
+    LineReader reader = file ? LineReader(file->data, file->size) : LineReader(input);
+    char* saved = nullptr;          // Previous piped line
+    if (!reader.lines_persist()) {
+        saved = new char[TEXT_LINE_BUFFER];
+        if (!saved) {
+            out().write("Error: out of memory\n");
+            set_status(1);
+            return;
+        }
+    }
+    text_uniq(reader, saved, counts, out());
+    delete[] saved;
+}
+
+void CommandSystem::cmd_head(const Command& cmd) {
+    uint32_t lines;
+    int32_t arg = parse_lines_option(cmd, &lines);
+    if (arg < 0) {
+        out().write("Usage: head [-n lines] [file]\n");
+        set_status(2);
+        return;
+    }
+    FileNode* file;
+    Pipe* input;
+    if (!open_text(cmd, arg, &file, &input)) return;
+    
+    if (file) {
+        out().write(file->data, text_head_length(file->data, file->size, &lines));
+        return;
+    }
+    // Stop reading as soon as enough lines have passed
+    char block[PIPE_BUFFER_SIZE];
+    uint32_t n;
+    while (lines > 0 && (n = input->read(block, sizeof(block))) > 0) {
+        out().write(block, text_head_length(block, n, &lines));
+    }
+}
+
+/**
+ * tail - last lines
+ * 
+ * A file is scanned backwards from its end, so only the printed lines are
+ * read. Standard input has no end to start from: it streams through a
+ * window of the last TEXT_TAIL_WINDOW bytes, which bounds what can be
+ * printed.
+ */
+void CommandSystem::cmd_tail(const Command& cmd) {
+    uint32_t lines;
+    int32_t arg = parse_lines_option(cmd, &lines);
+    if (arg < 0) {
+        out().write("Usage: tail [-n lines] [file]\n");
+        set_status(2);
+        return;
+    }
+    FileNode* file;
+    Pipe* input;
+    if (!open_text(cmd, arg, &file, &input)) return;
+    
+    if (file) {
+        uint32_t start = text_tail_offset(file->data, file->size, lines);
+        out().write(file->data + start, file->size - start);
+        return;
+    }
+    char* window = new char[TEXT_TAIL_WINDOW * 2];
+    if (!window) {
+        out().write("Error: out of memory\n");
+        set_status(1);
+        return;
+    }
+    uint32_t used = 0;
+    uint32_t n;
+    while ((n = input->read(window + used, TEXT_TAIL_WINDOW * 2 - used)) > 0) {
+        used += n;
+        if (used == TEXT_TAIL_WINDOW * 2) {
+            // Keep the newest half; the copy never overlaps
+            memcpy(window, window + TEXT_TAIL_WINDOW, TEXT_TAIL_WINDOW);
+            used = TEXT_TAIL_WINDOW;
+        }
+    }
+    uint32_t start = text_tail_offset(window, used, lines);
+    out().write(window + start, used - start);
+    delete[] window;
+}
+
+/**
+ * crc32 / adler32 / sha256sum - checksum of a file, disk sectors or input
+ * 
+ *   <cmd> [-t] <file>              File contents, hashed in place
+ *   <cmd> [-t] -s <lba> <count>    VirtualDisk sectors
+ *   <cmd> [-t]                     Standard input
+ * 
+ * Prints "<digest>  <name>"; -t adds the size, time and throughput so the
+ * algorithms can be compared on the same data.
+ */
+void CommandSystem::cmd_checksum(const Command& cmd) {
+    ChecksumKind kind = (cmd.name[0] == 'c') ? CHECKSUM_CRC32
+                      : (cmd.name[0] == 'a') ? CHECKSUM_ADLER32 : CHECKSUM_SHA256;
+    uint32_t arg = 0;
+    bool timing = cmd.arg_count > 0 && strcmp(cmd.args[0], "-t") == 0;
+    if (timing) arg++;
+    
+    uint32_t lba = 0, sectors = 0;
+    bool disk = arg < cmd.arg_count && strcmp(cmd.args[arg], "-s") == 0;
+    if (disk) {
+        // A count of 0 names no sectors (and no range to print)
+        if (cmd.arg_count != arg + 3 || !parse_uint32(cmd.args[arg + 1], &lba) ||
+            !parse_uint32(cmd.args[arg + 2], &sectors) || sectors == 0) {
+            kprintf(out(), "Usage: %s [-t] [file | -s <lba> <count>]\n", cmd.name);
+            set_status(2);
+            return;
+        }
+        if (lba >= vdisk.sector_count() || sectors > vdisk.sector_count() - lba) {
+            kprintf(out(), "Error: sectors %u..%u out of range (disk has %u)\n",
+                    lba, lba + sectors - 1, vdisk.sector_count());
+            set_status(1);
+            return;
+        }
+    } else if (cmd.arg_count > arg + 1) {
+        kprintf(out(), "Usage: %s [-t] [file | -s <lba> <count>]\n", cmd.name);
+        set_status(2);
+        return;
+    }
+    FileNode* file = nullptr;
+    Pipe* input = nullptr;
+    if (!disk && !open_text(cmd, arg, &file, &input)) return;
+    
+    Checksum sum;
+    checksum_init(sum, kind);
+    uint32_t bytes = 0;
+    uint64_t start = read_tsc();
+    if (disk) {
+        uint8_t sector[VDISK_SECTOR_SIZE];
+        for (uint32_t i = 0; i < sectors; ++i) {
+            if ((i & 63) == 0 && task_poll()) {
+                set_status(130);
+                return;
+            }
+            vdisk.read_sector(lba + i, sector);
+            checksum_update(sum, sector, sizeof(sector));
+        }
+        bytes = sectors * VDISK_SECTOR_SIZE;
+    } else if (file) {
+        // Large blocks straight from the file data, with a cancel check in between
+        for (uint32_t pos = 0; pos < file->size; pos += 65536) {
+            if (task_poll()) {
+                set_status(130);
+                return;
+            }
+            uint32_t len = file->size - pos;
+            if (len > 65536) len = 65536;
+            checksum_update(sum, file->data + pos, len);
+        }
+        bytes = file->size;
+    } else {
+        char block[PIPE_BUFFER_SIZE];
+        uint32_t n;
+        while ((n = input->read(block, sizeof(block))) > 0) {
+            checksum_update(sum, block, n);
+            bytes += n;
+        }
+    }
+    uint64_t cycles = read_tsc() - start;
+    
+    char digest[SHA256_DIGEST_SIZE * 2 + 1];
+    checksum_format(sum, digest);
+    if (disk) {
+        kprintf(out(), "%s  sectors %u-%u\n", digest, lba, lba + sectors - 1);
+    } else {
+        kprintf(out(), "%s  %s\n", digest, file ? cmd.args[arg] : "-");
+    }
+    if (timing) {
+        uint64_t us = tsc_to_us(cycles);
+        if (us == 0) us = 1;
+        // Bytes per microsecond == MB/s; keep two decimals
+        uint32_t centi_mbps = (uint32_t)div_u64((uint64_t)bytes * 100, (uint32_t)us);
+        kprintf(out(), "%u bytes in %llu us = %u.%02u MB/s\n",
+                bytes, us, centi_mbps / 100, centi_mbps % 100);
+    }
+}
+
+/**
+ * hexdump - canonical hex/ASCII dump
+ * 
+ *   hexdump <file>              File contents
+ *   hexdump                     Standard input (e.g. "cat a | hexdump")
+ *   hexdump -s <lba> <count>    count VirtualDisk sectors starting at lba
+ * 
+ * Input is dumped one block at a time, with a cancellation check between
+ * blocks, so large files and long sector ranges stay interruptible.
+ */
+void CommandSystem::cmd_hexdump(const Command& cmd) {
+    if (cmd.arg_count >= 1 && strcmp(cmd.args[0], "-s") == 0) {
+        uint32_t lba, count;
+        // A count of 0 names no sectors (and no range to print)
+        if (cmd.arg_count != 3 || !parse_uint32(cmd.args[1], &lba) || !parse_uint32(cmd.args[2], &count) ||
+            count == 0) {
+            out().write("Usage: hexdump -s <lba> <count>\n");
+            set_status(2);
+            return;
+        }
+        if (lba >= vdisk.sector_count() || count > vdisk.sector_count() - lba) {
+            kprintf(out(), "Error: sectors %u..%u out of range (disk has %u)\n",
+                    lba, lba + count - 1, vdisk.sector_count());
+            set_status(1);
+            return;
+        }
+        uint8_t sector[VDISK_SECTOR_SIZE];
+        HexDumper dump(out(), lba * VDISK_SECTOR_SIZE);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (task_poll()) {
+                set_status(130);
+                return;
+            }
+            vdisk.read_sector(lba + i, sector);
+            dump.feed(sector, sizeof(sector));
+        }
+        dump.finish();
+        return;
+    }
+    if (cmd.arg_count > 1) {
+        out().write("Usage: hexdump [file] | hexdump -s <lba> <count>\n");
+        set_status(2);
+        return;
+    }
+
+    HexDumper dump(out(), 0);
+    if (cmd.arg_count == 0) {
+        Pipe* input = in();
+        if (!input) {
+            out().write("Usage: hexdump [file] | hexdump -s <lba> <count>\n");
+            set_status(2);
+            return;
+        }
+        char block[PIPE_BUFFER_SIZE];
+        uint32_t n;
+        while ((n = input->read(block, sizeof(block))) > 0) {
+            dump.feed(block, n);
+        }
+        dump.finish();
+        return;
+    }
+
+    FileNode* file = filesystem.lookup(cmd.args[0]);
+    if (!file || file->type != FILE_TYPE_FILE) {
+        kprintf(out(), "Error: file not found: %s\n", cmd.args[0]);
+        set_status(1);
+        return;
+    }
+    for (uint32_t pos = 0; pos < file->size; pos += VDISK_SECTOR_SIZE) {
+        if (task_poll()) {
+            set_status(130);
+            return;
+        }
+        uint32_t len = file->size - pos;
+        if (len > VDISK_SECTOR_SIZE) len = VDISK_SECTOR_SIZE;
+        dump.feed(file->data + pos, len);
+    }
+    dump.finish();
+}
+
+/**
+ * Here-document Line
+ * 
+ * Called instead of running a command while a here-document is open. The
+ * line is appended straight from the input buffer.
+ */
+void CommandSystem::heredoc_input()
+{
+    if (!heredoc_split && strcmp(input_buffer, heredoc_end) == 0) {
+        end_heredoc();
+        return;
+    }
+    input_buffer[input_pos] = '\n';
+    if (!filesystem.append(heredoc_file, input_buffer, input_pos + 1)) {
+        out().write("Error: out of memory writing to file\n");
+        end_heredoc();
+    }
+    input_buffer[input_pos] = '\0';
+}
+
+/**
+ * Close the Here-document
+ * 
+ * Releases the target file (it can be removed again) and returns to normal
+ * input. Does nothing if no here-document is open.
+ */
+void CommandSystem::end_heredoc()
+{
+    if (heredoc_file) {
+        heredoc_file->open_count--;
+        heredoc_file = nullptr;
+    }
+}
+
+/**
+ * write - replace a file's content
+ * 
+ *   write <file> <text...>     Words joined with single spaces
+ *   write <file> <<END         Following input lines, up to a line "END"
+ *                              ("<<" alone uses EOF)
+ * 
+ * Only an unquoted "<<" starts a here-document: write f "<<" writes the
+ * text "<<".
+ */
+void CommandSystem::cmd_write(const Command& cmd) {
+    const char* tag = nullptr;
+    bool operator_word = !(cmd.quoted_args & (1u << 1));   // A quoted "<<" is plain text
+    if (operator_word && cmd.arg_count == 2 && cmd.args[1][0] == '<' && cmd.args[1][1] == '<') {
+        tag = cmd.args[1][2] ? cmd.args[1] + 2 : "EOF";
+    } else if (operator_word && cmd.arg_count == 3 && strcmp(cmd.args[1], "<<") == 0) {
+        tag = cmd.args[2];
+    }
+    if (tag) {
+        // Lines come from the keyboard, so only the interactive shell can open one
+        if (task_current()->id != 0 || script_depth > 0) {
+            out().write("Error: here-document needs keyboard input\n");
+            set_status(2);
+            return;
+        }
+        if (strlen(tag) >= MAX_HEREDOC_TAG) {
+            out().write("Error: here-document terminator too long\n");
+            set_status(2);
+            return;
+        }
+        FileNode* file = open_redirect(cmd.args[0], false);
+        if (!file) {
+            set_status(1);
+            return;
+        }
+        strncpy(heredoc_end, tag, sizeof(heredoc_end));
+        heredoc_file = file;
+        heredoc_file->open_count++;     // Released by end_heredoc()
+        return;
+    }
+    
+    if (cmd.arg_count == 2) {
+        // write file "text" - no copy
+        if (!filesystem.write_file(cmd.args[0], cmd.args[1])) set_status(1);
+        return;
+    }
+    // Unquoted words after the file name are joined with single spaces
+    char content[MAX_COMMAND_LENGTH] = {0};
+    uint32_t pos = 0;
+    for (uint32_t ai = 1; ai < cmd.arg_count && pos < MAX_COMMAND_LENGTH - 1; ++ai) {
+        const char* part = cmd.args[ai];
+        for (uint32_t pi = 0; part[pi] && pos < MAX_COMMAND_LENGTH - 1; ++pi) {
+            content[pos++] = part[pi];
+        }
+        if (ai + 1 < cmd.arg_count && pos < MAX_COMMAND_LENGTH - 1) {
+            content[pos++] = ' ';
+        }
+    }
+    content[pos] = '\0';
+    if (!filesystem.write_file(cmd.args[0], content)) set_status(1);
+}
+
+/**
+ * more / less - page through a file or standard input
+ * 
+ * The pager needs the keyboard and the screen, so it only runs in a
+ * foreground job whose output is the terminal; anywhere else (background,
+ * "more file > copy", "more file | cat") the input is copied through.
+ */
+void CommandSystem::cmd_more(const Command& cmd) {
+    Pipe* input = nullptr;
+    FileNode* file = nullptr;
+    if (cmd.arg_count == 1) {
+        file = filesystem.lookup(cmd.args[0]);
+        if (!file || file->type != FILE_TYPE_FILE) {
+            kprintf(out(), "Error: file not found: %s\n", cmd.args[0]);
+            set_status(1);
+            return;
+        }
+    } else {
+        input = in();
+        if (!input) {
+            kprintf(out(), "Usage: %s <file>\n", cmd.name);
+            set_status(2);
+            return;
+        }
+    }
+    
+    if (&out() != &terminal_sink || task_current()->job != 0) {
+        if (file) {
+            out().write(file->data, file->size);
+            return;
+        }
+        char block[PIPE_BUFFER_SIZE];
+        uint32_t n;
+        while ((n = input->read(block, sizeof(block))) > 0) {
+            out().write(block, n);
+        }
+        return;
+    }
+    out().flush();
+    if (file) {
+        set_status(pager_run(cmd.args[0], file->data, file->data ? file->size : 0, nullptr));
+    } else {
+        set_status(pager_run("(standard input)", nullptr, 0, input));
+    }
+}
+
+void CommandSystem::cmd_edit(const Command& cmd) {
+    // The editor reads the keyboard, which only the shell task owns
+    if (task_current()->id != 0) {
+        out().write("Error: edit needs keyboard input\n");
+        set_status(2);
+        return;
+    }
+    FileNode* node = filesystem.lookup(cmd.args[0]);
+    if (node && node->type != FILE_TYPE_FILE) {
+        kprintf(out(), "Error: %s is a directory\n", cmd.args[0]);
+        set_status(1);
+        return;
+    }
+    if (node && node->size > EDITOR_MAX_TEXT) {
+        kprintf(out(), "Error: %s is too large to edit (limit %u bytes)\n", cmd.args[0], EDITOR_MAX_TEXT);
+        set_status(1);
+        return;
+    }
+    int32_t status = editor_run(cmd.args[0]);
+    if (status == 1) {
+        out().write("Error: out of memory\n");
+    }
+    set_status(status);
+}
+
+void CommandSystem::cmd_remove(const Command& cmd) {
+    const char* name = cmd.args[0];
+    if (filesystem.remove(name)) {
+        out().write("Removed: ");
+        out().write(name);
+        out().write("\n");
+    } else {
+        out().write("Error: could not remove ");
+        out().write(name);
+        out().write("\n");
+        set_status(1);
+    }
+}
+
+void CommandSystem::cmd_move(const Command& cmd) {
+    const char* src = cmd.args[0];
+    const char* dest = cmd.args[1];
+    if (filesystem.move(src, dest)) {
+        out().write("Moved: ");
+        out().write(src);
+        out().write(" -> ");
+        out().write(dest);
+        out().write("\n");
+    } else {
+        out().write("Error: could not move ");
+        out().write(src);
+        out().write(" to ");
+        out().write(dest);
+        out().write("\n");
+        set_status(1);
+    }
+}
+
+void CommandSystem::cmd_copy(const Command& cmd) {
+    const char* src = cmd.args[0];
+    const char* dest = cmd.args[1];
+    if (filesystem.copy_file(src, dest)) {
+        out().write("Copied: ");
+        out().write(src);
+        out().write(" -> ");
+        out().write(dest);
+        out().write("\n");
+    } else {
+        out().write("Error: could not copy ");
+        out().write(src);
+        out().write(" to ");
+        out().write(dest);
+        out().write("\n");
+        set_status(1);
+    }
+}
+
+/**
+ * time <command> - run a command and report what it cost
+ * 
+ * Samples the TSC, the heap counters, the disk sector counters and the
+ * terminal character count around the command. The report goes to the
+ * terminal (like stderr), so redirecting the command's output does not
+ * capture it. The command's exit status is kept.
+ */
+void CommandSystem::run_timed(const Command& cmd)
+{
+    Command inner;
+    inner.name = cmd.args[0];
+    inner.arg_count = cmd.arg_count - 1;
+    inner.quoted_args = cmd.quoted_args >> 1;
+    for (uint32_t i = 1; i < cmd.arg_count; ++i) {
+        inner.args[i - 1] = cmd.args[i];
+    }
+    
+    HeapStats heap_before, heap_after;
+    heap_get_stats(&heap_before);
+    uint32_t reads = vdisk.sectors_read();
+    uint32_t writes = vdisk.sectors_written();
+    out().flush();
+    uint32_t chars = terminal.getCharsWritten();
+    uint64_t start = read_tsc();
+    
+    dispatch(inner);
+    out().flush();          // Output still buffered counts toward the command
+    
+    uint64_t cycles = read_tsc() - start;
+    chars = terminal.getCharsWritten() - chars;
+    heap_get_stats(&heap_after);
+    
+    OutputSink& report = terminal_sink;
+    kprintf(report, "real %llu us (%llu cycles)\n", tsc_to_us(cycles), cycles);
+    kprintf(report, "heap %llu B allocated in %u blocks, %llu B freed\n",
+            heap_after.bytes_allocated - heap_before.bytes_allocated,
+            heap_after.allocations - heap_before.allocations,
+            heap_after.bytes_freed - heap_before.bytes_freed);
+    kprintf(report, "disk %u sectors read, %u written\n",
+            vdisk.sectors_read() - reads, vdisk.sectors_written() - writes);
+    kprintf(report, "tty  %u characters output\n", chars);
+    report.flush();
+}
+
+void CommandSystem::cmd_time(const Command& cmd) {
+    if (cmd.arg_count > 0) {
+        run_timed(cmd);
+        return;
+    }
+    
     // Display system clock information (uptime)
-    terminal.write("System Clock (Uptime):\n");
-    
-    uint64_t ticks = get_ticks();
-    uint64_t seconds = get_seconds();
-    uint64_t milliseconds = get_milliseconds();
-    
-    // Display ticks
-    terminal.write("  Ticks: ");
-    uint64_to_string(ticks, num_buf);
-    terminal.write(num_buf);
-    terminal.write("\n");
-    
-    // Display seconds
-    terminal.write("  Seconds: ");
-    uint64_to_string(seconds, num_buf);
-    terminal.write(num_buf);
-    terminal.write("\n");
-    
-    // Display milliseconds
-    terminal.write("  Milliseconds: ");
-    uint64_to_string(milliseconds, num_buf);
-    terminal.write(num_buf);
-    terminal.write("\n");
+    kprintf(out(), "System Clock (Uptime):\n  Ticks: %llu\n  Seconds: %llu\n  Milliseconds: %llu\n",
+            get_ticks(), get_seconds(), get_milliseconds());
     
     // Display Real-Time Clock
-    terminal.write("\nReal-Time Clock:\n");
+    out().write("\nReal-Time Clock:\n");
     RTCTime rtc_time;
     if (get_rtc_time(&rtc_time)) {
-        // Format time as HH:MM:SS
-        time_buf[0] = '0' + (rtc_time.hour / 10);
-        time_buf[1] = '0' + (rtc_time.hour % 10);
-        time_buf[2] = ':';
-        time_buf[3] = '0' + (rtc_time.minute / 10);
-        time_buf[4] = '0' + (rtc_time.minute % 10);
-        time_buf[5] = ':';
-        time_buf[6] = '0' + (rtc_time.second / 10);
-        time_buf[7] = '0' + (rtc_time.second % 10);
-        time_buf[8] = '\0';
-        
-        terminal.write("  Time: ");
-        terminal.write(time_buf);
-        terminal.write("\n");
-        
-        // Format date as YYYY-MM-DD or MM/DD/YY
+        kprintf(out(), "  Time: %02u:%02u:%02u\n", rtc_time.hour, rtc_time.minute, rtc_time.second);
         if (rtc_time.century > 0) {
             // Full year format: YYYY-MM-DD
-            uint64_to_string((uint64_t)rtc_time.century * 100 + rtc_time.year, num_buf);
-            terminal.write("  Date: ");
-            terminal.write(num_buf);
-            terminal.write("-");
-            if (rtc_time.month < 10) terminal.write("0");
-            uint64_to_string((uint64_t)rtc_time.month, num_buf);
-            terminal.write(num_buf);
-            terminal.write("-");
-            if (rtc_time.day < 10) terminal.write("0");
-            uint64_to_string((uint64_t)rtc_time.day, num_buf);
-            terminal.write(num_buf);
-            terminal.write("\n");
+            kprintf(out(), "  Date: %u-%02u-%02u\n",
+                    rtc_time.century * 100u + rtc_time.year, rtc_time.month, rtc_time.day);
         } else {
             // Short format: MM/DD/YY
-            terminal.write("  Date: ");
-            if (rtc_time.month < 10) terminal.write("0");
-            uint64_to_string((uint64_t)rtc_time.month, num_buf);
-            terminal.write(num_buf);
-            terminal.write("/");
-            if (rtc_time.day < 10) terminal.write("0");
-            uint64_to_string((uint64_t)rtc_time.day, num_buf);
-            terminal.write(num_buf);
-            terminal.write("/");
-            if (rtc_time.year < 10) terminal.write("0");
-            uint64_to_string((uint64_t)rtc_time.year, num_buf);
-            terminal.write(num_buf);
-            terminal.write("\n");
+            kprintf(out(), "  Date: %02u/%02u/%02u\n", rtc_time.month, rtc_time.day, rtc_time.year);
         }
     } else {
-        terminal.write("  Error: Could not read RTC\n");
+        out().write("  Error: Could not read RTC\n");
+    }
+}
+
+void CommandSystem::cmd_bootinfo(const Command&) {
+    boot_info_print(out());
+}
+
+void CommandSystem::cmd_boottime(const Command&) {
+    boot_timeline_print(out());
+}
+
+void CommandSystem::cmd_params(const Command&) {
+    params_print(out());
+}
+
+/**
+ * Run the null system call benchmark in a fresh ring-3 process
+ * @param mode 0 = trampoline page (SYSENTER when supported), 1 = INT 0x80
+ * @param iterations Number of round trips
+ * @return Elapsed TSC cycles (read around process_run, so the full 64 bits
+ *         survive), or 0 if the process could not be created
+ */
+static uint64_t run_syscall_bench(uint32_t mode, uint32_t iterations) {
+    uint32_t code_size = user_bench_end - user_bench_start;
+
+    Process* proc = process_create("syscallbench");
+    if (!proc) return 0;
+    if (!process_map(proc, USER_BASE, code_size, PAGE_USER) ||
+        !process_copy_to(proc, USER_BASE, user_bench_start, code_size) ||
+        !process_push(proc, mode) ||
+        !process_push(proc, iterations)) {
+        process_destroy(proc);
+        return 0;
+    }
+    uint64_t start = read_tsc();
+    process_run(proc);
+    uint64_t cycles = read_tsc() - start;
+    process_destroy(proc);
+    return cycles;
+}
+
+void CommandSystem::cmd_syscallbench(const Command& cmd) {
+    const char* iterations_arg = cmd.arg_count >= 1 ? cmd.args[0] : nullptr;
+    uint32_t iterations = 10000;
+    if (iterations_arg && (!parse_uint32(iterations_arg, &iterations) || iterations == 0)) {
+        out().write("Usage: syscallbench [iterations]\n");
+        set_status(2);
+        return;
+    }
+
+    kprintf(out(), "Null system call round trip (%u iterations, cycles/call):\n", iterations);
+
+    const char* labels[2] = {
+        syscall_has_sysenter() ? "  sysenter/sysexit: " : "  trampoline (int): ",
+        "  int 0x80/iret:    "
+    };
+    for (uint32_t mode = 0; mode < 2; ++mode) {
+        uint64_t cycles = run_syscall_bench(mode, iterations);
+        if (task_cancelled()) {
+            out().write("Interrupted\n");
+            set_status(130);
+            return;
+        }
+        out().write(labels[mode]);
+        if (cycles == 0) {
+            out().write("failed (out of memory)\n");
+            continue;
+        }
+        kprintf(out(), "%llu\n", div_u64(cycles, iterations));
+    }
+}
+
+bool CommandSystem::run_program(const char* path, uint32_t argc, const char* const* argv) {
+    FileNode* file = filesystem.lookup(path);
+    if (!file || file->type != FILE_TYPE_FILE || !file->data) {
+        out().write("Error: file not found: ");
+        out().write(path);
+        out().write("\n");
+        set_status(1);
+        return false;
+    }
+    ElfLoadInfo info;
+    Process* proc = spawn_program(out(), file, argc, argv, &info);
+    if (!proc) {
+        set_status(1);
+        return false;
+    }
+    int32_t status = process_run(proc);
+    process_destroy(proc);
+    set_status(status);
+
+    if (status != 0) {
+        kprintf(out(), "Process exited with status %d\n", status);
+    }
+    return true;
+}
+
+void CommandSystem::cmd_exec(const Command& cmd) {
+    const char* argv[MAX_ARGS];
+    for (uint32_t i = 0; i < cmd.arg_count; ++i) {
+        argv[i] = cmd.args[i];
+    }
+    run_program(cmd.args[0], cmd.arg_count, argv);
+}
+
+void CommandSystem::cmd_execbench(const Command& cmd) {
+    const char* path = cmd.args[0];
+    const char* iterations_arg = cmd.arg_count >= 2 ? cmd.args[1] : nullptr;
+    uint32_t iterations = 100;
+    if (iterations_arg && (!parse_uint32(iterations_arg, &iterations) || iterations == 0)) {
+        out().write("Usage: execbench <file> [iterations]\n");
+        set_status(2);
+        return;
+    }
+    FileNode* file = filesystem.lookup(path);
+    if (!file || file->type != FILE_TYPE_FILE || !file->data) {
+        out().write("Error: file not found: ");
+        out().write(path);
+        out().write("\n");
+        set_status(1);
+        return;
+    }
+
+    // Phases: load = create + map segments + argv, run = ring 3 until exit, teardown = destroy
+    uint64_t load_cycles = 0, run_cycles = 0, teardown_cycles = 0;
+    ElfLoadInfo info;
+    const char* argv[1] = { file->name };
+    for (uint32_t i = 0; i < iterations; ++i) {
+        if (task_poll()) {
+            out().write("Interrupted\n");
+            set_status(130);
+            return;
+        }
+        uint64_t t0 = read_tsc();
+        Process* proc = spawn_program(out(), file, 1, argv, &info);
+        if (!proc) return;
+        uint64_t t1 = read_tsc();
+        process_run(proc);
+        uint64_t t2 = read_tsc();
+        process_destroy(proc);
+        uint64_t t3 = read_tsc();
+        load_cycles += t1 - t0;
+        run_cycles += t2 - t1;
+        teardown_cycles += t3 - t2;
+    }
+
+    kprintf(out(), "Exec latency (%u runs, average cycles):\n", iterations);
+    kprintf(out(), "  load:     %llu\n", div_u64(load_cycles, iterations));
+    kprintf(out(), "  run:      %llu\n", div_u64(run_cycles, iterations));
+    kprintf(out(), "  teardown: %llu\n", div_u64(teardown_cycles, iterations));
+    kprintf(out(), "  pages: %u mapped from file, %u copied/zeroed\n", info.shared_pages, info.copied_pages);
+}
+
+/**
+ * Pipe benchmark state shared by the writer and reader tasks
+ */
+struct PipeBench {
+    Pipe* pipe;
+    uint32_t bytes;                 // Bytes to send
+    uint32_t received;              // Bytes the reader got
+};
+
+static void pipebench_writer(void* arg) {
+    PipeBench* bench = (PipeBench*)arg;
+    char block[512];
+    memset(block, 'x', sizeof(block));
+    for (uint32_t sent = 0; sent < bench->bytes; sent += sizeof(block)) {
+        if (task_poll()) break;
+        bench->pipe->write(block, sizeof(block));
+    }
+    bench->pipe->close_write();
+}
+
+static void pipebench_reader(void* arg) {
+    PipeBench* bench = (PipeBench*)arg;
+    char block[PIPE_BUFFER_SIZE];
+    uint32_t n;
+    while ((n = bench->pipe->read(block, sizeof(block))) > 0) {
+        bench->received += n;
+    }
+    bench->pipe->close_read();
+}
+
+void CommandSystem::cmd_pipebench(const Command& cmd) {
+    const char* kb_arg = cmd.arg_count >= 1 ? cmd.args[0] : nullptr;
+    uint32_t kb = 4096;
+    if (kb_arg && (!parse_uint32(kb_arg, &kb) || kb == 0 || kb > 1024 * 1024)) {
+        out().write("Usage: pipebench [kilobytes]\n");
+        set_status(2);
+        return;
+    }
+
+    PipeBench bench;
+    bench.pipe = pipe_create();
+    bench.bytes = kb * 1024;
+    bench.received = 0;
+    if (!bench.pipe || task_free_slots() < 2) {
+        if (bench.pipe) {
+            bench.pipe->close_write();
+            bench.pipe->close_read();
+        }
+        out().write("Error: no free pipe or task\n");
+        set_status(1);
+        return;
+    }
+
+    // 512-byte writes into a PIPE_BUFFER_SIZE ring, drained in full-buffer reads
+    uint64_t start = read_tsc();
+    Task* writer = task_create("pipebench-w", pipebench_writer, &bench);
+    Task* reader = task_create("pipebench-r", pipebench_reader, &bench);
+    task_wait(writer);
+    task_wait(reader);
+    uint64_t cycles = read_tsc() - start;
+
+    uint64_t us = tsc_to_us(cycles);
+    if (us == 0) {
+        kprintf(out(), "Pipe throughput: %u KB in %llu cycles\n", bench.received / 1024, cycles);
+        return;
+    }
+    // Bytes per microsecond == MB/s; keep two decimals
+    uint32_t centi_mbps = (uint32_t)div_u64((uint64_t)bench.received * 100, (uint32_t)us);
+    kprintf(out(), "Pipe throughput: %u KB in %llu us = %u.%02u MB/s\n",
+            bench.received / 1024, us, centi_mbps / 100, centi_mbps % 100);
+}
+
+void CommandSystem::cmd_jobs(const Command&) {
+    for (uint32_t slot = 1; slot <= MAX_JOBS; ++slot) {
+        Job& job = jobs[slot];
+        if (!job.active) continue;
+        const char* status = "Running";
+        if (job.leader->state == TASK_DONE) {
+            status = job.killed ? "Terminated" : "Done";
+        } else if (job.killed) {
+            status = "Stopping";
+        }
+        print_job(slot, status);
+    }
+}
+
+/**
+ * Bring a Background Job to the Foreground
+ * 
+ * The shell waits for the job, and Ctrl+C now cancels it.
+ */
+void CommandSystem::cmd_fg(const Command& cmd) {
+    const char* job_arg = cmd.arg_count >= 1 ? cmd.args[0] : nullptr;
+    uint32_t slot = find_job(job_arg);
+    if (!slot) return;
+    Job& job = jobs[slot];
+    out().write(job.text);
+    out().write("\n");
+    out().flush();
+    
+    task_set_foreground(slot);
+    set_status(task_wait(job.leader));
+    task_set_foreground(0);
+    job.active = false;
+}
+
+void CommandSystem::cmd_kill(const Command& cmd) {
+    const char* job_arg = cmd.args[0];
+    uint32_t slot = find_job(job_arg);
+    if (!slot) return;
+    task_cancel_job(slot);
+    jobs[slot].killed = true;
+}
+
+/**
+ * bench [name] [samples] - run the microbenchmark registry (bench.cpp)
+ * 
+ * A name runs only the benchmarks starting with it. Results are printed as
+ * a table (with the median as operations per second, e.g. lines/s for
+ * ksnprintf_line) and sent to COM1 as JSON lines.
+ */
+void CommandSystem::cmd_bench(const Command& cmd) {
+    const char* filter = "";
+    uint32_t samples = BENCH_DEFAULT_SAMPLES;
+    for (uint32_t i = 0; i < cmd.arg_count; ++i) {
+        if (cmd.args[i][0] >= '0' && cmd.args[i][0] <= '9') {
+            if (!parse_uint32(cmd.args[i], &samples) || samples == 0 || samples > BENCH_MAX_SAMPLES) {
+                out().write("Error: samples must be 1..256\n");
+                set_status(2);
+                return;
+            }
+        } else {
+            filter = cmd.args[i];
+        }
+    }
+    
+    OutputSink& sink = out();
+    uint32_t filter_len = strlen(filter);
+    uint32_t matched = 0;
+    kprintf(sink, "%-20s%7s%9s%9s%12s  (TSC cycles/op)\n", "Benchmark", "batch", "median", "p99", "ops/s");
+    for (uint32_t i = 0; i < bench_count(); ++i) {
+        const Benchmark& bench = bench_get(i);
+        bool match = true;
+        for (uint32_t k = 0; k < filter_len; ++k) {
+            if (bench.name[k] != filter[k]) {
+                match = false;
+                break;
+            }
+        }
+        if (!match) continue;
+        matched++;
+        
+        sink.flush();           // Keep the table in order with benchmarks that draw on screen
+        BenchResult result;
+        if (!bench_run(bench, samples, &result)) {
+            sink.write("Interrupted\n");
+            set_status(130);
+            return;
+        }
+        bench_report_serial(bench, result);
+        
+        kprintf(sink, "%-20s%7u%9llu%9llu%12llu\n", bench.name, bench.batch, result.median, result.p99,
+                bench_per_second(result));
+    }
+    if (matched == 0) {
+        sink.write("Error: no benchmark named ");
+        sink.write(filter);
+        sink.write("*\n");
+        set_status(1);
+    }
+}
+
+/**
+ * Run a Tokenized Line on the Current Task
+ * 
+ * Entry point for scripts: the tokens are already split (and expanded), so
+ * only the job structure is built. The job's commands point at the token
+ * texts, which the caller keeps alive until this returns.
+ * 
+ * @return Exit status of the line (2 if it is malformed)
+ */
+int32_t CommandSystem::run_tokens(const Token* tokens, uint32_t count)
+{
+    if (count == 0) {
+        return status();
+    }
+    if (!build_job(tokens, count, script_job)) {
+        set_status(2);
+        return 2;
+    }
+    script_depth++;
+    run_job(script_job);
+    script_depth--;
+    return status();
+}
+
+void CommandSystem::cmd_run(const Command& cmd) {
+    set_status(script_run(cmd.arg_count, cmd.args));
+}
+
+/**
+ * test - evaluate a condition for "if"
+ * 
+ *   test a = b, test a != b    String comparison
+ *   test -f path, test -d path File / directory exists
+ *   test -n text, test -z text Non-empty / empty string
+ *   test text                  Non-empty string
+ */
+void CommandSystem::cmd_test(const Command& cmd) {
+    bool result = false;
+    if (cmd.arg_count == 3 && strcmp(cmd.args[1], "=") == 0) {
+        result = strcmp(cmd.args[0], cmd.args[2]) == 0;
+    } else if (cmd.arg_count == 3 && strcmp(cmd.args[1], "!=") == 0) {
+        result = strcmp(cmd.args[0], cmd.args[2]) != 0;
+    } else if (cmd.arg_count == 2 && (strcmp(cmd.args[0], "-f") == 0 || strcmp(cmd.args[0], "-d") == 0)) {
+        FileNode* node = filesystem.lookup(cmd.args[1]);
+        uint8_t type = (cmd.args[0][1] == 'f') ? FILE_TYPE_FILE : FILE_TYPE_DIRECTORY;
+        result = node && node->type == type;
+    } else if (cmd.arg_count == 2 && strcmp(cmd.args[0], "-n") == 0) {
+        result = cmd.args[1][0] != '\0';
+    } else if (cmd.arg_count == 2 && strcmp(cmd.args[0], "-z") == 0) {
+        result = cmd.args[1][0] == '\0';
+    } else if (cmd.arg_count == 1) {
+        result = cmd.args[0][0] != '\0';
+    } else {
+        out().write("Error: unknown test\n");
+        set_status(2);
+        return;
     }
+    set_status(result ? 0 : 1);
 }
 
-void CommandSystem::cmd_shutdown() {
+void CommandSystem::cmd_shutdown(const Command&) {
     terminal.write("Shutting down RusticOS...\n");
     terminal.write("System halted.\n");
     
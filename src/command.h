@@ -7,10 +7,12 @@
  * Handles command parsing, argument extraction, and command dispatch.
  * 
  * Features:
- *   - Command parsing with argument support
+ *   - Zero-copy command parsing with "quoted arguments" and \ escapes
  *   - Input buffer management with backspace support
- *   - Command execution and dispatch system
- *   - Help system for user assistance
+ *   - Table-driven dispatch with a compile-time perfect hash
+ *   - Help generated from the command table
+ *   - Here-documents: "write <file> <<END" streams the following input
+ *     lines into the file until a line reading END
  * 
  * Version: 1.0.1
  * ============================================================================
@@ -26,17 +28,50 @@
 // ============================================================================
 #define MAX_COMMAND_LENGTH   256     // Maximum length of command input
 #define MAX_ARGS             16      // Maximum number of command arguments
+#define MAX_PIPELINE_STAGES  4       // Maximum commands in "a | b | c | d"
+#define MAX_JOBS             4       // Background jobs ("cmd &")
+#define MAX_HEREDOC_TAG      32      // Terminator of "write <file> <<END"
+#define SORT_MAX_INPUT       HEAP_MAX_ALLOCATION         // Bytes of standard input sort reads (one heap block)
+#define SORT_MAX_LINES       (HEAP_MAX_ALLOCATION / 8)   // Lines sort orders (one 8-byte LineRef each)
+
+class OutputSink;
+class Pipe;
+struct FileNode;
+struct Job;
+
+#define MAX_TOKENS  (MAX_PIPELINE_STAGES * (MAX_ARGS + 2) + 2)   // Words and operators per line
+
+/**
+ * Token - one word or operator of a tokenized command line
+ */
+enum TokenType {
+    TOKEN_WORD,
+    TOKEN_PIPE,                     // |
+    TOKEN_REDIRECT,                 // >
+    TOKEN_APPEND                    // >>
+};
+
+struct Token {
+    TokenType type;
+    const char* text;               // Word text inside the line buffer (nullptr for operators)
+    bool quoted;                    // Word used quotes or a backslash: taken literally
+};
+
+// Split a line into tokens in place (quotes and escapes removed); nullptr or an error message
+const char* tokenize(char* line, Token* tokens, uint32_t max_tokens, uint32_t* count);
 
 /**
  * Command Structure
  * 
- * Represents a parsed command with its name and arguments.
- * Used internally by the command system for execution.
+ * Represents a parsed command with its name and arguments. The strings are
+ * not copies: they point into the tokenized command line (see tokenize()
+ * in command.cpp), which outlives the command.
  */
 struct Command {
-    char name[64];                  // Command name (e.g., "mkdir", "lsd", "help")
-    char args[MAX_ARGS][64];        // Array of argument strings
+    const char* name;               // Command name (e.g., "makedir", "lsd", "help")
+    const char* args[MAX_ARGS];     // Argument strings (quotes and escapes removed)
     uint32_t arg_count;             // Number of arguments provided
+    uint32_t quoted_args;           // Bit i set if args[i] was quoted or escaped (Token::quoted)
 };
 
 /**
@@ -54,11 +89,23 @@ private:
     char input_buffer[MAX_COMMAND_LENGTH];  // Buffer for user input
     uint32_t input_pos;                     // Current position in input buffer
     bool input_complete;                    // Flag: true when Enter is pressed
-    Command current_command;                // Parsed command structure
+    FileNode* heredoc_file;                 // Target of "write <file> <<END" (nullptr = normal input)
+    char heredoc_end[MAX_HEREDOC_TAG];      // Terminator line
+    bool heredoc_split;                     // Part of the current line was already appended
+    uint32_t script_depth;                  // Script lines being run (no keyboard input for them)
     
     // Private helper functions
-    void parse_command(const char* input, Command& cmd);  // Parse input string into command structure
-    void clear_command(Command& cmd);                     // Clear/reset command structure
+    bool parse_line(const char* line, Job& job);          // Tokenize a line into stages and redirection
+    bool build_job(const Token* tokens, uint32_t count, Job& job);  // Split tokens into stages and redirection
+    void run_pipeline(Job& job);                          // Run the stages concurrently, connected by pipes
+    FileNode* open_redirect(const char* target, bool append);  // Resolve/create the target of '>' or '>>'
+    void print_job(uint32_t slot, const char* status);    // "[n] status  text"
+    void report_jobs();                                   // Reap and report finished background jobs
+    uint32_t find_job(const char* arg);                   // Job slot from "n" / "%n" (0 if none)
+    void run_timed(const Command& cmd);                   // "time <command>": run and report its cost
+    void heredoc_input();                                 // Append the entered line, or end at the terminator
+    void end_heredoc();                                   // Release the here-document target
+    bool open_text(const Command& cmd, uint32_t arg, FileNode** file, Pipe** input);  // File cmd.args[arg], else standard input
     
 public:
     // Constructor
@@ -68,28 +115,80 @@ public:
     void process_input(char c);        // Process a single character input (handles backspace, enter, etc.)
     void execute_command();            // Execute the currently parsed command
     void reset_input();                // Reset input buffer and state for next command
+    void dispatch(const Command& cmd); // Run one parsed command
+    void run_job(Job& job);            // Run a parsed line on the current task
+    int32_t run_tokens(const Token* tokens, uint32_t count);  // Run a tokenized line; returns its status
+    
+    // Standard streams of the running command (per task)
+    OutputSink& out();                 // Where command output goes
+    Pipe* in();                        // Previous pipeline stage (nullptr if none)
+    
+    // Exit status of the last command on this task (0 = success, like $?)
+    void set_status(int32_t status);
+    int32_t status();
     
     // Accessors
     bool is_input_complete() const { return input_complete; }         // Check if command is ready to execute
     const char* get_input_buffer() const { return input_buffer; }     // Get current input buffer
     uint32_t get_input_pos() const { return input_pos; }              // Get current input position
+    const char* prompt() const { return heredoc_file ? ". " : "> "; } // Shell or here-document prompt
     
-    // Command implementations
-    void cmd_help();
-    void cmd_clear();
-    void cmd_echo();
-    void cmd_mkdir(const char* name);
-    void cmd_cd(const char* path);
-    void cmd_ls();
-    void cmd_pwd();
-    void cmd_touch(const char* name);
-    void cmd_cat(const char* name);
-    void cmd_write(const char* name, const char* content);
-    void cmd_remove(const char* name);
-    void cmd_move(const char* src, const char* dest);
-    void cmd_copy(const char* src, const char* dest);
-    void cmd_time();
-    void cmd_shutdown();
+    // Command implementations (all registered in command_table, command.cpp)
+    void cmd_help(const Command& cmd);
+    void cmd_clear(const Command& cmd);
+    void cmd_echo(const Command& cmd);
+    void cmd_mkdir(const Command& cmd);
+    void cmd_cd(const Command& cmd);
+    void cmd_ls(const Command& cmd);
+    void cmd_pwd(const Command& cmd);
+    void cmd_touch(const Command& cmd);
+    void cmd_cat(const Command& cmd);
+    void cmd_hexdump(const Command& cmd);
+    void cmd_checksum(const Command& cmd);
+    void cmd_wc(const Command& cmd);
+    void cmd_sort(const Command& cmd);
+    void cmd_uniq(const Command& cmd);
+    void cmd_head(const Command& cmd);
+    void cmd_tail(const Command& cmd);
+    void cmd_write(const Command& cmd);
+    void cmd_more(const Command& cmd);
+    void cmd_edit(const Command& cmd);
+    void cmd_remove(const Command& cmd);
+    void cmd_move(const Command& cmd);
+    void cmd_copy(const Command& cmd);
+    void cmd_time(const Command& cmd);
+    void cmd_bootinfo(const Command& cmd);
+    void cmd_boottime(const Command& cmd);
+    void cmd_params(const Command& cmd);
+    void cmd_syscallbench(const Command& cmd);
+    void cmd_exec(const Command& cmd);
+    void cmd_execbench(const Command& cmd);
+    bool run_program(const char* path, uint32_t argc, const char* const* argv);  // Load and run an ELF file
+    void cmd_pipebench(const Command& cmd);
+    void cmd_bench(const Command& cmd);
+    void cmd_jobs(const Command& cmd);
+    void cmd_fg(const Command& cmd);
+    void cmd_kill(const Command& cmd);
+    void cmd_run(const Command& cmd);
+    void cmd_test(const Command& cmd);
+    void cmd_shutdown(const Command& cmd);
+};
+
+/**
+ * Command Table Entry
+ * 
+ * Describes one built-in command. The table in command.cpp drives dispatch
+ * (through a compile-time perfect hash), argument-count checks and help.
+ */
+typedef void (CommandSystem::*CommandHandler)(const Command& cmd);
+
+struct CommandSpec {
+    const char* name;
+    uint8_t min_args;
+    uint8_t max_args;               // MAX_ARGS = any number
+    CommandHandler handler;
+    const char* usage;              // Argument synopsis, e.g. "<source> <destination>"
+    const char* help;               // One-line description
 };
 
 extern CommandSystem command_system;
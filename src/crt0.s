@@ -6,9 +6,9 @@
 # It is the first code executed after the loader transfers control to the kernel.
 #
 # Responsibilities:
-#   - Set up kernel stack
-#   - Initialize Interrupt Descriptor Table (IDT)
-#   - Set up interrupt service routines (ISRs) for exceptions and IRQs
+#   - Set up kernel stack and clear .bss
+#   - Provide the Interrupt Descriptor Table (IDT), built at assembly time,
+#     and the interrupt service routines (ISRs) for exceptions and IRQs
 #   - Load IDT and enable interrupt handling infrastructure
 #   - Call global constructors and initialization arrays
 #   - Transfer control to kernel_main() (C++ entry point)
@@ -16,14 +16,68 @@
 # Version: 1.0.1
 # ============================================================================
 
+.set BOOT_INFO_MAGIC, 0x4E494252        # Keep in sync with bootinfo.h
+.set MULTIBOOT_HEADER_MAGIC, 0x1BADB002
+.set MULTIBOOT_HEADER_FLAGS, 0x00000003 # Page-align modules, want memory info
+.set MULTIBOOT_BOOTLOADER_MAGIC, 0x2BADB002
+.set MULTIBOOT2_HEADER_MAGIC, 0xE85250D6
+.set MULTIBOOT2_BOOTLOADER_MAGIC, 0x36D76289
+.set KERNEL_LOAD_ADDR, 0x00100000       # Where _start is linked (linker.ld)
+.set KERNEL_CODE_SELECTOR, 0x08
+.set SYSCALL_VECTOR, 0x80               # Keep in sync with syscall.h
+
 .global _start
 .global idt_flush
+.global gdt_flush
+.global tss_flush
+.global isr128
+.global sysenter_entry
+.global user_enter
+.global user_return
+.global task_switch
+.global initrd_base
+.global initrd_size
+.global boot_magic
+.global boot_info_addr
 .extern kernel_main
 .extern exception_handler
 .extern irq_handler
-.extern init_idt
+.extern syscall_dispatch
+
+# ============================================================================
+# Multiboot Headers
+# ============================================================================
+# Placed right after _start by linker.ld so they sit within the first 8 KiB
+# of kernel.elf. The ELF program headers give the load address and entry point,
+# so neither header carries address fields. QEMU's -kernel only understands
+# the original Multiboot header; GRUB 2 and other loaders use Multiboot2.
+# ============================================================================
+.section .multiboot, "a"
+.align 4
+multiboot_header:
+    .long MULTIBOOT_HEADER_MAGIC
+    .long MULTIBOOT_HEADER_FLAGS
+    .long -(MULTIBOOT_HEADER_MAGIC + MULTIBOOT_HEADER_FLAGS)
+
+.align 8
+multiboot2_header:
+    .long MULTIBOOT2_HEADER_MAGIC
+    .long 0                   # Architecture: i386 protected mode
+    .long multiboot2_header_end - multiboot2_header
+    .long -(MULTIBOOT2_HEADER_MAGIC + (multiboot2_header_end - multiboot2_header))
+    .align 8
+    .short 6, 0               # Module alignment tag: page-align modules
+    .long 8
+    .align 8
+    .short 0, 0               # End tag
+    .long 8
+multiboot2_header_end:
 
-.section .text
+# _start comes first in the image: the RusticOS loader jumps to the load
+# address (linker.ld places .text._start ahead of the Multiboot headers).
+# All of crt0's code lives in this section so the IDT can be built from
+# fixed offsets to _start (see IDT_GATE).
+.section .text._start, "ax"
 .code32
 
 # ============================================================================
@@ -34,12 +88,38 @@
 #   - Switched to 32-bit protected mode
 #   - Loaded the GDT (Global Descriptor Table)
 #   - Set up segment selectors
-#   - Loaded the kernel code to address 0x00001000
+#   - Enabled A20 and copied the kernel code to address 0x00100000
+#   - Put BOOT_INFO_MAGIC in EAX and the boot information block in EBX
+# A Multiboot loader (QEMU -kernel, GRUB) leaves the same state except for
+# the GDT, with its magic in EAX and its information structure in EBX.
 # ============================================================================
 _start:
     # Disable interrupts during kernel initialization
     cli
     
+    # Keep the loader's handoff registers for kernel_main (see bootinfo.h)
+    movl %eax, boot_magic
+    movl %ebx, boot_info_addr
+    
+    # A Multiboot loader's GDT may use other selectors; the IDT built below
+    # expects the RusticOS loader's layout (code 0x08, data 0x10) until
+    # init_gdt() installs the kernel GDT
+    cmpl $MULTIBOOT_BOOTLOADER_MAGIC, %eax
+    je .multiboot_gdt
+    cmpl $MULTIBOOT2_BOOTLOADER_MAGIC, %eax
+    jne .entry_gdt_done
+.multiboot_gdt:
+    lgdt boot_gdt_ptr
+    ljmp $0x08, $.multiboot_reload
+.multiboot_reload:
+    movw $0x10, %ax
+    movw %ax, %ds
+    movw %ax, %es
+    movw %ax, %fs
+    movw %ax, %gs
+    movw %ax, %ss
+.entry_gdt_done:
+    
     # Debug marker: Write 'R' to VGA buffer to confirm kernel entry
     # This helps verify the kernel loaded correctly during development
     movl $0xb8000, %edi
@@ -54,7 +134,8 @@ _start:
     # Set Up Kernel Stack
     # ========================================================================
     # Stack grows downward from high addresses to low addresses
-    # Kernel code is loaded at 0x00001000, so we place the stack below it
+    # Kernel image is loaded at 0x00100000, so the stack sits in free
+    # conventional memory below it
     # Stack pointer: 0x00088000 (gives us plenty of stack space)
     movl $0x00088000, %esp
     andl $~0xF, %esp          # Align stack to 16-byte boundary (required by ABI)
@@ -63,16 +144,6 @@ _start:
     # movl $0x1f42, %eax   # B in green
     # movl %eax, (%edi)
 
-    # Clear .bss
-    # cld
-    # movl $__bss_start, %edi
-    # movl $__bss_end, %ecx
-    # subl %edi, %ecx
-    # jbe .after_bss
-    # xorl %eax, %eax
-    # rep stosb
-# .after_bss:
-
     # movl $0xb8002, %edi
     # movl $0x1f4d, %eax   # D in green
     # movl %eax, (%edi)
@@ -81,6 +152,47 @@ _start:
     # movl $0x1f4D, %eax   # M in green
     # movl %eax, (%edi)
 
+    # ========================================================================
+    # Relocate the Initial Ramdisk
+    # ========================================================================
+    # The loader reads the initrd right after the kernel image (next sector
+    # boundary), which is where .bss starts. Move it above .bss before any
+    # constructor touches .bss. The destination is higher than the source,
+    # so copy backwards. Multiboot loaders pass the initrd as a module
+    # instead (see multiboot.cpp).
+    cmpl $BOOT_INFO_MAGIC, boot_magic
+    jne .initrd_done
+    movl $__image_end, %esi
+    addl $511, %esi
+    andl $~511, %esi
+    cmpl $INITRD_MAGIC, (%esi)
+    jne .initrd_done
+    movl 12(%esi), %ecx       # InitrdHeader.total_size
+    movl $__initrd_start, %edi
+    movl %edi, initrd_base
+    movl %ecx, initrd_size
+    leal -1(%esi,%ecx), %esi
+    leal -1(%edi,%ecx), %edi
+    std
+    rep movsb
+    cld
+.initrd_done:
+
+    # ========================================================================
+    # Clear .bss
+    # ========================================================================
+    # The RusticOS loader copies only the flat image, so .bss holds whatever
+    # was in memory (including the initrd, moved out above). Zero it a dword
+    # at a time; rounding up stays below __initrd_start, which is page
+    # aligned. Multiboot loaders have zeroed it already.
+    movl $__bss_start, %edi
+    movl $__bss_end, %ecx
+    subl %edi, %ecx
+    addl $3, %ecx
+    shrl $2, %ecx
+    xorl %eax, %eax
+    rep stosl
+
     # Call constructors
     movl $__ctors_start, %esi
     movl $__ctors_end, %edi
@@ -130,34 +242,20 @@ _start:
     #movb $'S', (%edi)
     #movb $0x20, 1(%edi)
 
-    # Initialize IDT (this sets up the interrupt descriptor table)
-    call init_idt
-    
-    # Load IDT
+    # Load IDT (a finished table in .data, see below)
     lea idt_ptr, %eax
     lidt (%eax)
     
+    # kernel_main(magic, info_addr); keep the stack 16-byte aligned at the call
+    subl $8, %esp
+    pushl boot_info_addr
+    pushl boot_magic
     call kernel_main
 
 .hang:
     hlt
     jmp .hang
 
-# ============================================================================
-# Interrupt Descriptor Table (IDT) Setup
-# ============================================================================
-
-# IDT (exported so C++ code can access it)
-.section .data
-.align 8
-.global idt
-idt:
-    .space 256*8, 0
-.global idt_ptr
-idt_ptr:
-    .word (256*8 - 1)
-    .long idt
-
 # ============================================================================
 # Interrupt Service Routines (ISRs)
 # ============================================================================
@@ -213,7 +311,7 @@ ISR_ERRCODE 17    # Alignment Check
 ISR_NOERRCODE 18  # Machine Check
 ISR_NOERRCODE 19  # SIMD Floating-Point Exception
 ISR_NOERRCODE 20  # Virtualization Exception
-ISR_NOERRCODE 21  # Control Protection Exception
+ISR_ERRCODE 21    # Control Protection Exception
 ISR_NOERRCODE 22  # Reserved
 ISR_NOERRCODE 23  # Reserved
 ISR_NOERRCODE 24  # Reserved
@@ -221,7 +319,7 @@ ISR_NOERRCODE 25  # Reserved
 ISR_NOERRCODE 26  # Reserved
 ISR_NOERRCODE 27  # Reserved
 ISR_NOERRCODE 28  # Hypervisor Injection Exception
-ISR_NOERRCODE 29  # VMM Communication Exception
+ISR_ERRCODE 29    # VMM Communication Exception
 ISR_ERRCODE 30    # Security Exception
 ISR_NOERRCODE 31  # Reserved
 
@@ -262,14 +360,16 @@ isr_common_stub:
     movw %ax, %gs
     
     # Call C exception handler
-    # Stack layout: [gs] [fs] [es] [ds] [edi] [esi] [ebp] [esp] [ebx] [edx] [ecx] [eax] [err] [vector]
-    # Vector is at [esp + 48], error code at [esp + 44]
+    # Stack layout: [gs] [fs] [es] [ds] [edi] [esi] [ebp] [esp] [ebx] [edx] [ecx] [eax] [vector] [err] [eip] [cs]
+    # Vector is at [esp + 48], error code at [esp + 52], faulting EIP/CS at [esp + 56]/[esp + 60]
     movl 48(%esp), %eax  # Get vector number
-    movl 44(%esp), %edx  # Get error code
+    movl 52(%esp), %edx  # Get error code
+    pushl 60(%esp)       # Push faulting CS (tells the handler whether ring 3 faulted)
+    pushl 60(%esp)       # Push faulting EIP (offsets shifted by the previous push)
     pushl %edx           # Push error code
     pushl %eax           # Push vector
     call exception_handler
-    addl $8, %esp
+    addl $16, %esp
     
     # Restore segment registers
     popl %gs
@@ -305,12 +405,15 @@ irq_common_stub:
     movw %ax, %gs
     
     # Call C IRQ handler
-    # Stack layout: [gs] [fs] [es] [ds] [edi] [esi] [ebp] [esp] [ebx] [edx] [ecx] [eax] [err] [irq]
-    # IRQ number is at [esp + 48] (48 = 16 bytes for pusha + 16 bytes for segment regs + 16 bytes for err/irq)
+    # Stack layout: [gs] [fs] [es] [ds] [edi] [esi] [ebp] [esp] [ebx] [edx] [ecx] [eax] [irq] [err] [eip] [cs]
+    # IRQ number is at [esp + 48] (16 bytes of segment regs + 32 bytes for pusha)
+    # and the interrupted CS at [esp + 60]
     movl 48(%esp), %eax  # Get IRQ number from stack
+    movl 60(%esp), %ecx  # Interrupted code segment (RPL 3 = user mode)
+    pushl %ecx           # Push CS as second argument
     pushl %eax           # Push IRQ number as argument
     call irq_handler
-    addl $4, %esp        # Remove argument
+    addl $8, %esp        # Remove arguments
     
     # Restore segment registers
     popl %gs
@@ -334,6 +437,275 @@ idt_flush:
     lidt (%eax)
     ret
 
+# ============================================================================
+# GDT / TSS Loading
+# ============================================================================
+
+# void gdt_flush(const void* gdt_ptr) - load the kernel GDT and reload segments
+gdt_flush:
+    movl 4(%esp), %eax
+    lgdt (%eax)
+    movw $0x10, %ax      # Kernel data selector
+    movw %ax, %ds
+    movw %ax, %es
+    movw %ax, %fs
+    movw %ax, %gs
+    movw %ax, %ss
+    ljmp $0x08, $.gdt_flush_cs   # Reload CS with the kernel code selector
+.gdt_flush_cs:
+    ret
+
+# void tss_flush(uint16_t selector) - load the task register
+tss_flush:
+    movl 4(%esp), %eax
+    ltr %ax
+    ret
+
+# ============================================================================
+# System Call Entry Points
+# ============================================================================
+# Both stubs build a PUSHA frame (struct SyscallFrame), switch to kernel data
+# segments and call syscall_dispatch(frame). The handler stores its return
+# value in frame->eax, which POPA hands back to user mode.
+
+# INT 0x80 (fallback path, DPL 3 interrupt gate)
+isr128:
+    pusha
+    pushl %ds
+    pushl %es
+    movw $0x10, %ax
+    movw %ax, %ds
+    movw %ax, %es
+    sti                  # Interrupt gate cleared IF; system calls run interruptible
+    leal 8(%esp), %eax   # SyscallFrame* (skip saved es/ds)
+    pushl %eax
+    call syscall_dispatch
+    addl $4, %esp
+    popl %es
+    popl %ds
+    popa
+    iret
+
+# SYSENTER (fast path)
+# On entry: CS/SS = kernel selectors, ESP = IA32_SYSENTER_ESP, IF = 0.
+# The user trampoline passes its stack pointer in ECX and its resume address
+# in EDX, exactly the registers SYSEXIT consumes, so POPA restores both.
+sysenter_entry:
+    pusha
+    pushl %ds
+    pushl %es
+    movw $0x10, %ax
+    movw %ax, %ds
+    movw %ax, %es
+    sti
+    leal 8(%esp), %eax
+    pushl %eax
+    call syscall_dispatch
+    addl $4, %esp
+    cli
+    popl %es
+    popl %ds
+    popa
+    sti                  # Takes effect after SYSEXIT (interrupt shadow)
+    sysexit
+
+# ============================================================================
+# User Mode Entry / Exit
+# ============================================================================
+
+# int32_t user_enter(uint32_t entry, uint32_t user_esp, uint32_t* kernel_context)
+# Saves the callee-saved registers and the kernel ESP, then IRETs to ring 3.
+# Returns (via user_return) with the process exit status in EAX.
+user_enter:
+    pushl %ebp
+    pushl %ebx
+    pushl %esi
+    pushl %edi
+    movl 20(%esp), %ecx  # entry
+    movl 24(%esp), %edx  # user_esp
+    movl 28(%esp), %eax  # kernel_context
+    movl %esp, (%eax)
+
+    movw $0x23, %ax      # User data selector (RPL 3)
+    movw %ax, %ds
+    movw %ax, %es
+    movw %ax, %fs
+    movw %ax, %gs
+
+    pushl $0x23          # SS
+    pushl %edx           # ESP
+    pushl $0x202         # EFLAGS (IF set)
+    pushl $0x1B          # CS (user code, RPL 3)
+    pushl %ecx           # EIP
+    xorl %eax, %eax      # Do not leak kernel register contents
+    xorl %ebx, %ebx
+    xorl %ecx, %ecx
+    xorl %edx, %edx
+    xorl %esi, %esi
+    xorl %edi, %edi
+    xorl %ebp, %ebp
+    iret
+
+# void user_return(uint32_t kernel_context, int32_t status)
+# Abandons the current (process kernel) stack and resumes user_enter's caller.
+user_return:
+    movl 8(%esp), %eax   # status (becomes user_enter's return value)
+    movl 4(%esp), %esp   # Kernel ESP saved by user_enter
+    movw $0x10, %cx
+    movw %cx, %ds
+    movw %cx, %es
+    movw %cx, %fs
+    movw %cx, %gs
+    popl %edi
+    popl %esi
+    popl %ebx
+    popl %ebp
+    ret
+
+# ============================================================================
+# Kernel Task Switch
+# ============================================================================
+
+# void task_switch(uint32_t* old_esp, uint32_t new_esp)
+# Saves the callee-saved registers and EFLAGS on the current stack, stores
+# ESP in *old_esp and resumes the task whose stack pointer is new_esp. A new
+# task's stack is prepared by task_create() to "return" into task_start.
+# EFLAGS is per task: a task switched out from the timer interrupt (IF
+# clear) must not make the next task run with interrupts disabled.
+task_switch:
+    movl 4(%esp), %eax   # old_esp
+    movl 8(%esp), %edx   # new_esp
+    pushl %ebp
+    pushl %ebx
+    pushl %esi
+    pushl %edi
+    pushfl
+    movl %esp, (%eax)
+    movl %edx, %esp
+    popfl
+    popl %edi
+    popl %esi
+    popl %ebx
+    popl %ebp
+    ret
+
+# ============================================================================
+# User-Mode Code Blobs (copied into user pages, must be position independent)
+# ============================================================================
+.set USER_VSYSCALL_ADDR, 0x403FF000    # Keep in sync with process.h
+.set SYS_EXIT_NR, 1                    # Keep in sync with syscall.h
+.set INITRD_MAGIC, 0x44524952          # Keep in sync with initrd.h
+
+.section .rodata
+.global vsyscall_sysenter_start
+.global vsyscall_sysenter_end
+.global vsyscall_int80_start
+.global vsyscall_int80_end
+.global user_bench_start
+.global user_bench_end
+
+# System call trampoline (SYSENTER variant), mapped at USER_VSYSCALL_ADDR
+vsyscall_sysenter_start:
+    pushl %ecx
+    pushl %edx
+    movl %esp, %ecx                      # SYSEXIT restores ESP from ECX
+    movl $(USER_VSYSCALL_ADDR + (.vsys_resume - vsyscall_sysenter_start)), %edx
+    sysenter
+.vsys_resume:
+    popl %edx
+    popl %ecx
+    ret
+vsyscall_sysenter_end:
+
+# System call trampoline (INT 0x80 variant)
+vsyscall_int80_start:
+    int $0x80
+    ret
+vsyscall_int80_end:
+
+# Null system call round-trip benchmark
+# User stack on entry: [esp] = iterations, [esp + 4] = 0 (trampoline) / 1 (INT 0x80)
+# Exits with status 0; the kernel times the whole run with the TSC.
+user_bench_start:
+    movl (%esp), %ecx
+    movl 4(%esp), %ebp
+.bench_loop:
+    xorl %eax, %eax                      # SYS_NULL
+    testl %ebp, %ebp
+    jnz .bench_int80
+    movl $USER_VSYSCALL_ADDR, %edx
+    call *%edx
+    jmp .bench_next
+.bench_int80:
+    int $0x80
+.bench_next:
+    decl %ecx
+    jnz .bench_loop
+    xorl %ebx, %ebx                      # exit(0)
+    movl $SYS_EXIT_NR, %eax
+    int $0x80
+user_bench_end:
+
+.section .data
+
+# ============================================================================
+# Interrupt Descriptor Table (IDT)
+# ============================================================================
+# Every gate is emitted here at assembly time, so startup only runs LIDT.
+# A handler's address is KERNEL_LOAD_ADDR plus its (constant) distance from
+# _start in .text._start; linker.ld asserts that _start is linked there.
+# Vectors 0-31 are exceptions, 32-47 the remapped PIC IRQs and
+# SYSCALL_VECTOR the INT 0x80 fallback (DPL 3); all others are not present.
+
+# IDT_GATE handler, type - one 8-byte interrupt gate
+.macro IDT_GATE handler, type
+    .word (KERNEL_LOAD_ADDR + (\handler - _start)) & 0xFFFF
+    .word KERNEL_CODE_SELECTOR
+    .byte 0, \type
+    .word (KERNEL_LOAD_ADDR + (\handler - _start)) >> 16
+.endm
+
+.align 8
+.global idt
+idt:
+    .irp n, 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31
+    IDT_GATE isr\n, 0x8E          # Present, ring 0, 32-bit interrupt gate
+    .endr
+    .irp n, 32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47
+    IDT_GATE irq\n, 0x8E
+    .endr
+    .fill SYSCALL_VECTOR - 48, 8, 0
+    IDT_GATE isr128, 0xEE         # Present, ring 3 may call it
+    .fill 256 - SYSCALL_VECTOR - 1, 8, 0
+.global idt_ptr
+idt_ptr:
+    .word (256*8 - 1)
+    .long idt
+
+# Initial ramdisk location after relocation (see _start); read by initrd.cpp
+.align 4
+initrd_base:
+    .long 0
+initrd_size:
+    .long 0
+
+# Flat code (0x08) and data (0x10) segments, loaded on Multiboot entry
+.align 8
+boot_gdt:
+    .quad 0
+    .quad 0x00CF9A000000FFFF
+    .quad 0x00CF92000000FFFF
+boot_gdt_ptr:
+    .word boot_gdt_ptr - boot_gdt - 1
+    .long boot_gdt
+
+# Loader handoff registers (see _start); passed on to kernel_main
+.align 4
+boot_magic:
+    .long 0
+boot_info_addr:
+    .long 0
+
 # Serial message used by early kernel trace
 .align 1
 serial_msg:
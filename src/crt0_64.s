@@ -0,0 +1,778 @@
+# ============================================================================
+# RusticOS - 64-bit Kernel Startup (crt0_64.s)
+# ============================================================================
+#
+# The x86-64 counterpart of crt0.s, linked instead of it by
+# `make ARCH=x86_64`. Both the RusticOS loader and Multiboot loaders still
+# enter _start in 32-bit protected mode, so the first part of this file is
+# 32-bit code that switches the CPU to long mode before anything else runs.
+#
+# Responsibilities:
+#   - Set up the kernel stack, relocate the initrd and clear .bss (as crt0.s)
+#   - Build boot page tables identity-mapping the first 4 GiB with 2 MiB
+#     pages, enable PAE, SSE, long mode and paging, and load a 64-bit GDT
+#   - Provide the 64-bit IDT (built at assembly time) and the interrupt
+#     service routines, which also save the SSE state
+#   - Call global constructors and transfer control to kernel_main()
+#   - Provide the 64-bit system call, user-mode entry and task switch
+#     helpers; user programs stay 32-bit and run in compatibility mode
+#
+# Version: 1.0.1
+# ============================================================================
+
+.set BOOT_INFO_MAGIC, 0x4E494252        # Keep in sync with bootinfo.h
+.set MULTIBOOT_HEADER_MAGIC, 0x1BADB002
+.set MULTIBOOT_HEADER_FLAGS, 0x00000003 # Page-align modules, want memory info
+.set MULTIBOOT2_HEADER_MAGIC, 0xE85250D6
+.set KERNEL_LOAD_ADDR, 0x00100000       # Where _start is linked (linker64.ld)
+.set KERNEL_CODE_SELECTOR, 0x08         # 64-bit code (gdt.h)
+.set KERNEL_DATA_SELECTOR, 0x10
+.set SYSCALL_VECTOR, 0x80               # Keep in sync with syscall.h
+.set MSR_EFER, 0xC0000080
+.set EFER_LME, 0x100                    # Long mode enable
+.set CR0_PG, 0x80000000
+.set CR0_EM, 0x4
+.set CR0_MP, 0x2
+.set CR4_PAE, 0x20
+.set CR4_OSFXSR, 0x200                  # FXSAVE/FXRSTOR and SSE instructions
+.set CR4_OSXMMEXCPT, 0x400              # SIMD exceptions raise #XM
+.set BOOT_PAGE_FLAGS, 0x83              # Present, writable, 2 MiB page
+.set BOOT_TABLE_FLAGS, 0x03             # Present, writable
+
+# Offsets of the registers saved by SAVE_REGS (from the lowest address)
+.set REG_RDI, 64
+.set REG_RSI, 72
+.set REG_RBP, 80
+.set REG_RBX, 88
+.set REG_RDX, 96
+.set REG_RCX, 104
+.set REG_RAX, 112
+.set REG_VECTOR, 120                    # Pushed by the ISR/IRQ stubs
+.set REG_ERROR, 128
+.set REG_RIP, 136                       # Pushed by the CPU
+.set REG_CS, 144
+
+.global _start
+.global idt_flush
+.global gdt_flush
+.global tss_flush
+.global isr128
+.global sysenter_entry
+.global user_enter
+.global user_return
+.global task_switch
+.global initrd_base
+.global initrd_size
+.global boot_magic
+.global boot_info_addr
+.extern kernel_main
+.extern exception_handler
+.extern irq_handler
+.extern syscall_dispatch
+
+# ============================================================================
+# Multiboot Headers
+# ============================================================================
+# The same headers as crt0.s. GRUB 2 loads the ELF64 kernel through
+# Multiboot2; QEMU's -kernel only takes ELF32, so `make run-kernel` hands it
+# a copy of kernel.elf converted with objcopy (the entry code is 32-bit).
+# ============================================================================
+.section .multiboot, "a"
+.align 4
+multiboot_header:
+    .long MULTIBOOT_HEADER_MAGIC
+    .long MULTIBOOT_HEADER_FLAGS
+    .long -(MULTIBOOT_HEADER_MAGIC + MULTIBOOT_HEADER_FLAGS)
+
+.align 8
+multiboot2_header:
+    .long MULTIBOOT2_HEADER_MAGIC
+    .long 0                   # Architecture: i386 protected mode
+    .long multiboot2_header_end - multiboot2_header
+    .long -(MULTIBOOT2_HEADER_MAGIC + (multiboot2_header_end - multiboot2_header))
+    .align 8
+    .short 6, 0               # Module alignment tag: page-align modules
+    .long 8
+    .align 8
+    .short 0, 0               # End tag
+    .long 8
+multiboot2_header_end:
+
+# _start comes first in the image, and all of this file's code lives in
+# .text._start so the IDT can be built from fixed offsets to _start (see
+# IDT_GATE and linker64.ld).
+.section .text._start, "ax"
+.code32
+
+# ============================================================================
+# Kernel Entry Point (_start, 32-bit)
+# ============================================================================
+# Entered in 32-bit protected mode with paging off, BOOT_INFO_MAGIC or a
+# Multiboot magic in EAX and the information block in EBX (see crt0.s).
+# ============================================================================
+_start:
+    cli
+
+    # Keep the loader's handoff registers for kernel_main (see bootinfo.h)
+    movl %eax, boot_magic
+    movl %ebx, boot_info_addr
+
+    # Own GDT from here on: its 64-bit code segment is entered below, and the
+    # flat data segment replaces whatever the loader left in the data registers
+    lgdt boot_gdt_ptr
+    movw $KERNEL_DATA_SELECTOR, %ax
+    movw %ax, %ds
+    movw %ax, %es
+    movw %ax, %fs
+    movw %ax, %gs
+    movw %ax, %ss
+
+    # Debug marker: 'R' in the top-left corner of the VGA text buffer
+    movl $0xb8000, %edi
+    movl $0x1f52, %eax
+    movl %eax, (%edi)
+
+    # Kernel stack in free conventional memory below the image (as crt0.s)
+    movl $0x00088000, %esp
+
+    # Long mode needs CPUID.80000001h:EDX bit 29
+    movl $0x80000000, %eax
+    cpuid
+    cmpl $0x80000001, %eax
+    jb .no_long_mode
+    movl $0x80000001, %eax
+    cpuid
+    btl $29, %edx
+    jnc .no_long_mode
+
+    # ========================================================================
+    # Relocate the Initial Ramdisk / Clear .bss
+    # ========================================================================
+    # Exactly as in crt0.s: the RusticOS loader puts the initrd where .bss
+    # starts, so move it above .bss (copying backwards) before zeroing .bss.
+    cmpl $BOOT_INFO_MAGIC, boot_magic
+    jne .initrd_done
+    movl $__image_end, %esi
+    addl $511, %esi
+    andl $~511, %esi
+    cmpl $INITRD_MAGIC, (%esi)
+    jne .initrd_done
+    movl 12(%esi), %ecx       # InitrdHeader.total_size
+    movl $__initrd_start, %edi
+    movl %edi, initrd_base
+    movl %ecx, initrd_size
+    leal -1(%esi,%ecx), %esi
+    leal -1(%edi,%ecx), %edi
+    std
+    rep movsb
+    cld
+.initrd_done:
+
+    movl $__bss_start, %edi
+    movl $__bss_end, %ecx
+    subl %edi, %ecx
+    addl $3, %ecx
+    shrl $2, %ecx
+    xorl %eax, %eax
+    rep stosl
+
+    # ========================================================================
+    # Boot Page Tables
+    # ========================================================================
+    # One PML4 entry -> one PDPT with four entries -> four page directories
+    # of 2 MiB pages: the first 4 GiB identity mapped, so everything the
+    # 32-bit kernel could reach before init_paging() stays reachable.
+    # init_paging() replaces these tables with the kernel's own.
+    movl $boot_pdpt + BOOT_TABLE_FLAGS, boot_pml4
+    movl $boot_pdpt, %edi
+    movl $boot_pd + BOOT_TABLE_FLAGS, %eax
+    movl $4, %ecx
+.fill_pdpt:
+    movl %eax, (%edi)
+    addl $0x1000, %eax
+    addl $8, %edi
+    loop .fill_pdpt
+
+    movl $boot_pd, %edi
+    movl $BOOT_PAGE_FLAGS, %eax
+    xorl %edx, %edx           # Physical address bits 63:32
+    movl $(4 * 512), %ecx
+.fill_pd:
+    movl %eax, (%edi)
+    movl %edx, 4(%edi)
+    addl $0x200000, %eax
+    adcl $0, %edx
+    addl $8, %edi
+    loop .fill_pd
+
+    # ========================================================================
+    # Enter Long Mode
+    # ========================================================================
+    # PAE and SSE in CR4, the boot tables in CR3, EFER.LME, then CR0.PG
+    # activates long mode (compatibility mode until CS is reloaded).
+    movl %cr4, %eax
+    orl $(CR4_PAE | CR4_OSFXSR | CR4_OSXMMEXCPT), %eax
+    movl %eax, %cr4
+
+    movl $boot_pml4, %eax
+    movl %eax, %cr3
+
+    movl $MSR_EFER, %ecx
+    rdmsr
+    orl $EFER_LME, %eax
+    wrmsr
+
+    movl %cr0, %eax
+    andl $~CR0_EM, %eax       # SSE needs the FPU present ..
+    orl $(CR0_PG | CR0_MP), %eax   # .. and WAIT/FWAIT honouring TS
+    movl %eax, %cr0
+
+    ljmp $KERNEL_CODE_SELECTOR, $.long_mode
+
+.no_long_mode:
+    movl $no_long_mode_msg, %esi
+    movl $0xb8000, %edi
+    movb $0x4f, %ah           # White on red
+.no_long_mode_char:
+    lodsb
+    testb %al, %al
+    jz .hang32
+    stosw
+    jmp .no_long_mode_char
+.hang32:
+    hlt
+    jmp .hang32
+
+.code64
+.long_mode:
+    movw $KERNEL_DATA_SELECTOR, %ax
+    movw %ax, %ds
+    movw %ax, %es
+    movw %ax, %fs
+    movw %ax, %gs
+    movw %ax, %ss
+    movq $0x00088000, %rsp    # 16-byte aligned for the calls below
+
+    # Call constructors (8-byte pointers; RBX/R12 survive the calls)
+    movq $__ctors_start, %rbx
+    movq $__ctors_end, %r12
+.ctors_loop:
+    cmpq %r12, %rbx
+    jae .ctors_done
+    call *(%rbx)
+    addq $8, %rbx
+    jmp .ctors_loop
+.ctors_done:
+
+    # Call init_array
+    movq $__init_array_start, %rbx
+    movq $__init_array_end, %r12
+.init_loop:
+    cmpq %r12, %rbx
+    jae .init_done
+    call *(%rbx)
+    addq $8, %rbx
+    jmp .init_loop
+.init_done:
+
+    # Load IDT (a finished table in .data, see below)
+    lidt idt_ptr
+
+    # kernel_main(magic, info_addr)
+    movl boot_magic, %edi
+    movl boot_info_addr, %esi
+    call kernel_main
+
+.hang:
+    hlt
+    jmp .hang
+
+# ============================================================================
+# Interrupt Service Routines (ISRs)
+# ============================================================================
+# The CPU pushes SS, RSP, RFLAGS, CS and RIP (8 bytes each, after aligning
+# RSP to 16) and, for some exceptions, an error code. The stubs push a dummy
+# error code where needed and the vector, so every handler sees the same
+# frame. Kernel code may use SSE registers (x86-64 baseline), so the common
+# stubs save them with FXSAVE as well.
+
+# Push / pop every general-purpose register (see the REG_* offsets)
+.macro SAVE_REGS
+    pushq %rax
+    pushq %rcx
+    pushq %rdx
+    pushq %rbx
+    pushq %rbp
+    pushq %rsi
+    pushq %rdi
+    pushq %r8
+    pushq %r9
+    pushq %r10
+    pushq %r11
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+.endm
+
+.macro RESTORE_REGS
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %r11
+    popq %r10
+    popq %r9
+    popq %r8
+    popq %rdi
+    popq %rsi
+    popq %rbp
+    popq %rbx
+    popq %rdx
+    popq %rcx
+    popq %rax
+.endm
+
+# Save the SSE state below the saved registers; RBX keeps the register area
+.macro SAVE_SSE
+    movq %rsp, %rbx
+    subq $512, %rsp
+    andq $~0xF, %rsp
+    fxsave (%rsp)
+.endm
+
+.macro RESTORE_SSE
+    fxrstor (%rsp)
+    movq %rbx, %rsp
+.endm
+
+# Macro to create ISR stub without error code
+.macro ISR_NOERRCODE num
+    .global isr\num
+    isr\num:
+        pushq $0              # Push dummy error code
+        pushq $\num           # Push interrupt number
+        jmp isr_common_stub
+.endm
+
+# Macro to create ISR stub with error code
+.macro ISR_ERRCODE num
+    .global isr\num
+    isr\num:
+        pushq $\num           # Push interrupt number (error code already on stack)
+        jmp isr_common_stub
+.endm
+
+# Macro to create IRQ stub
+.macro IRQ num, irq_num
+    .global irq\num
+    irq\num:
+        pushq $0              # Push dummy error code
+        pushq $\irq_num       # Push IRQ number
+        jmp irq_common_stub
+.endm
+
+# Create ISR stubs for exceptions (0-31)
+ISR_NOERRCODE 0   # Divide by Zero
+ISR_NOERRCODE 1   # Debug
+ISR_NOERRCODE 2   # Non-Maskable Interrupt
+ISR_NOERRCODE 3   # Breakpoint
+ISR_NOERRCODE 4   # Overflow
+ISR_NOERRCODE 5   # Bound Range Exceeded
+ISR_NOERRCODE 6   # Invalid Opcode
+ISR_NOERRCODE 7   # Device Not Available
+ISR_ERRCODE 8     # Double Fault
+ISR_NOERRCODE 9   # Coprocessor Segment Overrun
+ISR_ERRCODE 10    # Invalid TSS
+ISR_ERRCODE 11    # Segment Not Present
+ISR_ERRCODE 12    # Stack Fault
+ISR_ERRCODE 13    # General Protection Fault
+ISR_ERRCODE 14    # Page Fault
+ISR_NOERRCODE 15  # Reserved
+ISR_NOERRCODE 16  # x87 FPU Floating-Point Error
+ISR_ERRCODE 17    # Alignment Check
+ISR_NOERRCODE 18  # Machine Check
+ISR_NOERRCODE 19  # SIMD Floating-Point Exception
+ISR_NOERRCODE 20  # Virtualization Exception
+ISR_ERRCODE 21    # Control Protection Exception
+ISR_NOERRCODE 22  # Reserved
+ISR_NOERRCODE 23  # Reserved
+ISR_NOERRCODE 24  # Reserved
+ISR_NOERRCODE 25  # Reserved
+ISR_NOERRCODE 26  # Reserved
+ISR_NOERRCODE 27  # Reserved
+ISR_NOERRCODE 28  # Hypervisor Injection Exception
+ISR_ERRCODE 29    # VMM Communication Exception
+ISR_ERRCODE 30    # Security Exception
+ISR_NOERRCODE 31  # Reserved
+
+# Create IRQ stubs for hardware interrupts (32-47)
+IRQ 32, 0   # Timer
+IRQ 33, 1   # Keyboard
+IRQ 34, 2   # Cascade
+IRQ 35, 3   # COM2
+IRQ 36, 4   # COM1
+IRQ 37, 5   # LPT2
+IRQ 38, 6   # Floppy
+IRQ 39, 7   # LPT1
+IRQ 40, 8   # CMOS
+IRQ 41, 9   # Free
+IRQ 42, 10  # Free
+IRQ 43, 11  # Free
+IRQ 44, 12  # PS/2 Mouse
+IRQ 45, 13  # FPU
+IRQ 46, 14  # Primary ATA
+IRQ 47, 15  # Secondary ATA
+
+# Common exception handler stub
+# exception_handler(vector, error code, faulting RIP, faulting CS)
+isr_common_stub:
+    SAVE_REGS
+    SAVE_SSE
+    movq REG_VECTOR(%rbx), %rdi
+    movq REG_ERROR(%rbx), %rsi
+    movq REG_RIP(%rbx), %rdx
+    movq REG_CS(%rbx), %rcx   # Tells the handler whether ring 3 faulted
+    call exception_handler
+    RESTORE_SSE
+    RESTORE_REGS
+    addq $16, %rsp            # Remove error code and interrupt number
+    iretq
+
+# Common IRQ handler stub
+# irq_handler(irq, interrupted CS)
+irq_common_stub:
+    SAVE_REGS
+    SAVE_SSE
+    movq REG_VECTOR(%rbx), %rdi
+    movq REG_CS(%rbx), %rsi   # RPL 3 = user mode
+    call irq_handler
+    RESTORE_SSE
+    RESTORE_REGS
+    addq $16, %rsp            # Remove error code and IRQ number
+    iretq
+
+# Load IDT function
+idt_flush:
+    lidt (%rdi)
+    ret
+
+# ============================================================================
+# GDT / TSS Loading
+# ============================================================================
+
+# void gdt_flush(const void* gdt_ptr) - load the kernel GDT and reload segments
+gdt_flush:
+    lgdt (%rdi)
+    movw $KERNEL_DATA_SELECTOR, %ax
+    movw %ax, %ds
+    movw %ax, %es
+    movw %ax, %fs
+    movw %ax, %gs
+    movw %ax, %ss
+    pushq $KERNEL_CODE_SELECTOR   # Reload CS with a far return
+    leaq .gdt_flush_cs(%rip), %rax
+    pushq %rax
+    lretq
+.gdt_flush_cs:
+    ret
+
+# void tss_flush(uint16_t selector) - load the task register
+tss_flush:
+    ltr %di
+    ret
+
+# ============================================================================
+# System Call Entry Points
+# ============================================================================
+# Both stubs save all registers, copy the 32-bit values into a struct
+# SyscallFrame (PUSHA layout, see syscall.h) and call syscall_dispatch(frame).
+# The frame's eax becomes the caller's return value; everything else is
+# restored from the saved registers. INT 0x80 also comes from kernel code
+# (the bench command), which relies on every other register surviving.
+
+# Build the SyscallFrame below the saved state (RBX = saved registers)
+.macro SYSCALL_FRAME
+    subq $32, %rsp
+    movl REG_RDI(%rbx), %eax
+    movl %eax, 0(%rsp)
+    movl REG_RSI(%rbx), %eax
+    movl %eax, 4(%rsp)
+    movl REG_RBP(%rbx), %eax
+    movl %eax, 8(%rsp)
+    movl $0, 12(%rsp)         # esp_unused
+    movl REG_RBX(%rbx), %eax
+    movl %eax, 16(%rsp)
+    movl REG_RDX(%rbx), %eax
+    movl %eax, 20(%rsp)
+    movl REG_RCX(%rbx), %eax
+    movl %eax, 24(%rsp)
+    movl REG_RAX(%rbx), %eax
+    movl %eax, 28(%rsp)
+    movq %rsp, %rdi
+.endm
+
+# Hand frame->eax back (zero-extended) and drop the frame
+.macro SYSCALL_RESULT
+    movl 28(%rsp), %eax
+    movq %rax, REG_RAX(%rbx)
+    addq $32, %rsp
+.endm
+
+# INT 0x80 (fallback path, DPL 3 interrupt gate)
+isr128:
+    SAVE_REGS
+    SAVE_SSE
+    SYSCALL_FRAME
+    sti                       # Interrupt gate cleared IF; system calls run interruptible
+    call syscall_dispatch
+    cli
+    SYSCALL_RESULT
+    RESTORE_SSE
+    RESTORE_REGS
+    iretq
+
+# SYSENTER (fast path, Intel CPUs only in long mode; see syscall.cpp)
+# On entry: CS/SS = kernel selectors, RSP = IA32_SYSENTER_ESP, IF = 0.
+# The user trampoline passes its stack pointer in ECX and its resume address
+# in EDX; SYSEXIT without REX.W returns to compatibility mode with
+# ESP = ECX and EIP = EDX, both restored from the saved registers.
+sysenter_entry:
+    SAVE_REGS
+    SAVE_SSE
+    SYSCALL_FRAME
+    sti
+    call syscall_dispatch
+    cli
+    SYSCALL_RESULT
+    RESTORE_SSE
+    RESTORE_REGS
+    sti                       # Takes effect after SYSEXIT (interrupt shadow)
+    sysexitl                  # Non-REX form: back to 32-bit code
+
+# ============================================================================
+# User Mode Entry / Exit
+# ============================================================================
+
+# int32_t user_enter(uint32_t entry, uint32_t user_esp, uintptr_t* kernel_context)
+# Saves the callee-saved registers and the kernel RSP, then IRETs to the
+# 32-bit user code segment (compatibility mode, ring 3).
+# Returns (via user_return) with the process exit status in EAX.
+user_enter:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    movq %rsp, (%rdx)
+    movl %edi, %ecx           # entry (zero-extended)
+    movl %esi, %edx           # user_esp
+
+    movw $0x23, %ax           # User data selector (RPL 3)
+    movw %ax, %ds
+    movw %ax, %es
+    movw %ax, %fs
+    movw %ax, %gs
+
+    pushq $0x23               # SS
+    pushq %rdx                # RSP
+    pushq $0x202              # RFLAGS (IF set)
+    pushq $0x1B               # CS (32-bit user code, RPL 3)
+    pushq %rcx                # RIP
+    xorl %eax, %eax           # Do not leak kernel register contents
+    xorl %ebx, %ebx
+    xorl %ecx, %ecx
+    xorl %edx, %edx
+    xorl %esi, %esi
+    xorl %edi, %edi
+    xorl %ebp, %ebp
+    xorl %r8d, %r8d
+    xorl %r9d, %r9d
+    xorl %r10d, %r10d
+    xorl %r11d, %r11d
+    xorl %r12d, %r12d
+    xorl %r13d, %r13d
+    xorl %r14d, %r14d
+    xorl %r15d, %r15d
+    iretq
+
+# void user_return(uintptr_t kernel_context, int32_t status)
+# Abandons the current (process kernel) stack and resumes user_enter's caller.
+user_return:
+    movl %esi, %eax           # status (becomes user_enter's return value)
+    movq %rdi, %rsp           # Kernel RSP saved by user_enter
+    movw $KERNEL_DATA_SELECTOR, %cx
+    movw %cx, %ds
+    movw %cx, %es
+    movw %cx, %fs
+    movw %cx, %gs
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+
+# ============================================================================
+# Kernel Task Switch
+# ============================================================================
+
+# void task_switch(uintptr_t* old_esp, uintptr_t new_esp)
+# As in crt0.s, with the x86-64 callee-saved registers and RFLAGS; the
+# initial frame of a new task is built by task_create().
+task_switch:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    pushfq
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    popfq
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+
+# ============================================================================
+# User-Mode Code Blobs (32-bit, copied into user pages)
+# ============================================================================
+# Identical to the ones in crt0.s: user programs are the same 32-bit code on
+# both builds.
+.set USER_VSYSCALL_ADDR, 0x403FF000    # Keep in sync with process.h
+.set SYS_EXIT_NR, 1                    # Keep in sync with syscall.h
+.set INITRD_MAGIC, 0x44524952          # Keep in sync with initrd.h
+
+.section .rodata
+.global vsyscall_sysenter_start
+.global vsyscall_sysenter_end
+.global vsyscall_int80_start
+.global vsyscall_int80_end
+.global user_bench_start
+.global user_bench_end
+.code32
+
+# System call trampoline (SYSENTER variant), mapped at USER_VSYSCALL_ADDR
+vsyscall_sysenter_start:
+    pushl %ecx
+    pushl %edx
+    movl %esp, %ecx                      # SYSEXIT restores ESP from ECX
+    movl $(USER_VSYSCALL_ADDR + (.vsys_resume - vsyscall_sysenter_start)), %edx
+    sysenter
+.vsys_resume:
+    popl %edx
+    popl %ecx
+    ret
+vsyscall_sysenter_end:
+
+# System call trampoline (INT 0x80 variant)
+vsyscall_int80_start:
+    int $0x80
+    ret
+vsyscall_int80_end:
+
+# Null system call round-trip benchmark
+# User stack on entry: [esp] = iterations, [esp + 4] = 0 (trampoline) / 1 (INT 0x80)
+# Exits with status 0; the kernel times the whole run with the TSC.
+user_bench_start:
+    movl (%esp), %ecx
+    movl 4(%esp), %ebp
+.bench_loop:
+    xorl %eax, %eax                      # SYS_NULL
+    testl %ebp, %ebp
+    jnz .bench_int80
+    movl $USER_VSYSCALL_ADDR, %edx
+    call *%edx
+    jmp .bench_next
+.bench_int80:
+    int $0x80
+.bench_next:
+    decl %ecx
+    jnz .bench_loop
+    xorl %ebx, %ebx                      # exit(0)
+    movl $SYS_EXIT_NR, %eax
+    int $0x80
+user_bench_end:
+
+no_long_mode_msg:
+    .asciz "RusticOS x86-64: this CPU does not support long mode"
+.code64
+
+.section .data
+
+# ============================================================================
+# Interrupt Descriptor Table (IDT)
+# ============================================================================
+# Every gate is emitted here at assembly time, so startup only runs LIDT.
+# A handler's address is KERNEL_LOAD_ADDR plus its (constant) distance from
+# _start in .text._start; linker64.ld asserts that _start is linked there.
+# Vectors 0-31 are exceptions, 32-47 the remapped PIC IRQs and
+# SYSCALL_VECTOR the INT 0x80 fallback (DPL 3); all others are not present.
+
+# IDT_GATE handler, type - one 16-byte long-mode interrupt gate
+.macro IDT_GATE handler, type
+    .word (KERNEL_LOAD_ADDR + (\handler - _start)) & 0xFFFF
+    .word KERNEL_CODE_SELECTOR
+    .byte 0, \type                # No interrupt stack table entry
+    .word (KERNEL_LOAD_ADDR + (\handler - _start)) >> 16
+    .long 0                       # Offset bits 63:32 (the kernel is below 4 GiB)
+    .long 0
+.endm
+
+.align 16
+.global idt
+idt:
+    .irp n, 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31
+    IDT_GATE isr\n, 0x8E          # Present, ring 0, 64-bit interrupt gate
+    .endr
+    .irp n, 32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47
+    IDT_GATE irq\n, 0x8E
+    .endr
+    .fill (SYSCALL_VECTOR - 48) * 2, 8, 0
+    IDT_GATE isr128, 0xEE         # Present, ring 3 may call it
+    .fill (256 - SYSCALL_VECTOR - 1) * 2, 8, 0
+.global idt_ptr
+idt_ptr:
+    .word (256*16 - 1)
+    .quad idt
+
+# Initial ramdisk location after relocation (see _start); read by initrd.cpp
+.align 4
+initrd_base:
+    .long 0
+initrd_size:
+    .long 0
+
+# Boot GDT: null, 64-bit code (0x08), data (0x10); init_gdt() replaces it
+.align 8
+boot_gdt:
+    .quad 0
+    .quad 0x00AF9A000000FFFF
+    .quad 0x00CF92000000FFFF
+boot_gdt_ptr:
+    .word boot_gdt_ptr - boot_gdt - 1
+    .quad boot_gdt
+
+# Loader handoff registers (see _start); passed on to kernel_main
+.align 4
+boot_magic:
+    .long 0
+boot_info_addr:
+    .long 0
+
+# Boot page tables (filled in by _start after .bss is cleared)
+.section .bss
+.align 4096
+boot_pml4:
+    .skip 4096
+boot_pdpt:
+    .skip 4096
+boot_pd:
+    .skip 4 * 4096
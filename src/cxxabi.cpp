@@ -9,12 +9,11 @@
  * Implements:
  *   - Memory operations: memcpy, memset
  *   - String operations: strcmp, strncpy, strlen
- *   - C++ operators: new, delete (bump allocator - simple but functional)
+ *   - C++ operators: new, delete (size-class free-list allocator)
  *   - C++ ABI stubs: __cxa_pure_virtual, __cxa_atexit, __dso_handle
  * 
- * Note: The heap allocator is a simple bump allocator (no free/reuse).
- * Memory is allocated sequentially and never freed. This is sufficient
- * for the current kernel needs but will need improvement for advanced features.
+ * Note: Freed heap blocks are reused by later allocations of the same size
+ * class; they are never split or merged.
  * 
  * Version: 1.0.1
  * ============================================================================
@@ -129,70 +128,125 @@ extern "C" {
     // ========================================================================
     
     /**
-     * Simple Bump Allocator
+     * Size-Class Heap Allocator
      * 
-     * This is a basic bump allocator that allocates memory sequentially.
-     * Memory is never freed (delete is a no-op). This is sufficient for
-     * the kernel's current needs but should be replaced with a proper
-     * heap allocator for advanced features.
+     * Blocks are carved from a 64 KB pool in power-of-two sizes (16 bytes up
+     * to 64 KB). Each block starts with a HEAP_BLOCK_HEADER byte header
+     * holding its size class, so delete pushes the block onto that class's free list and
+     * the next allocation of the same class pops it again: both are O(1).
+     * Blocks are never split or merged, which keeps the common pattern of
+     * equal-sized objects coming and going (file nodes, file buffers) cheap
+     * at the cost of some internal fragmentation. Once boot has read the
+     * heap_kb parameter, heap_add_region() moves carving to a larger region;
+     * blocks already handed out stay where they are.
      * 
-     * Heap size: 64 KB (65536 bytes)
-     * Alignment: 8 bytes (for proper alignment)
+     * Because blocks are never split, a 64 KB block (HEAP_MAX_ALLOCATION
+     * bytes of payload) only comes from untouched region space or from the
+     * 64 KB free list. The default 512 KB region holds eight of them; the
+     * static pool holds one, which boot's small allocations break up.
+     * 
+     * Heap size: 64 KB (65536 bytes) at boot, heap_kb (default 512 KB)
+     * after heap_add_region()
+     * Alignment: the header size (8 bytes on i686, 16 on x86-64, where the
+     * ABI lets the compiler use aligned SSE moves on new'ed objects)
+     */
+    #define HEAP_MIN_SHIFT      4       // Smallest block: 16 bytes
+    #define HEAP_CLASSES        13      // 16 bytes .. 64 KB
+
+    struct HeapBlock {
+        uint32_t size_class;
+        HeapBlock* next_free;           // Next block of the same class (only while free)
+    };
+    static_assert(sizeof(HeapBlock) == HEAP_BLOCK_HEADER, "HeapBlock must match HEAP_BLOCK_HEADER");
+
+    static uint8_t heap_pool[HEAP_POOL_SIZE] __attribute__((aligned(16)));
+    static uint8_t* heap_area = heap_pool;              // Region blocks are carved from
+    static uint32_t heap_area_size = HEAP_POOL_SIZE;
+    static uint32_t heap_pos = 0;                       // Start of the never-used part of the region
+    static HeapBlock* heap_free_lists[HEAP_CLASSES];
+    static HeapStats heap_stats;
+
+    /**
+     * Allocate a Heap Block
+     * 
+     * @return HEAP_BLOCK_HEADER aligned memory, or nullptr if the heap is exhausted
+     */
+    static void* heap_alloc(size_t size) {
+        if (size > heap_area_size) {
+            return nullptr;
+        }
+        uint32_t needed = size + sizeof(HeapBlock);
+        uint32_t size_class = 0;
+        while ((1u << (size_class + HEAP_MIN_SHIFT)) < needed) {
+            size_class++;
+        }
+        if (size_class >= HEAP_CLASSES) {
+            return nullptr;
+        }
+
+        HeapBlock* block = heap_free_lists[size_class];
+        if (block) {
+            heap_free_lists[size_class] = block->next_free;
+        } else {
+            uint32_t block_size = 1u << (size_class + HEAP_MIN_SHIFT);
+            if (block_size > heap_area_size - heap_pos) {
+                return nullptr;  // Heap exhausted
+            }
+            block = (HeapBlock*)&heap_area[heap_pos];
+            block->size_class = size_class;
+            heap_pos += block_size;
+        }
+        heap_stats.allocations++;
+        heap_stats.bytes_allocated += 1u << (size_class + HEAP_MIN_SHIFT);
+        return block + 1;
+    }
+
+    /**
+     * Return a Block to its Free List
      */
-    static uint8_t heap_pool[65536];    // 64 KB heap pool
-    static uint32_t heap_pos = 0;       // Current allocation position
+    static void heap_free(void* ptr) {
+        if (!ptr) {
+            return;
+        }
+        HeapBlock* block = (HeapBlock*)ptr - 1;
+        heap_stats.frees++;
+        heap_stats.bytes_freed += 1u << (block->size_class + HEAP_MIN_SHIFT);
+        block->next_free = heap_free_lists[block->size_class];
+        heap_free_lists[block->size_class] = block;
+    }
 
     /**
      * Single Object Allocation (new operator)
      * 
-     * Allocates memory for a single object with 8-byte alignment.
-     * Returns nullptr if heap is exhausted.
+     * Returns nullptr if heap is exhausted (callers check: the kernel is
+     * built with -fcheck-new).
      */
     void* operator new(size_t size) throw() {
-        if (heap_pos + size > sizeof(heap_pool)) {
-            return nullptr;  // Heap exhausted
-        }
-        void* ptr = &heap_pool[heap_pos];
-        // Align to 8-byte boundary: round up to next multiple of 8
-        heap_pos += ((size + 7) & ~7);
-        return ptr;
+        return heap_alloc(size);
     }
 
     /**
      * Array Allocation (new[] operator)
      * 
-     * Allocates memory for an array with 8-byte alignment.
-     * Returns nullptr if heap is exhausted.
+     * Returns nullptr if heap is exhausted (callers check: the kernel is
+     * built with -fcheck-new).
      */
     void* operator new[](size_t size) throw() {
-        if (heap_pos + size > sizeof(heap_pool)) {
-            return nullptr;  // Heap exhausted
-        }
-        void* ptr = &heap_pool[heap_pos];
-        // Align to 8-byte boundary: round up to next multiple of 8
-        heap_pos += ((size + 7) & ~7);
-        return ptr;
+        return heap_alloc(size);
     }
 
     /**
      * Single Object Deallocation (delete operator)
-     * 
-     * Currently a no-op. The bump allocator doesn't support freeing memory.
-     * Future implementation should use a proper heap allocator with free lists.
      */
     void operator delete(void* ptr, size_t) throw() {
-        (void)ptr;  // Suppress unused parameter warning
-        // No-op: bump allocator doesn't support free
+        heap_free(ptr);
     }
 
     /**
      * Array Deallocation (delete[] operator)
-     * 
-     * Currently a no-op. See delete() operator above.
      */
     void operator delete[](void* ptr) throw() {
-        (void)ptr;  // Suppress unused parameter warning
-        // No-op: bump allocator doesn't support free
+        heap_free(ptr);
     }
 
     void __cxa_pure_virtual() { for (;;) {} }
@@ -211,4 +265,25 @@ extern "C" {
         // In a freestanding environment, just spin/halt.
         for (;;) { asm volatile("cli; hlt"); }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Continue the Heap in a Larger Region
+ *
+ * The unused tail of the current region is given up; blocks already
+ * allocated from it (and later freed) keep circulating via the free lists.
+ * @param base 16-byte aligned start of the region
+ * @param size Bytes in the region
+ */
+void heap_add_region(void* base, uint32_t size) {
+    heap_area = (uint8_t*)base;
+    heap_area_size = size;
+    heap_pos = 0;
+}
+
+/**
+ * Read the Heap Counters
+ */
+void heap_get_stats(HeapStats* stats) {
+    *stats = heap_stats;
+}
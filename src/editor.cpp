@@ -0,0 +1,456 @@
+/*
+ * ============================================================================
+ * RusticOS Text Editor Implementation (editor.cpp)
+ * ============================================================================
+ *
+ * The gap buffer holds text[0..gap_start) before the cursor and
+ * text[gap_end..capacity) after it; the cursor is always at gap_start.
+ *
+ * Drawing: every row is formatted into a line buffer and compared with a
+ * copy of what is on screen, and only rows that differ are written to VGA
+ * memory. A keystroke therefore redraws one or two rows, except when the
+ * view scrolls.
+ *
+ * The editor reads the keyboard directly, so it runs on the shell task;
+ * background jobs keep running while it waits for keys. One editor runs at
+ * a time (static state).
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "editor.h"
+#include "terminal.h"
+#include "keyboard.h"
+#include "filesystem.h"
+#include "task.h"
+#include "format.h"
+
+extern Terminal terminal;
+extern KeyboardDriver keyboard;
+extern FileSystem filesystem;
+
+// Screen layout
+#define EDITOR_WIDTH        80
+#define EDITOR_FIRST_ROW    1       // Below the title bar
+#define EDITOR_ROWS         23      // Text rows; the status line follows
+
+/**
+ * Editor State
+ */
+struct Editor {
+    char* text;                     // Gap buffer
+    uint32_t capacity;
+    uint32_t gap_start;             // Cursor position
+    uint32_t gap_end;
+    uint32_t line;                  // Cursor line (0-based)
+    uint32_t goal_column;           // Column kept by up/down moves
+    uint32_t top;                   // Offset of the first line on screen
+    uint32_t left;                  // First column on screen
+    bool modified;
+    bool quit_armed;                // ^Q pressed once with unsaved changes
+    char path[MAX_PATH_LENGTH];
+    char message[EDITOR_WIDTH];     // Shown in the status line until the next key
+    char screen[EDITOR_ROWS + 1][EDITOR_WIDTH];     // Rows as currently drawn (+ status)
+    bool screen_valid;
+};
+
+static Editor ed;
+
+// ============================================================================
+// Gap Buffer
+// ============================================================================
+
+static uint32_t text_length() {
+    return ed.capacity - (ed.gap_end - ed.gap_start);
+}
+
+static char char_at(uint32_t pos) {
+    return (pos < ed.gap_start) ? ed.text[pos] : ed.text[pos + ed.gap_end - ed.gap_start];
+}
+
+/**
+ * Move the Gap (and the cursor) to pos
+ *
+ * Only the text between the old and new cursor position is moved.
+ */
+static void move_gap(uint32_t pos) {
+    while (ed.gap_start > pos) {
+        ed.text[--ed.gap_end] = ed.text[--ed.gap_start];
+    }
+    while (ed.gap_start < pos) {
+        ed.text[ed.gap_start++] = ed.text[ed.gap_end++];
+    }
+}
+
+/**
+ * Make Room for count Bytes at the Cursor
+ *
+ * Sets the status message when the buffer cannot grow.
+ *
+ * @return false if the text would exceed EDITOR_MAX_TEXT or the heap is
+ *         exhausted
+ */
+static bool reserve(uint32_t count) {
+    if (ed.gap_end - ed.gap_start >= count) {
+        return true;
+    }
+    uint32_t length = text_length();
+    if (length + count > EDITOR_MAX_TEXT) {
+        strncpy(ed.message, "File too large", sizeof(ed.message));
+        return false;
+    }
+    // One byte past a full buffer is the next heap size class: twice the size
+    uint32_t want = ed.capacity + 1;
+    if (want < length + count + EDITOR_MIN_GAP) {
+        want = length + count + EDITOR_MIN_GAP;
+    }
+    uint32_t capacity = heap_block_capacity(want);
+    if (capacity == 0) {
+        capacity = HEAP_MAX_ALLOCATION;
+    }
+    char* grown = new char[capacity];
+    if (!grown) {
+        strncpy(ed.message, "Out of memory", sizeof(ed.message));
+        return false;
+    }
+    uint32_t after = ed.capacity - ed.gap_end;
+    memcpy(grown, ed.text, ed.gap_start);
+    memcpy(grown + capacity - after, ed.text + ed.gap_end, after);
+    delete[] ed.text;
+    ed.text = grown;
+    ed.gap_end = capacity - after;
+    ed.capacity = capacity;
+    return true;
+}
+
+// ============================================================================
+// Cursor Movement
+// ============================================================================
+
+static uint32_t line_start(uint32_t pos) {
+    while (pos > 0 && char_at(pos - 1) != '\n') pos--;
+    return pos;
+}
+
+static uint32_t line_end(uint32_t pos) {
+    uint32_t length = text_length();
+    while (pos < length && char_at(pos) != '\n') pos++;
+    return pos;
+}
+
+static uint32_t cursor_column() {
+    return ed.gap_start - line_start(ed.gap_start);
+}
+
+static void move_left() {
+    if (ed.gap_start == 0) return;
+    if (char_at(ed.gap_start - 1) == '\n') ed.line--;
+    move_gap(ed.gap_start - 1);
+    ed.goal_column = cursor_column();
+}
+
+static void move_right() {
+    if (ed.gap_end == ed.capacity) return;
+    if (char_at(ed.gap_start) == '\n') ed.line++;
+    move_gap(ed.gap_start + 1);
+    ed.goal_column = cursor_column();
+}
+
+static void move_up() {
+    uint32_t start = line_start(ed.gap_start);
+    if (start == 0) return;
+    uint32_t previous = line_start(start - 1);
+    uint32_t width = start - 1 - previous;
+    move_gap(previous + (ed.goal_column < width ? ed.goal_column : width));
+    ed.line--;
+}
+
+static void move_down() {
+    uint32_t end = line_end(ed.gap_start);
+    if (end == text_length()) return;
+    uint32_t next = end + 1;
+    uint32_t width = line_end(next) - next;
+    move_gap(next + (ed.goal_column < width ? ed.goal_column : width));
+    ed.line++;
+}
+
+// ============================================================================
+// Editing
+// ============================================================================
+
+/**
+ * Insert a Character Before the Cursor
+ *
+ * @return false if the buffer is full and cannot grow
+ */
+static bool insert_char(char c) {
+    if (!reserve(1)) {
+        return false;
+    }
+    ed.text[ed.gap_start++] = c;
+    if (c == '\n') ed.line++;
+    ed.goal_column = cursor_column();
+    ed.modified = true;
+    return true;
+}
+
+static void delete_before() {
+    if (ed.gap_start == 0) return;
+    if (ed.text[--ed.gap_start] == '\n') ed.line--;
+    ed.goal_column = cursor_column();
+    ed.modified = true;
+}
+
+static void delete_at() {
+    if (ed.gap_end == ed.capacity) return;
+    ed.gap_end++;
+    ed.modified = true;
+}
+
+/**
+ * Write the Buffer to the File
+ *
+ * The two halves of the gap buffer go straight into the file (no flattened
+ * copy); FileSystem::replace leaves the file as it was if the save fails.
+ */
+static void save() {
+    FileNode* file = filesystem.lookup(ed.path);
+    if (!file) {
+        bool has_slash = false;
+        for (const char* p = ed.path; *p; ++p) {
+            if (*p == '/') has_slash = true;
+        }
+        if (!has_slash && filesystem.create_file(ed.path, "")) {
+            file = filesystem.lookup(ed.path);
+        }
+    }
+    if (!file || file->type != FILE_TYPE_FILE) {
+        ksnprintf(ed.message, sizeof(ed.message), "Cannot create %s", ed.path);
+        return;
+    }
+    if (!filesystem.replace(file, ed.text, ed.gap_start,
+                            ed.text + ed.gap_end, ed.capacity - ed.gap_end)) {
+        strncpy(ed.message, "Out of memory: file not written", sizeof(ed.message));
+        return;
+    }
+    ed.modified = false;
+    ksnprintf(ed.message, sizeof(ed.message), "Wrote %u bytes", text_length());
+}
+
+// ============================================================================
+// Drawing
+// ============================================================================
+
+/**
+ * Scroll so the Cursor is Visible
+ *
+ * @return Screen row of the cursor (0-based within the text area)
+ */
+static uint32_t scroll_to_cursor() {
+    uint32_t start = line_start(ed.gap_start);
+    if (start < ed.top) {
+        ed.top = start;
+    }
+    uint32_t row = 0;
+    for (uint32_t p = ed.top; p < start; p = line_end(p) + 1) {
+        row++;
+    }
+    while (row >= EDITOR_ROWS) {
+        ed.top = line_end(ed.top) + 1;
+        row--;
+    }
+    uint32_t column = ed.gap_start - start;
+    if (column < ed.left) {
+        ed.left = column;
+    } else if (column >= ed.left + EDITOR_WIDTH) {
+        ed.left = column - EDITOR_WIDTH + 1;
+    }
+    return row;
+}
+
+static bool same_row(const char* a, const char* b) {
+    for (uint32_t i = 0; i < EDITOR_WIDTH; ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * Write a Row if it Differs from the Screen
+ */
+static void draw_row(uint32_t row, const char* cells, uint8_t fg, uint8_t bg) {
+    if (ed.screen_valid && same_row(ed.screen[row], cells)) {
+        return;
+    }
+    memcpy(ed.screen[row], cells, EDITOR_WIDTH);
+    terminal.writeRow(EDITOR_FIRST_ROW + row, cells, fg, bg);
+}
+
+static void draw() {
+    uint32_t cursor_row = scroll_to_cursor();
+    uint32_t length = text_length();
+    char cells[EDITOR_WIDTH + 1];
+
+    uint32_t p = ed.top;
+    bool more = true;                   // Rows left in the document
+    for (uint32_t row = 0; row < EDITOR_ROWS; ++row) {
+        memset(cells, ' ', EDITOR_WIDTH);
+        if (!more) {
+            cells[0] = '~';
+        } else {
+            uint32_t end = line_end(p);
+            for (uint32_t x = 0, pos = p + ed.left; x < EDITOR_WIDTH && pos < end; ++x, ++pos) {
+                char c = char_at(pos);
+                cells[x] = (c >= 32 && c <= 126) ? c : '?';
+            }
+            more = end < length;
+            p = end + 1;
+        }
+        draw_row(row, cells, LIGHT_GREY, BLACK);
+    }
+
+    // Status line: file, state and position, or the last message
+    uint32_t n = ksnprintf(cells, sizeof(cells), " %s%s  Ln %u, Col %u  ",
+                           ed.path, ed.modified ? " [modified]" : "",
+                           ed.line + 1, cursor_column() + 1);
+    const char* right = ed.message[0] ? ed.message : "^S Save  ^Q Quit";
+    if (n < EDITOR_WIDTH) {
+        ksnprintf(cells + n, sizeof(cells) - n, "%*s", (int32_t)(EDITOR_WIDTH - n), right);
+    }
+    draw_row(EDITOR_ROWS, cells, BLACK, LIGHT_GREY);
+
+    ed.screen_valid = true;
+    terminal.setCursor(cursor_column() - ed.left, EDITOR_FIRST_ROW + cursor_row);
+}
+
+// ============================================================================
+// Main Loop
+// ============================================================================
+
+/**
+ * Handle one Key
+ *
+ * @return false to leave the editor
+ */
+static bool handle_key(const KeyEvent& event) {
+    if (event.ctrl) {
+        switch (event.ascii) {
+            case 's':
+                save();
+                return true;
+            case 'q':
+                if (ed.modified && !ed.quit_armed) {
+                    strncpy(ed.message, "Unsaved changes: ^Q again to quit", sizeof(ed.message));
+                    ed.quit_armed = true;
+                    return true;
+                }
+                return false;
+            case 'l':
+                ed.screen_valid = false;
+                return true;
+            default:
+                return true;
+        }
+    }
+    switch (event.scan_code) {
+        case KEY_KEYPAD_4: move_left(); return true;
+        case KEY_KEYPAD_6: move_right(); return true;
+        case KEY_KEYPAD_8: move_up(); return true;
+        case KEY_KEYPAD_2: move_down(); return true;
+        case KEY_KEYPAD_7:
+            move_gap(line_start(ed.gap_start));
+            ed.goal_column = 0;
+            return true;
+        case KEY_KEYPAD_1:
+            move_gap(line_end(ed.gap_start));
+            ed.goal_column = cursor_column();
+            return true;
+        case KEY_KEYPAD_9:
+            for (uint32_t i = 0; i < EDITOR_ROWS; ++i) move_up();
+            return true;
+        case KEY_KEYPAD_3:
+            for (uint32_t i = 0; i < EDITOR_ROWS; ++i) move_down();
+            return true;
+        case KEY_KEYPAD_DECIMAL:
+            delete_at();
+            return true;
+        default:
+            break;
+    }
+    char c = (char)event.ascii;
+    if (c == 0x08) {
+        delete_before();
+    } else if (c == '\t') {
+        // Stop at a full buffer, which would never reach the tab stop
+        while (insert_char(' ') && cursor_column() % EDITOR_TAB_WIDTH != 0) {}
+    } else if (c == '\n' || (c >= 32 && c <= 126)) {
+        insert_char(c);
+    }
+    return true;
+}
+
+/**
+ * Run the Editor
+ *
+ * @param path File to edit; a missing file starts empty and is created by
+ *             the first save
+ * @return 0 after ^Q, 130 after Ctrl+C, 1 if the file cannot be edited
+ *         (a directory, larger than EDITOR_MAX_TEXT, or no heap left)
+ */
+int32_t editor_run(const char* path) {
+    FileNode* file = filesystem.lookup(path);
+    if (file && file->type != FILE_TYPE_FILE) {
+        return 1;
+    }
+    uint32_t size = (file && file->data) ? file->size : 0;
+    if (size > EDITOR_MAX_TEXT) {
+        return 1;
+    }
+    ed.capacity = heap_block_capacity(size + EDITOR_MIN_GAP);
+    if (ed.capacity == 0) {
+        ed.capacity = HEAP_MAX_ALLOCATION;
+    }
+    ed.text = new char[ed.capacity];
+    if (!ed.text) {
+        return 1;
+    }
+    // Document after the gap: the cursor starts at the top
+    ed.gap_start = 0;
+    ed.gap_end = ed.capacity - size;
+    memcpy(ed.text + ed.gap_end, size ? file->data : "", size);
+    ed.line = ed.goal_column = ed.top = ed.left = 0;
+    ed.modified = ed.quit_armed = false;
+    strncpy(ed.path, path, sizeof(ed.path));
+    ed.path[sizeof(ed.path) - 1] = '\0';
+    strncpy(ed.message, file ? "" : "New file", sizeof(ed.message));
+    ed.screen_valid = false;
+
+    int32_t status = 0;
+    draw();
+    while (true) {
+        if (task_poll()) {
+            status = 130;
+            break;
+        }
+        KeyEvent event;
+        if (!keyboard.get_key_event(event)) {
+            task_yield();
+            continue;
+        }
+        bool armed = ed.quit_armed;
+        ed.message[0] = '\0';
+        if (!handle_key(event)) {
+            break;
+        }
+        if (armed) {
+            ed.quit_armed = false;      // Only the very next key confirms
+        }
+        draw();
+    }
+
+    delete[] ed.text;
+    ed.text = nullptr;
+    terminal.clear();
+    return status;
+}
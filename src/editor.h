@@ -0,0 +1,46 @@
+/*
+ * ============================================================================
+ * RusticOS Text Editor Header (editor.h)
+ * ============================================================================
+ *
+ * Full-screen editor run by "edit <file>". The document is a gap buffer:
+ * the text lives in one array with a hole at the cursor, so typing and
+ * deleting at the cursor are O(1) and moving the cursor costs only the
+ * distance moved. The buffer doubles (to the next heap size class) when the
+ * hole is used up.
+ *
+ * The buffer is one heap block, so the text is limited to EDITOR_MAX_TEXT
+ * bytes (just under 64 KB). Larger files are refused when opened, and
+ * typing past the limit reports "File too large".
+ *
+ * Screen layout: rows 1..23 show the text (row 0 is the title bar), row 24
+ * is the status line. Lines longer than the screen scroll horizontally.
+ *
+ * Keys:
+ *   arrows, Home, End, PgUp, PgDn    Move
+ *   Backspace, Delete                Delete before / at the cursor
+ *   Ctrl+S                           Save
+ *   Ctrl+Q                           Quit (twice if there are unsaved changes)
+ *   Ctrl+L                           Redraw the whole screen
+ *   Ctrl+C                           Quit without saving
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef EDITOR_H
+#define EDITOR_H
+
+#include "types.h"
+
+// ============================================================================
+// Editor Constants
+// ============================================================================
+#define EDITOR_MIN_GAP      256     // Free space added whenever the buffer grows
+#define EDITOR_TAB_WIDTH    4       // Tab inserts spaces up to the next multiple
+#define EDITOR_MAX_TEXT     (HEAP_MAX_ALLOCATION - 1)   // Largest heap block (types.h) less the NUL a saved file keeps
+
+// Editor functions
+int32_t editor_run(const char* path);  // Edit path (created on first save); returns the exit status
+
+#endif // EDITOR_H
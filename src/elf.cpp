@@ -0,0 +1,178 @@
+/*
+ * ============================================================================
+ * RusticOS ELF32 Loader Implementation (elf.cpp)
+ * ============================================================================
+ *
+ * Maps the PT_LOAD segments of an executable into a process in two passes:
+ *   1. Private parts (writable segments, partial pages, .bss) are mapped to
+ *      fresh zeroed frames and the file bytes copied in.
+ *   2. Whole read-only pages backed by page-aligned file data are mapped
+ *      directly onto the file (PAGE_SHARED, never freed by the process).
+ * Doing all copies first guarantees the loader never writes through a shared
+ * mapping into the file itself. Only images that outlive every process (the
+ * initial ramdisk) are shared; any other file could be removed or rewritten
+ * while the program runs, so all of its pages are copied.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "elf.h"
+#include "process.h"
+#include "paging.h"
+
+/**
+ * Shareable Page Range of a Segment
+ *
+ * @param image_addr Address of the file data
+ * @param share false if the image may not be mapped at all
+ * @param ph Program header
+ * @param start Receives the first shareable page (page aligned)
+ * @param end Receives one past the last shareable page (start == end if none)
+ */
+static void shared_range(uint32_t image_addr, bool share, const Elf32ProgramHeader& ph, uint32_t* start, uint32_t* end) {
+    *start = *end = 0;
+    if (!share || (ph.flags & ELF_PF_W) || ((image_addr + ph.offset - ph.vaddr) & (PAGE_SIZE - 1))) {
+        return;  // Not shareable, writable, or file pages do not line up with memory pages
+    }
+    uint32_t first = PAGE_ALIGN_UP(ph.vaddr);
+    uint32_t last = PAGE_ALIGN_DOWN(ph.vaddr + ph.filesz);
+    if (first < last) {
+        *start = first;
+        *end = last;
+    }
+}
+
+/**
+ * Map and Fill a Private Part of a Segment
+ *
+ * @param from Start of the range (inside the segment)
+ * @param to End of the range (exclusive)
+ */
+static bool load_private(Process* proc, const uint8_t* image, const Elf32ProgramHeader& ph,
+                         uint32_t from, uint32_t to, ElfLoadInfo* info) {
+    if (from >= to) {
+        return true;
+    }
+    uint32_t flags = PAGE_USER | ((ph.flags & ELF_PF_W) ? PAGE_WRITABLE : 0);
+    if (!process_map(proc, from, to - from, flags)) {
+        return false;
+    }
+    info->copied_pages += (PAGE_ALIGN_UP(to) - PAGE_ALIGN_DOWN(from)) / PAGE_SIZE;
+
+    uint32_t file_end = ph.vaddr + ph.filesz;
+    if (from < file_end) {
+        uint32_t copy_end = (to < file_end) ? to : file_end;
+        return process_copy_to(proc, from, image + ph.offset + (from - ph.vaddr), copy_end - from);
+    }
+    return true;  // Pure .bss: pages are already zeroed
+}
+
+/**
+ * Validate an ELF Image
+ *
+ * Checks the identification bytes, type and machine, and that every
+ * PT_LOAD segment lies inside the file and inside the user image area
+ * (below the user stack).
+ *
+ * @return true if elf_load() may be called on the image
+ */
+bool elf_check(const uint8_t* image, uint32_t size) {
+    if (!image || size < sizeof(Elf32Header)) {
+        return false;
+    }
+    const Elf32Header* header = (const Elf32Header*)image;
+    if (header->magic != ELF_MAGIC || header->file_class != ELF_CLASS_32 ||
+        header->data != ELF_DATA_LSB || header->type != ELF_TYPE_EXEC ||
+        header->machine != ELF_MACHINE_386 || header->phentsize != sizeof(Elf32ProgramHeader)) {
+        return false;
+    }
+    if (header->phoff > size || header->phnum > (size - header->phoff) / sizeof(Elf32ProgramHeader)) {
+        return false;
+    }
+
+    const uint32_t image_limit = USER_STACK_TOP - USER_STACK_PAGES * PAGE_SIZE;
+    const Elf32ProgramHeader* phdrs = (const Elf32ProgramHeader*)(image + header->phoff);
+    for (uint32_t i = 0; i < header->phnum; ++i) {
+        const Elf32ProgramHeader& ph = phdrs[i];
+        if (ph.type != ELF_PT_LOAD || ph.memsz == 0) {
+            continue;
+        }
+        if (ph.filesz > ph.memsz || ph.offset > size || ph.filesz > size - ph.offset ||
+            ph.vaddr < USER_BASE || ph.vaddr > image_limit || ph.memsz > image_limit - ph.vaddr) {
+            return false;
+        }
+    }
+    return header->entry >= USER_BASE && header->entry < image_limit;
+}
+
+/**
+ * Load an ELF Image into a Process
+ *
+ * @param proc Process created by process_create()
+ * @param image File contents (only read during the call unless share is set)
+ * @param size File size in bytes
+ * @param share true if image stays valid and unchanged for good, so
+ *              read-only pages may map it directly
+ * @param info Optional load statistics
+ * @return true on success; on failure the process should be destroyed
+ */
+bool elf_load(Process* proc, const uint8_t* image, uint32_t size, bool share, ElfLoadInfo* info) {
+    ElfLoadInfo local_info;
+    if (!info) info = &local_info;
+    info->segments = info->shared_pages = info->copied_pages = 0;
+
+    if (!proc || !elf_check(image, size)) {
+        return false;
+    }
+    const Elf32Header* header = (const Elf32Header*)image;
+    const Elf32ProgramHeader* phdrs = (const Elf32ProgramHeader*)(image + header->phoff);
+    uint32_t image_addr = (uint32_t)(uintptr_t)image;
+
+    // Pass 1: private pages
+    for (uint32_t i = 0; i < header->phnum; ++i) {
+        const Elf32ProgramHeader& ph = phdrs[i];
+        if (ph.type != ELF_PT_LOAD || ph.memsz == 0) {
+            continue;
+        }
+        info->segments++;
+        uint32_t share_start, share_end;
+        shared_range(image_addr, share, ph, &share_start, &share_end);
+        uint32_t mem_end = ph.vaddr + ph.memsz;
+        if (share_start == share_end) {
+            if (!load_private(proc, image, ph, ph.vaddr, mem_end, info)) return false;
+        } else if (!load_private(proc, image, ph, ph.vaddr, share_start, info) ||
+                   !load_private(proc, image, ph, share_end, mem_end, info)) {
+            return false;
+        }
+    }
+
+    // Pass 2: pages mapped directly onto the file
+    for (uint32_t i = 0; i < header->phnum; ++i) {
+        const Elf32ProgramHeader& ph = phdrs[i];
+        if (ph.type != ELF_PT_LOAD || ph.memsz == 0) {
+            continue;
+        }
+        uint32_t share_start, share_end;
+        shared_range(image_addr, share, ph, &share_start, &share_end);
+        for (uint32_t page = share_start; page < share_end; page += PAGE_SIZE) {
+            uint32_t file_page = image_addr + ph.offset + (page - ph.vaddr);
+            uint32_t mapped = translate_address(proc->page_directory, page);
+            if (!mapped) {
+                if (!map_page(proc->page_directory, page, file_page, PAGE_USER | PAGE_SHARED)) {
+                    return false;
+                }
+                info->shared_pages++;
+            } else if (mapped == file_page) {
+                continue;  // Same file page already shared by an earlier segment
+            } else if (mapped >= image_addr && mapped < image_addr + size) {
+                return false;  // Page claimed by a different part of the file
+            } else if (!process_copy_to(proc, page, (const void*)(uintptr_t)file_page, PAGE_SIZE)) {
+                return false;  // (Private page from pass 1: fill it instead)
+            }
+        }
+    }
+
+    proc->entry = header->entry;
+    return true;
+}
@@ -0,0 +1,91 @@
+/*
+ * ============================================================================
+ * RusticOS ELF32 Loader Header (elf.h)
+ * ============================================================================
+ *
+ * Loads statically linked i386 ELF executables (ET_EXEC) into a process.
+ * Only PT_LOAD program headers are used; sections are ignored.
+ *
+ * Zero-copy loading:
+ *   Pages of a read-only segment that are fully backed by file data are
+ *   mapped straight onto the file's memory (PAGE_SHARED) when the file data
+ *   and the segment are page aligned, which is the case for programs in the
+ *   initrd. Only initrd data is shared: it is never freed, while any other
+ *   file could be removed under a running program. Writable segments,
+ *   partial pages, .bss and other files are copied/zeroed into private
+ *   frames.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef ELF_H
+#define ELF_H
+
+#include "types.h"
+
+struct Process;
+
+// ============================================================================
+// ELF32 Constants
+// ============================================================================
+#define ELF_MAGIC           0x464C457F      // "\x7F" "ELF" as a little-endian word
+#define ELF_CLASS_32        1
+#define ELF_DATA_LSB        1
+#define ELF_TYPE_EXEC       2
+#define ELF_MACHINE_386     3
+
+#define ELF_PT_LOAD         1
+#define ELF_PF_X            0x1
+#define ELF_PF_W            0x2
+#define ELF_PF_R            0x4
+
+// ============================================================================
+// ELF32 Structures
+// ============================================================================
+struct Elf32Header {
+    uint32_t magic;
+    uint8_t file_class;
+    uint8_t data;
+    uint8_t ident_version;
+    uint8_t ident_pad[9];
+    uint16_t type;
+    uint16_t machine;
+    uint32_t version;
+    uint32_t entry;
+    uint32_t phoff;
+    uint32_t shoff;
+    uint32_t flags;
+    uint16_t ehsize;
+    uint16_t phentsize;
+    uint16_t phnum;
+    uint16_t shentsize;
+    uint16_t shnum;
+    uint16_t shstrndx;
+};
+
+struct Elf32ProgramHeader {
+    uint32_t type;
+    uint32_t offset;
+    uint32_t vaddr;
+    uint32_t paddr;
+    uint32_t filesz;
+    uint32_t memsz;
+    uint32_t flags;
+    uint32_t align;
+};
+
+/**
+ * Load statistics (reported by exec/execbench)
+ */
+struct ElfLoadInfo {
+    uint32_t segments;              // PT_LOAD headers processed
+    uint32_t shared_pages;          // Pages mapped directly onto file data
+    uint32_t copied_pages;          // Pages backed by private frames
+};
+
+// ELF loader functions
+bool elf_check(const uint8_t* image, uint32_t size);    // Validate header and program headers
+bool elf_load(Process* proc, const uint8_t* image, uint32_t size, bool share, ElfLoadInfo* info);  // Map PT_LOAD segments, set entry
+
+#endif // ELF_H
@@ -66,8 +66,8 @@ void FileSystem::free_node(FileNode* node) {
         free_node(node->children[i]);
     }
     
-    // Free file data if this is a file
-    if (node->data) {
+    // Free file data if this is a file (external data is borrowed, not owned)
+    if (node->data && !node->external) {
         delete[] node->data;
     }
     
@@ -185,28 +185,28 @@ bool FileSystem::cd(const char* path) {
     return false;
 }
 
-void FileSystem::ls() {
+void FileSystem::ls(OutputSink& out) {
     if (!current_dir) {
-        terminal.write("Error: no current directory\n");
+        out.write("Error: no current directory\n");
         return;
     }
     
     for (uint32_t i = 0; i < current_dir->child_count; i++) {
         FileNode* child = current_dir->children[i];
-        terminal.write(child->name);
+        out.write(child->name);
         if (child->type == FILE_TYPE_DIRECTORY) {
-            terminal.write("/");
+            out.write("/");
         }
-        terminal.write("\n");
+        out.write("\n");
     }
 }
 
-bool FileSystem::pwd() {
+bool FileSystem::pwd(OutputSink& out) {
     if (!current_dir || !root) return false;
     
     // If we're at root, just return "/"
     if (current_dir == root) {
-        terminal.write("/\n");
+        out.write("/\n");
         return true;
     }
     
@@ -257,8 +257,8 @@ bool FileSystem::pwd() {
     
     path[path_pos] = '\0';
     
-    terminal.write(path);
-    terminal.write("\n");
+    out.write(path);
+    out.write("\n");
     return true;
 }
 
@@ -272,16 +272,25 @@ bool FileSystem::create_file(const char* name, const char* content) {
     }
     
     FileNode* new_file = new FileNode();
+    if (!new_file) {
+        return false;
+    }
     strncpy(new_file->name, name, MAX_NAME_LENGTH - 1);
     new_file->name[MAX_NAME_LENGTH - 1] = '\0';
     new_file->type = FILE_TYPE_FILE;
     new_file->is_directory = false;
     new_file->child_count = 0;
+    new_file->external = false;
+    new_file->open_count = 0;
     new_file->parent = current_dir;
     
     uint32_t content_len = content ? strlen(content) : 0;
     new_file->data_capacity = (content_len > 0) ? content_len + 1 : 64;
     new_file->data = new char[new_file->data_capacity];
+    if (!new_file->data) {
+        delete new_file;
+        return false;
+    }
     new_file->size = content_len;
     
     if (content && content_len > 0) {
@@ -302,6 +311,11 @@ bool FileSystem::delete_file(const char* name) {
     if (!file || file->type != FILE_TYPE_FILE) {
         return false;
     }
+    // A redirection or here-document still holds the node
+    if (file->open_count > 0) {
+        terminal.write("Error: file is open\n");
+        return false;
+    }
     
     for (uint32_t i = 0; i < current_dir->child_count; ++i) {
         if (current_dir->children[i] == file) {
@@ -340,10 +354,18 @@ bool FileSystem::write_file(const char* name, const char* content) {
     }
     
     uint32_t content_len = strlen(content);
-    if (content_len > file->data_capacity) {
-        delete[] file->data;
+    if (file->external || content_len >= file->data_capacity) {
+        // External data is read-only: the first write moves the file to the heap
+        char* data = new char[content_len + 1];
+        if (!data) {
+            return false;
+        }
+        if (!file->external) {
+            delete[] file->data;
+        }
         file->data_capacity = content_len + 1;
-        file->data = new char[file->data_capacity];
+        file->data = data;
+        file->external = false;
     }
     
     strncpy(file->data, content, file->data_capacity - 1);
@@ -352,6 +374,204 @@ bool FileSystem::write_file(const char* name, const char* content) {
     return true;
 }
 
+/**
+ * Append to a File
+ * 
+ * Grows the buffer geometrically so a stream of block-sized appends (output
+ * redirection) costs amortized O(1) allocations per byte instead of one
+ * reallocation per block. Each step takes the whole of the next heap size
+ * class (heap_block_capacity), so the capacities double without spilling a
+ * header's worth into a class twice as large. The content stays
+ * NUL-terminated, so a file holds at most HEAP_MAX_ALLOCATION - 1 bytes.
+ * 
+ * @param file File node (must be a regular file)
+ * @param data Bytes to append
+ * @param len Number of bytes
+ * @return true on success, false if file is not a regular file, the file
+ *         would exceed the largest heap block, or the heap is exhausted
+ */
+bool FileSystem::append(FileNode* file, const char* data, uint32_t len) {
+    if (!file || file->type != FILE_TYPE_FILE || (len > 0 && !data)) return false;
+    
+    uint32_t needed = file->size + len + 1;
+    if (file->external || !file->data || needed > file->data_capacity) {
+        // One byte past a full buffer is the next size class: twice the size
+        uint32_t want = 64;
+        if (!file->external && file->data && file->data_capacity >= want) {
+            want = file->data_capacity + 1;
+        }
+        if (needed > want) want = needed;
+        uint32_t capacity = heap_block_capacity(want);
+        if (capacity == 0) {
+            // Past the largest block: the last step only needs what is left
+            if (needed > HEAP_MAX_ALLOCATION) return false;
+            capacity = HEAP_MAX_ALLOCATION;
+        }
+        
+        char* grown = new char[capacity];
+        if (!grown) return false;
+        if (file->data) {
+            memcpy(grown, file->data, file->size);
+        }
+        if (file->data && !file->external) {
+            delete[] file->data;
+        }
+        file->data = grown;
+        file->data_capacity = capacity;
+        file->external = false;
+    }
+    
+    memcpy(file->data + file->size, data, len);
+    file->size += len;
+    file->data[file->size] = '\0';
+    return true;
+}
+
+/**
+ * Truncate a File
+ * 
+ * Keeps the existing buffer for reuse; external data is simply dropped.
+ */
+void FileSystem::truncate(FileNode* file) {
+    if (!file || file->type != FILE_TYPE_FILE) return;
+    if (file->external) {
+        file->data = nullptr;
+        file->data_capacity = 0;
+        file->external = false;
+    }
+    if (file->data) {
+        file->data[0] = '\0';
+    }
+    file->size = 0;
+}
+
+/**
+ * Replace a File's Content
+ * 
+ * The content is given in two pieces (e.g. the text on either side of an
+ * editor's gap), so the caller needs no contiguous copy. The file's own
+ * buffer is reused when it is large enough; otherwise a new one is filled
+ * before the old one is freed, so a failed replace leaves the file as it
+ * was.
+ * 
+ * @param file File node (must be a regular file)
+ * @param head First piece of the content
+ * @param head_len Bytes in head
+ * @param tail Second piece
+ * @param tail_len Bytes in tail
+ * @return true on success, false if file is not a regular file, the content
+ *         would exceed the largest heap block, or the heap is exhausted
+ */
+bool FileSystem::replace(FileNode* file, const char* head, uint32_t head_len,
+                         const char* tail, uint32_t tail_len) {
+    if (!file || file->type != FILE_TYPE_FILE) return false;
+    uint32_t size = head_len + tail_len;
+    if (size >= HEAP_MAX_ALLOCATION) return false;
+    if (file->external || !file->data || size >= file->data_capacity) {
+        uint32_t capacity = heap_block_capacity(size + 1);
+        char* data = new char[capacity];
+        if (!data) return false;
+        if (file->data && !file->external) {
+            delete[] file->data;
+        }
+        file->data = data;
+        file->data_capacity = capacity;
+        file->external = false;
+    }
+    memcpy(file->data, head, head_len);
+    memcpy(file->data + head_len, tail, tail_len);
+    file->size = size;
+    file->data[size] = '\0';
+    return true;
+}
+
+/**
+ * Add External File
+ * 
+ * Creates a file in the current directory whose content lives in memory the
+ * filesystem does not own (e.g. the initial ramdisk). No copy is made, so
+ * page-aligned data stays page aligned for zero-copy mapping by the ELF
+ * loader. The file becomes heap-backed on its first write.
+ * 
+ * @param name File name
+ * @param data File content (must stay valid for the lifetime of the file)
+ * @param size Content size in bytes
+ * @return true on success, false if the name exists or the directory is full
+ */
+bool FileSystem::add_external_file(const char* name, const char* data, uint32_t size) {
+    if (!name || !data || !current_dir || current_dir->child_count >= MAX_DIRECTORY_ENTRIES) {
+        return false;
+    }
+    if (find_child(current_dir, name)) {
+        return false;
+    }
+    
+    FileNode* new_file = new FileNode();
+    if (!new_file) {
+        return false;
+    }
+    strncpy(new_file->name, name, MAX_NAME_LENGTH - 1);
+    new_file->name[MAX_NAME_LENGTH - 1] = '\0';
+    new_file->type = FILE_TYPE_FILE;
+    new_file->is_directory = false;
+    new_file->child_count = 0;
+    new_file->size = size;
+    new_file->data = (char*)data;
+    new_file->data_capacity = size;
+    new_file->external = true;
+    new_file->open_count = 0;
+    new_file->parent = current_dir;
+    
+    current_dir->children[current_dir->child_count++] = new_file;
+    return true;
+}
+
+/**
+ * Resolve a Path
+ * 
+ * Walks an absolute ("/bin/hello") or relative ("docs/../notes") path one
+ * component at a time. "." and ".." are supported.
+ * 
+ * @param path Path to resolve
+ * @return Node at the path, or nullptr if any component does not exist
+ */
+FileNode* FileSystem::lookup(const char* path) {
+    if (!path || !current_dir) return nullptr;
+    
+    FileNode* node = (*path == '/') ? root : current_dir;
+    char part[MAX_NAME_LENGTH];
+    
+    while (*path) {
+        while (*path == '/') path++;
+        if (!*path) break;
+        
+        uint32_t len = 0;
+        while (path[len] && path[len] != '/') len++;
+        if (len >= MAX_NAME_LENGTH) {
+            return nullptr;  // Component too long to exist
+        }
+        memcpy(part, path, len);
+        part[len] = '\0';
+        path += len;
+        
+        if (strcmp(part, ".") == 0) {
+            continue;
+        }
+        if (strcmp(part, "..") == 0) {
+            if (node->parent) node = node->parent;
+            continue;
+        }
+        if (node->type != FILE_TYPE_DIRECTORY) {
+            return nullptr;
+        }
+        node = find_child(node, part);
+        if (!node) {
+            return nullptr;
+        }
+    }
+    return node;
+}
+
 bool FileSystem::remove(const char* name) {
     if (!name || !current_dir) return false;
     
@@ -380,6 +600,10 @@ bool FileSystem::move(const char* src, const char* dest) {
         terminal.write("Error: source not found\n");
         return false;
     }
+    if (src_node->open_count > 0) {
+        terminal.write("Error: file is open\n");
+        return false;
+    }
     
     // Check if destination already exists
     if (find_child(current_dir, dest)) {
@@ -429,10 +653,16 @@ bool FileSystem::copy_file(const char* src, const char* dest) {
         if (src_file->data && src_file->size > 0) {
             FileNode* dest_file = find_child(current_dir, dest);
             if (dest_file) {
-                // Allocate and copy data
+                // Allocate and copy data (memcpy: binaries may contain NUL bytes)
+                char* data = new char[src_file->size + 1];
+                if (!data) {
+                    delete_file(dest);
+                    return false;
+                }
+                delete[] dest_file->data;
                 dest_file->data_capacity = src_file->size + 1;
-                dest_file->data = new char[dest_file->data_capacity];
-                strncpy(dest_file->data, src_file->data, src_file->size);
+                dest_file->data = data;
+                memcpy(dest_file->data, src_file->data, src_file->size);
                 dest_file->data[src_file->size] = '\0';
                 dest_file->size = src_file->size;
             }
@@ -11,6 +11,7 @@
  *   - File and directory creation, deletion, and navigation
  *   - Dynamic memory allocation for filesystem nodes
  *   - File content storage with dynamic sizing
+ *   - Read-only external files backed by boot-time memory (initrd)
  * 
  * Limitations:
  *   - Maximum 64 entries per directory
@@ -26,6 +27,7 @@
 #define FILESYSTEM_H
 
 #include "types.h"
+#include "output.h"
 
 // ============================================================================
 // Filesystem Constants
@@ -57,6 +59,8 @@ struct FileNode {
     uint32_t size;                                 // File size in bytes (for files), 0 for directories
     char* data;                                    // File content pointer (null for directories, allocated for files)
     uint32_t data_capacity;                        // Allocated capacity for data buffer (for dynamic resizing)
+    bool external;                                 // True if data is borrowed (not owned, never freed)
+    uint32_t open_count;                           // Open FileSinks and here-documents (no remove/move while > 0)
     FileNode* children[MAX_DIRECTORY_ENTRIES];     // Array of child node pointers (for directories)
     FileNode* parent;                              // Pointer to parent directory (null for root)
 };
@@ -106,14 +110,19 @@ public:
     bool mkdir(const char* path);   // Create a new directory
     bool rmdir(const char* path);   // Remove an empty directory
     bool cd(const char* path);      // Change current directory (supports "/", "..", and relative paths)
-    void ls();                      // List contents of current directory
-    bool pwd();                     // Print current working directory path
+    void ls(OutputSink& out);       // List contents of current directory
+    bool pwd(OutputSink& out);      // Print current working directory path
     
     // File operations
     bool create_file(const char* name, const char* content);  // Create a new file with optional content
     bool delete_file(const char* name);                       // Delete a file
     bool read_file(const char* name, char* buffer, uint32_t max_size);  // Read file contents into buffer
     bool write_file(const char* name, const char* content);   // Write content to existing file
+    bool append(FileNode* file, const char* data, uint32_t len);  // Append bytes (used by "cmd >> file")
+    void truncate(FileNode* file);                            // Empty a file (used by "cmd > file")
+    bool replace(FileNode* file, const char* head, uint32_t head_len, const char* tail, uint32_t tail_len);  // Set the content from two pieces, all or nothing
+    bool add_external_file(const char* name, const char* data, uint32_t size);  // Add a file backed by external memory
+    FileNode* lookup(const char* path);                       // Resolve an absolute or relative path
     
     // Advanced file operations
     bool remove(const char* name);           // Remove file or empty directory (unified interface)
@@ -0,0 +1,327 @@
+/*
+ * ============================================================================
+ * RusticOS Formatted Output Implementation (format.cpp)
+ * ============================================================================
+ *
+ * Both ksnprintf() and kprintf() run the same formatter over a
+ * FormatTarget. For kprintf() the target is a small stack buffer that is
+ * handed to the sink whenever it fills, so a formatted line reaches the
+ * sink as one write no matter how many pieces it is built from.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "format.h"
+#include "output.h"
+
+#define FORMAT_CHUNK_SIZE   128     // kprintf() stack buffer
+
+// "00" "01" ... "99": two decimal digits per table lookup
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char hex_lower[] = "0123456789abcdef";
+static const char hex_upper[] = "0123456789ABCDEF";
+
+// ============================================================================
+// Number Conversion
+// ============================================================================
+
+/**
+ * Write value as exactly 8 digits (with leading zeros) ending before end
+ */
+static void format_8_digits(uint32_t value, char* end) {
+    for (uint32_t i = 0; i < 4; ++i) {
+        uint32_t pair = value % 100;
+        value /= 100;
+        end -= 2;
+        end[0] = digit_pairs[pair * 2];
+        end[1] = digit_pairs[pair * 2 + 1];
+    }
+}
+
+/**
+ * Convert a 32-bit Value to Decimal
+ *
+ * Digits are produced right to left, two per step, into a scratch buffer
+ * and copied out once.
+ */
+uint32_t format_u32(uint32_t value, char* buffer) {
+    char scratch[10];
+    char* p = scratch + sizeof(scratch);
+    while (value >= 100) {
+        uint32_t pair = value % 100;
+        value /= 100;
+        p -= 2;
+        p[0] = digit_pairs[pair * 2];
+        p[1] = digit_pairs[pair * 2 + 1];
+    }
+    if (value >= 10) {
+        p -= 2;
+        p[0] = digit_pairs[value * 2];
+        p[1] = digit_pairs[value * 2 + 1];
+    } else {
+        *--p = (char)('0' + value);
+    }
+    uint32_t len = scratch + sizeof(scratch) - p;
+    memcpy(buffer, p, len);
+    buffer[len] = '\0';
+    return len;
+}
+
+/**
+ * Convert a 64-bit Value to Decimal
+ *
+ * Values that fit in 32 bits take the 32-bit path. Larger ones are split
+ * into base-10^8 chunks with div_u64 (two 32-bit DIVs each), and every
+ * chunk is converted with 32-bit arithmetic.
+ */
+uint32_t format_u64(uint64_t value, char* buffer) {
+    if ((value >> 32) == 0) {
+        return format_u32((uint32_t)value, buffer);
+    }
+    uint64_t high = div_u64(value, 100000000);
+    uint32_t low = (uint32_t)(value - high * 100000000);
+    uint32_t len;
+    if ((high >> 32) == 0) {
+        len = format_u32((uint32_t)high, buffer);
+    } else {
+        uint64_t top = div_u64(high, 100000000);    // At most 4 digits (2^64 / 10^16)
+        uint32_t middle = (uint32_t)(high - top * 100000000);
+        len = format_u32((uint32_t)top, buffer);
+        format_8_digits(middle, buffer + len + 8);
+        len += 8;
+    }
+    format_8_digits(low, buffer + len + 8);
+    len += 8;
+    buffer[len] = '\0';
+    return len;
+}
+
+/**
+ * Convert to Hexadecimal (no "0x" prefix, no leading zeros)
+ */
+uint32_t format_hex(uint64_t value, char* buffer, bool upper) {
+    const char* digits = upper ? hex_upper : hex_lower;
+    uint32_t len = 1;
+    while (len < 16 && (value >> (len * 4)) != 0) {
+        len++;
+    }
+    for (uint32_t i = 0; i < len; ++i) {
+        buffer[len - 1 - i] = digits[(uint32_t)(value >> (i * 4)) & 0xF];
+    }
+    buffer[len] = '\0';
+    return len;
+}
+
+// ============================================================================
+// Formatter
+// ============================================================================
+
+/**
+ * Destination of the formatter
+ *
+ * With a sink, buffer is a chunk that is drained whenever it fills; without
+ * one, output beyond size is counted but dropped (snprintf truncation).
+ */
+struct FormatTarget {
+    char* buffer;
+    uint32_t size;                  // Usable bytes in buffer
+    uint32_t pos;                   // Bytes currently in buffer
+    uint32_t total;                 // Bytes produced so far
+    OutputSink* sink;
+};
+
+static void emit(FormatTarget& target, const char* data, uint32_t len) {
+    target.total += len;
+    while (len > 0) {
+        if (target.pos == target.size) {
+            if (!target.sink) {
+                return;
+            }
+            target.sink->write(target.buffer, target.pos);
+            target.pos = 0;
+        }
+        uint32_t chunk = target.size - target.pos;
+        if (chunk > len) chunk = len;
+        memcpy(target.buffer + target.pos, data, chunk);
+        target.pos += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+static void emit_fill(FormatTarget& target, char c, uint32_t count) {
+    char fill[16];
+    memset(fill, c, sizeof(fill));
+    while (count > 0) {
+        uint32_t chunk = count < sizeof(fill) ? count : sizeof(fill);
+        emit(target, fill, chunk);
+        count -= chunk;
+    }
+}
+
+static void format_to(FormatTarget& target, const char* format, __builtin_va_list args) {
+    while (*format) {
+        // Literal text up to the next conversion goes out in one piece
+        const char* literal = format;
+        while (*format && *format != '%') format++;
+        if (format > literal) {
+            emit(target, literal, format - literal);
+        }
+        if (*format == '\0') {
+            break;
+        }
+        format++;
+
+        bool left = false;
+        bool zero = false;
+        for (;; ++format) {
+            if (*format == '-') left = true;
+            else if (*format == '0') zero = true;
+            else break;
+        }
+        uint32_t width = 0;
+        if (*format == '*') {
+            int32_t w = __builtin_va_arg(args, int32_t);
+            if (w < 0) {
+                left = true;
+                w = -w;
+            }
+            width = (uint32_t)w;
+            format++;
+        } else {
+            while (*format >= '0' && *format <= '9') {
+                width = width * 10 + (*format++ - '0');
+            }
+        }
+        uint32_t longs = 0;             // 'l' = long (and size_t, which is unsigned long), 'll' = 64 bits
+        if (*format == 'z') {
+            longs = 1;
+            format++;
+        }
+        while (*format == 'l') {
+            longs++;
+            format++;
+        }
+
+        char digits[FORMAT_MAX_DIGITS + 1];
+        const char* text = digits;
+        uint32_t len = 0;
+        bool negative = false;
+        char conversion = *format;
+        if (conversion == '\0') {
+            break;
+        }
+        format++;
+
+        switch (conversion) {
+            case 'd':
+            case 'i': {
+                int64_t value = (longs >= 2) ? __builtin_va_arg(args, int64_t)
+                              : (longs == 1) ? (int64_t)__builtin_va_arg(args, long)
+                                             : (int64_t)__builtin_va_arg(args, int32_t);
+                negative = value < 0;
+                len = format_u64(negative ? 0 - (uint64_t)value : (uint64_t)value, digits);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X': {
+                uint64_t value = (longs >= 2) ? __builtin_va_arg(args, uint64_t)
+                               : (longs == 1) ? (uint64_t)__builtin_va_arg(args, unsigned long)
+                                              : (uint64_t)__builtin_va_arg(args, uint32_t);
+                len = (conversion == 'u') ? format_u64(value, digits)
+                                          : format_hex(value, digits, conversion == 'X');
+                break;
+            }
+            case 'p':
+                emit(target, "0x", 2);
+                len = format_hex((size_t)__builtin_va_arg(args, void*), digits, false);
+                zero = true;
+                if (width < 8) width = 8;
+                break;
+            case 'c':
+                digits[0] = (char)__builtin_va_arg(args, int);
+                len = 1;
+                break;
+            case 's':
+                text = __builtin_va_arg(args, const char*);
+                if (!text) text = "(null)";
+                len = strlen(text);
+                zero = false;
+                break;
+            case '%':
+                digits[0] = '%';
+                len = 1;
+                break;
+            default:                // Unknown conversion: print it as written
+                digits[0] = '%';
+                digits[1] = conversion;
+                len = 2;
+                break;
+        }
+
+        uint32_t body = len + (negative ? 1 : 0);
+        uint32_t pad = (width > body) ? width - body : 0;
+        if (!left && !zero) emit_fill(target, ' ', pad);
+        if (negative) emit(target, "-", 1);
+        if (!left && zero) emit_fill(target, '0', pad);
+        emit(target, text, len);
+        if (left) emit_fill(target, ' ', pad);
+    }
+}
+
+/**
+ * Format into a Buffer
+ *
+ * @param buffer Destination (always NUL-terminated when size > 0)
+ * @param size Capacity of buffer including the terminator
+ * @return Length the full output would have (>= size means truncated)
+ */
+int32_t kvsnprintf(char* buffer, uint32_t size, const char* format, __builtin_va_list args) {
+    FormatTarget target = { buffer, size ? size - 1 : 0, 0, 0, nullptr };
+    format_to(target, format, args);
+    if (size) {
+        buffer[target.pos] = '\0';
+    }
+    return (int32_t)target.total;
+}
+
+int32_t ksnprintf(char* buffer, uint32_t size, const char* format, ...) {
+    __builtin_va_list args;
+    __builtin_va_start(args, format);
+    int32_t len = kvsnprintf(buffer, size, format, args);
+    __builtin_va_end(args);
+    return len;
+}
+
+/**
+ * Format to an Output Sink
+ *
+ * Output shorter than FORMAT_CHUNK_SIZE reaches the sink as a single write.
+ *
+ * @return Number of bytes written
+ */
+uint32_t kprintf(OutputSink& out, const char* format, ...) {
+    char chunk[FORMAT_CHUNK_SIZE];
+    FormatTarget target = { chunk, sizeof(chunk), 0, 0, &out };
+    __builtin_va_list args;
+    __builtin_va_start(args, format);
+    format_to(target, format, args);
+    __builtin_va_end(args);
+    if (target.pos > 0) {
+        out.write(chunk, target.pos);
+    }
+    return target.total;
+}
@@ -0,0 +1,43 @@
+/*
+ * ============================================================================
+ * RusticOS Formatted Output Header (format.h)
+ * ============================================================================
+ *
+ * printf-style formatting for the kernel: ksnprintf() into a buffer and
+ * kprintf() into any OutputSink (terminal, file, pipe). Decimal conversion
+ * emits two digits per step from a digit-pair table, so a 32-bit number
+ * costs at most five divisions by the constant 100 (compiled to multiplies)
+ * and 64-bit numbers use three 32-bit chunks instead of 64-bit division.
+ *
+ * Supported format syntax: %[flags][width][length]conversion
+ *   flags       '-' left-justify, '0' pad numbers with zeros
+ *   width       decimal digits or '*' (taken from the arguments)
+ *   length      'l' (long), 'll' (64 bits), 'z' (size_t)
+ *   conversion  d i u x X p c s %
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include "types.h"
+
+class OutputSink;
+
+#define FORMAT_MAX_DIGITS   20      // Longest 64-bit decimal number
+
+// Number conversion (NUL-terminated; return the length)
+uint32_t format_u32(uint32_t value, char* buffer);      // Decimal; buffer >= 11 bytes
+uint32_t format_u64(uint64_t value, char* buffer);      // Decimal; buffer >= 21 bytes
+uint32_t format_hex(uint64_t value, char* buffer, bool upper);  // No prefix; buffer >= 17 bytes
+
+// Formatted output
+int32_t ksnprintf(char* buffer, uint32_t size, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));              // Returns the untruncated length
+int32_t kvsnprintf(char* buffer, uint32_t size, const char* format, __builtin_va_list args);
+uint32_t kprintf(OutputSink& out, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));              // Returns the number of bytes written
+
+#endif // FORMAT_H
@@ -0,0 +1,79 @@
+/*
+ * ============================================================================
+ * RusticOS QEMU Firmware Configuration Implementation (fwcfg.cpp)
+ * ============================================================================
+ *
+ * The file directory is a big-endian count followed by 64-byte entries
+ * (size, selector, reserved, name); it is scanned entry by entry without
+ * buffering it.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "fwcfg.h"
+
+static inline uint8_t inb(uint16_t port) {
+    uint8_t result;
+    asm volatile("inb %1, %0" : "=a"(result) : "Nd"(port));
+    return result;
+}
+
+static inline void outw(uint16_t port, uint16_t value) {
+    asm volatile("outw %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static void select_item(uint16_t item) {
+    outw(FW_CFG_PORT_SELECTOR, item);
+}
+
+static void read_bytes(void* buffer, uint32_t len) {
+    uint8_t* out = (uint8_t*)buffer;
+    for (uint32_t i = 0; i < len; ++i) {
+        out[i] = inb(FW_CFG_PORT_DATA);
+    }
+}
+
+static uint32_t read_be32() {
+    uint8_t b[4];
+    read_bytes(b, 4);
+    return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
+}
+
+bool fw_cfg_present() {
+    char signature[4];
+    select_item(FW_CFG_SIGNATURE);
+    read_bytes(signature, 4);
+    return signature[0] == 'Q' && signature[1] == 'E' && signature[2] == 'M' && signature[3] == 'U';
+}
+
+/**
+ * Read a Named Item
+ *
+ * @param name Item name, e.g. "opt/rusticos/cmdline"
+ * @param buffer Destination
+ * @param size Bytes available in buffer (the item is cut short to fit)
+ * @return Bytes copied, 0 if fw_cfg or the item is absent
+ */
+uint32_t fw_cfg_read_file(const char* name, void* buffer, uint32_t size) {
+    if (!fw_cfg_present()) {
+        return 0;
+    }
+    select_item(FW_CFG_FILE_DIR);
+    uint32_t count = read_be32();
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t file_size = read_be32();
+        uint8_t select[4];                  // Selector (big-endian) and reserved
+        read_bytes(select, 4);
+        char file_name[FW_CFG_FILE_NAME_MAX];
+        read_bytes(file_name, FW_CFG_FILE_NAME_MAX);
+        file_name[FW_CFG_FILE_NAME_MAX - 1] = '\0';
+        if (strcmp(file_name, name) == 0) {
+            uint32_t len = (file_size < size) ? file_size : size;
+            select_item((uint16_t)((select[0] << 8) | select[1]));
+            read_bytes(buffer, len);
+            return len;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * ============================================================================
+ * RusticOS QEMU Firmware Configuration Header (fwcfg.h)
+ * ============================================================================
+ *
+ * Read-only access to QEMU's fw_cfg device through its legacy I/O ports:
+ * write a 16-bit item selector, then read the item a byte at a time. Named
+ * items (-fw_cfg name=opt/...,string=... or file=...) are found through
+ * the file directory item. On other machines the signature check fails and
+ * every lookup reports "not present".
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef FWCFG_H
+#define FWCFG_H
+
+#include "types.h"
+
+// ============================================================================
+// fw_cfg Constants
+// ============================================================================
+#define FW_CFG_PORT_SELECTOR    0x510       // 16-bit item selector
+#define FW_CFG_PORT_DATA        0x511       // Item data, one byte per read
+
+#define FW_CFG_SIGNATURE        0x0000      // "QEMU"
+#define FW_CFG_FILE_DIR         0x0019      // Directory of named items
+#define FW_CFG_FILE_NAME_MAX    56
+
+// fw_cfg functions
+bool fw_cfg_present();                      // QEMU signature found
+uint32_t fw_cfg_read_file(const char* name, void* buffer, uint32_t size);  // Bytes copied (0 if absent)
+
+#endif // FWCFG_H
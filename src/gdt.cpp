@@ -0,0 +1,108 @@
+/*
+ * ============================================================================
+ * RusticOS Global Descriptor Table Implementation (gdt.cpp)
+ * ============================================================================
+ *
+ * Replaces the loader's three-entry GDT with the kernel's own table, which
+ * adds ring-3 segments and a TSS. Both the loader GDT and this one use a
+ * flat 4 GB model, so the switch is invisible to already running code.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "gdt.h"
+
+// GDT entry (must match the x86 segment descriptor format)
+struct GDTEntry {
+    uint16_t limit_low;
+    uint16_t base_low;
+    uint8_t  base_mid;
+    uint8_t  access;
+    uint8_t  granularity;   // Flags (high nibble) + limit bits 19:16 (low nibble)
+    uint8_t  base_high;
+} __attribute__((packed));
+
+struct GDTPointer {
+    uint16_t limit;
+    uintptr_t base;         // 32 or 64 bits, matching LGDT in the current mode
+} __attribute__((packed));
+
+static GDTEntry gdt_entries[GDT_ENTRY_COUNT];
+static GDTPointer gdt_pointer;
+static TaskStateSegment tss;
+
+/**
+ * Fill a GDT descriptor
+ *
+ * @param num Descriptor index
+ * @param base Segment base address
+ * @param limit Segment limit (20 bits, interpreted according to flags)
+ * @param access Access byte (P, DPL, S, Type)
+ * @param flags Flags nibble (G, D/B, L, AVL)
+ */
+static void gdt_set_entry(uint32_t num, uint32_t base, uint32_t limit, uint8_t access, uint8_t flags) {
+    gdt_entries[num].base_low    = base & 0xFFFF;
+    gdt_entries[num].base_mid    = (base >> 16) & 0xFF;
+    gdt_entries[num].base_high   = (base >> 24) & 0xFF;
+    gdt_entries[num].limit_low   = limit & 0xFFFF;
+    gdt_entries[num].granularity = (uint8_t)(((limit >> 16) & 0x0F) | (flags << 4));
+    gdt_entries[num].access      = access;
+}
+
+/**
+ * Initialize the Global Descriptor Table
+ *
+ * Builds the flat kernel/user segments and the TSS descriptor, loads the
+ * table, reloads every segment register and finally loads the task register.
+ * Must run before any ring-3 code is entered.
+ */
+void init_gdt() {
+    gdt_set_entry(0, 0, 0, 0, 0);                   // Null descriptor
+#ifdef __x86_64__
+    gdt_set_entry(1, 0, 0xFFFFF, 0x9A, 0xA);        // Kernel code: P, DPL0, code, exec/read, 64-bit (L)
+#else
+    gdt_set_entry(1, 0, 0xFFFFF, 0x9A, 0xC);        // Kernel code: P, DPL0, code, exec/read
+#endif
+    gdt_set_entry(2, 0, 0xFFFFF, 0x92, 0xC);        // Kernel data: P, DPL0, data, read/write
+    gdt_set_entry(3, 0, 0xFFFFF, 0xFA, 0xC);        // User code:   P, DPL3, code, exec/read
+    gdt_set_entry(4, 0, 0xFFFFF, 0xF2, 0xC);        // User data:   P, DPL3, data, read/write
+
+    // TSS: only the ring-0 stack matters; the I/O bitmap offset points past the limit
+    memset(&tss, 0, sizeof(tss));
+    tss.iomap_base = sizeof(tss);
+    uintptr_t tss_base = (uintptr_t)&tss;
+#ifdef __x86_64__
+    // The 16-byte long-mode TSS descriptor continues with base bits 63:32
+    gdt_set_entry(5, (uint32_t)tss_base, sizeof(tss) - 1, 0x89, 0x0);  // P, DPL0, 64-bit available TSS
+    gdt_set_entry(6, 0, 0, 0, 0);
+    gdt_entries[6].limit_low = (uint16_t)(tss_base >> 32);
+    gdt_entries[6].base_low  = (uint16_t)(tss_base >> 48);
+#else
+    tss.ss0 = GDT_KERNEL_DATA;
+    gdt_set_entry(5, tss_base, sizeof(tss) - 1, 0x89, 0x0);  // P, DPL0, 32-bit available TSS
+#endif
+
+    gdt_pointer.limit = sizeof(gdt_entries) - 1;
+    gdt_pointer.base  = (uintptr_t)&gdt_entries;
+
+    gdt_flush(&gdt_pointer);
+    tss_flush(GDT_TSS);
+}
+
+/**
+ * Set the kernel stack for ring 3 -> ring 0 transitions
+ *
+ * Called whenever a different user process is about to run, so that
+ * interrupts and exceptions taken in user mode land on that process's
+ * private kernel stack.
+ *
+ * @param esp0 Top of the kernel stack
+ */
+void tss_set_kernel_stack(uintptr_t esp0) {
+#ifdef __x86_64__
+    tss.rsp0 = esp0;
+#else
+    tss.esp0 = esp0;
+#endif
+}
@@ -0,0 +1,96 @@
+/*
+ * ============================================================================
+ * RusticOS Global Descriptor Table Header (gdt.h)
+ * ============================================================================
+ *
+ * Defines the kernel-owned GDT and Task State Segment (TSS). The loader's GDT
+ * only contains ring-0 segments; user-mode processes additionally need ring-3
+ * code/data segments and a TSS so the CPU knows which kernel stack to switch
+ * to when an interrupt or exception arrives from ring 3.
+ *
+ * Segment layout (the order is mandated by SYSENTER/SYSEXIT, which derive
+ * every selector from IA32_SYSENTER_CS):
+ *   0x00: Null descriptor
+ *   0x08: Kernel code (ring 0)
+ *   0x10: Kernel data (ring 0)       = SYSENTER_CS + 8
+ *   0x18: User code   (ring 3)       = SYSENTER_CS + 16
+ *   0x20: User data   (ring 3)       = SYSENTER_CS + 24
+ *   0x28: TSS (two slots on x86-64, where the descriptor is 16 bytes)
+ *
+ * On x86-64 the kernel code segment is a 64-bit (long mode) segment and the
+ * user segments run 32-bit programs in compatibility mode, so user programs
+ * are the same ELF32 binaries on both builds.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef GDT_H
+#define GDT_H
+
+#include "types.h"
+
+// ============================================================================
+// Segment Selectors
+// ============================================================================
+#define GDT_KERNEL_CODE     0x08    // Ring 0 code segment
+#define GDT_KERNEL_DATA     0x10    // Ring 0 data/stack segment
+#define GDT_USER_CODE       0x1B    // Ring 3 code segment (0x18 | RPL 3)
+#define GDT_USER_DATA       0x23    // Ring 3 data/stack segment (0x20 | RPL 3)
+#define GDT_TSS             0x28    // Task State Segment
+
+#ifdef __x86_64__
+#define GDT_ENTRY_COUNT     7
+#else
+#define GDT_ENTRY_COUNT     6
+#endif
+
+/**
+ * Task State Segment
+ *
+ * Only esp0/ss0 (rsp0 on x86-64) are used: RusticOS does not use hardware
+ * task switching, the TSS exists solely to provide the ring-0 stack for
+ * ring 3 -> ring 0 transitions through interrupt gates.
+ */
+#ifdef __x86_64__
+struct TaskStateSegment {
+    uint32_t reserved0;
+    uint64_t rsp0;          // Kernel stack pointer loaded on ring 3 -> ring 0 transitions
+    uint64_t rsp1;
+    uint64_t rsp2;
+    uint64_t reserved1;
+    uint64_t ist[7];        // Interrupt stack table (unused)
+    uint64_t reserved2;
+    uint16_t reserved3;
+    uint16_t iomap_base;    // Offset of I/O permission bitmap (past the limit = none)
+} __attribute__((packed));
+#else
+struct TaskStateSegment {
+    uint32_t prev_tss;
+    uint32_t esp0;          // Kernel stack pointer loaded on ring 3 -> ring 0 transitions
+    uint32_t ss0;           // Kernel stack segment loaded on ring 3 -> ring 0 transitions
+    uint32_t esp1;
+    uint32_t ss1;
+    uint32_t esp2;
+    uint32_t ss2;
+    uint32_t cr3;
+    uint32_t eip;
+    uint32_t eflags;
+    uint32_t eax, ecx, edx, ebx;
+    uint32_t esp, ebp, esi, edi;
+    uint32_t es, cs, ss, ds, fs, gs;
+    uint32_t ldt;
+    uint16_t trap;
+    uint16_t iomap_base;    // Offset of I/O permission bitmap (past the limit = none)
+} __attribute__((packed));
+#endif
+
+// GDT functions
+void init_gdt();                            // Build and load the kernel GDT and TSS
+void tss_set_kernel_stack(uintptr_t esp0);  // Set the ring-0 stack used for ring-3 interrupts
+
+// Assembly helpers (crt0.s)
+extern "C" void gdt_flush(const void* gdt_ptr);     // lgdt + reload all segment registers
+extern "C" void tss_flush(uint16_t selector);       // ltr
+
+#endif // GDT_H
@@ -0,0 +1,123 @@
+/*
+ * ============================================================================
+ * RusticOS Hex Dump Implementation (hexdump.cpp)
+ * ============================================================================
+ *
+ * Each row is built in a stack buffer and handed to the sink with a single
+ * write: on the terminal this is one call per 16 bytes instead of one per
+ * character. Bytes are converted with two nibble lookups and ASCII columns
+ * with a printable-character test, so the inner loop has no division and
+ * no formatted-output calls. Full rows are formatted straight from the
+ * caller's buffer; only the bytes of a row split across two feed() calls
+ * are copied.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "hexdump.h"
+#include "output.h"
+
+static const char hex_digits[] = "0123456789abcdef";
+
+// Column layout of a row
+#define HEXDUMP_HEX_COLUMN      10      // After "oooooooo  "
+#define HEXDUMP_ASCII_COLUMN    60      // After 16 "xx " groups, the mid gap and a space
+
+HexDumper::HexDumper(OutputSink& out, uint32_t offset)
+    : out(out), offset(offset), pending_len(0), have_previous(false), squeezing(false) {
+}
+
+/**
+ * Write 8 hex digits of value at line
+ */
+static void put_offset(char* line, uint32_t value) {
+    for (int32_t i = 7; i >= 0; --i) {
+        line[i] = hex_digits[value & 0xF];
+        value >>= 4;
+    }
+}
+
+static bool same_row(const uint8_t* a, const uint8_t* b) {
+    for (uint32_t i = 0; i < HEXDUMP_ROW_BYTES; ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * Format and Write One Row
+ *
+ * @param row Bytes of the row (starting at offset)
+ * @param len 1..HEXDUMP_ROW_BYTES; short rows are padded so the ASCII
+ *            column stays aligned
+ */
+void HexDumper::emit_row(const uint8_t* row, uint32_t len) {
+    if (len == HEXDUMP_ROW_BYTES) {
+        if (have_previous && same_row(row, previous)) {
+            if (!squeezing) {
+                out.write("*\n", 2);
+                squeezing = true;
+            }
+            offset += HEXDUMP_ROW_BYTES;
+            return;
+        }
+        memcpy(previous, row, HEXDUMP_ROW_BYTES);
+        have_previous = true;
+    }
+    squeezing = false;
+
+    char line[HEXDUMP_LINE_SIZE];
+    memset(line, ' ', sizeof(line));
+    put_offset(line, offset);
+    char* hex = line + HEXDUMP_HEX_COLUMN;
+    char* ascii = line + HEXDUMP_ASCII_COLUMN;
+    *ascii++ = '|';
+    for (uint32_t i = 0; i < len; ++i) {
+        uint8_t byte = row[i];
+        char* cell = hex + i * 3 + (i >= 8 ? 1 : 0);
+        cell[0] = hex_digits[byte >> 4];
+        cell[1] = hex_digits[byte & 0xF];
+        *ascii++ = (byte >= 0x20 && byte < 0x7F) ? (char)byte : '.';
+    }
+    *ascii++ = '|';
+    *ascii++ = '\n';
+    out.write(line, ascii - line);
+    offset += len;
+}
+
+void HexDumper::feed(const void* data, uint32_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+
+    // Complete a row left over from the previous call
+    if (pending_len > 0) {
+        uint32_t take = HEXDUMP_ROW_BYTES - pending_len;
+        if (take > len) take = len;
+        memcpy(pending + pending_len, bytes, take);
+        pending_len += take;
+        bytes += take;
+        len -= take;
+        if (pending_len < HEXDUMP_ROW_BYTES) {
+            return;
+        }
+        emit_row(pending, HEXDUMP_ROW_BYTES);
+        pending_len = 0;
+    }
+
+    for (; len >= HEXDUMP_ROW_BYTES; bytes += HEXDUMP_ROW_BYTES, len -= HEXDUMP_ROW_BYTES) {
+        emit_row(bytes, HEXDUMP_ROW_BYTES);
+    }
+    memcpy(pending, bytes, len);
+    pending_len = len;
+}
+
+void HexDumper::finish() {
+    if (pending_len > 0) {
+        emit_row(pending, pending_len);
+        pending_len = 0;
+    }
+    char line[9];
+    put_offset(line, offset);
+    line[8] = '\n';
+    out.write(line, sizeof(line));
+}
@@ -0,0 +1,57 @@
+/*
+ * ============================================================================
+ * RusticOS Hex Dump Header (hexdump.h)
+ * ============================================================================
+ *
+ * Canonical hex+ASCII dump used by the "hexdump" command:
+ *
+ *   00000000  7f 45 4c 46 01 01 01 00  00 00 00 00 00 00 00 00  |.ELF............|
+ *   *
+ *   00000200
+ *
+ * Rows identical to the one before are collapsed into a single "*" line,
+ * and the last line holds the offset just past the data. Input is fed in
+ * pieces of any size (file blocks, pipe reads, disk sectors), so memory use
+ * does not depend on the length of the dump.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef HEXDUMP_H
+#define HEXDUMP_H
+
+#include "types.h"
+
+class OutputSink;
+
+#define HEXDUMP_ROW_BYTES   16      // Input bytes per output line
+#define HEXDUMP_LINE_SIZE   80      // Formatted row including the newline
+
+/**
+ * HexDumper - formats a byte stream into rows on an output sink
+ */
+class HexDumper {
+public:
+    /**
+     * @param out Destination of the dump
+     * @param offset Offset printed for the first byte (e.g. lba * 512)
+     */
+    HexDumper(OutputSink& out, uint32_t offset);
+
+    void feed(const void* data, uint32_t len);  // Dump bytes; a partial row waits for more
+    void finish();                              // Flush the partial row and print the end offset
+
+private:
+    void emit_row(const uint8_t* row, uint32_t len);
+
+    OutputSink& out;
+    uint32_t offset;                            // Offset of the first byte in pending
+    uint8_t pending[HEXDUMP_ROW_BYTES];         // Bytes of the row being collected
+    uint32_t pending_len;
+    uint8_t previous[HEXDUMP_ROW_BYTES];        // Last full row printed (for "*")
+    bool have_previous;
+    bool squeezing;                             // "*" already printed for this run
+};
+
+#endif // HEXDUMP_H
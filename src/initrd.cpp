@@ -0,0 +1,56 @@
+/*
+ * ============================================================================
+ * RusticOS Initial Ramdisk Implementation (initrd.cpp)
+ * ============================================================================
+ *
+ * Validates the archive relocated by crt0.s and exposes its files as
+ * read-only external files in /bin. File data is never copied.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "initrd.h"
+#include "filesystem.h"
+
+extern FileSystem filesystem;
+
+/**
+ * Initialize the Initial Ramdisk
+ *
+ * Entries that point outside the archive are skipped rather than trusted.
+ * Must run before the shell changes the current directory.
+ *
+ * @return Number of files added to /bin
+ */
+uint32_t init_initrd() {
+    if (initrd_size < sizeof(InitrdHeader)) {
+        return 0;  // No archive loaded
+    }
+    const InitrdHeader* header = (const InitrdHeader*)(uintptr_t)initrd_base;
+    if (header->magic != INITRD_MAGIC || header->version != INITRD_VERSION ||
+        header->file_count > (initrd_size - sizeof(InitrdHeader)) / sizeof(InitrdEntry)) {
+        return 0;
+    }
+
+    filesystem.mkdir(INITRD_MOUNT_DIR);
+    if (!filesystem.cd(INITRD_MOUNT_DIR)) {
+        return 0;
+    }
+
+    const InitrdEntry* entries = (const InitrdEntry*)(header + 1);
+    uint32_t added = 0;
+    for (uint32_t i = 0; i < header->file_count; ++i) {
+        const InitrdEntry& entry = entries[i];
+        if (entry.offset > initrd_size || entry.size > initrd_size - entry.offset ||
+            entry.name[INITRD_NAME_LENGTH - 1] != '\0') {
+            continue;  // Corrupt entry
+        }
+        if (filesystem.add_external_file(entry.name, (const char*)(uintptr_t)(initrd_base + entry.offset), entry.size)) {
+            added++;
+        }
+    }
+
+    filesystem.cd("/");
+    return added;
+}
@@ -0,0 +1,56 @@
+/*
+ * ============================================================================
+ * RusticOS Initial Ramdisk Header (initrd.h)
+ * ============================================================================
+ *
+ * Defines the initial ramdisk (initrd) archive format. The build packs user
+ * programs into build/initrd.img (scripts/mkinitrd.py), the disk image places
+ * it right after the kernel and the loader reads both in one pass. crt0.s
+ * moves the archive out of the way of .bss before any C++ code runs.
+ *
+ * Archive layout (little endian):
+ *   InitrdHeader
+ *   InitrdEntry[file_count]
+ *   File data, each file starting on a 4 KB boundary
+ *
+ * The archive itself is relocated to a page boundary, so every file's data
+ * is page aligned in memory and can be mapped into processes without copying.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef INITRD_H
+#define INITRD_H
+
+#include "types.h"
+
+// ============================================================================
+// Initrd Constants
+// ============================================================================
+#define INITRD_MAGIC            0x44524952      // "RIRD"; keep in sync with crt0.s and mkinitrd.py
+#define INITRD_VERSION          1
+#define INITRD_NAME_LENGTH      32
+#define INITRD_MOUNT_DIR        "bin"           // Files appear under /bin
+
+struct InitrdHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t file_count;
+    uint32_t total_size;            // Bytes, including header and padding
+};
+
+struct InitrdEntry {
+    char name[INITRD_NAME_LENGTH];  // NUL-terminated file name
+    uint32_t offset;                // From the start of the archive (page aligned)
+    uint32_t size;
+};
+
+// Set by crt0.s after relocating the archive (size is 0 if there is none)
+extern "C" uint32_t initrd_base;
+extern "C" uint32_t initrd_size;
+
+// Initrd functions
+uint32_t init_initrd();     // Publish the archive's files in /bin; returns the file count
+
+#endif // INITRD_H
@@ -19,7 +19,11 @@
 
 #include "interrupt.h"
 #include "keyboard.h"
+#include "task.h"
 #include "terminal.h"
+#include "process.h"
+#include "format.h"
+#include "params.h"
 
 extern Terminal terminal;
 extern KeyboardDriver keyboard;
@@ -28,139 +32,8 @@ extern KeyboardDriver keyboard;
 // The PIT typically runs at ~18.2 Hz (54.9 ms per tick) by default
 static volatile uint64_t system_ticks = 0;
 
-// External references to ISR and IRQ stubs (defined in crt0.s)
-extern "C" {
-    extern void isr0();
-    extern void isr1();
-    extern void isr2();
-    extern void isr3();
-    extern void isr4();
-    extern void isr5();
-    extern void isr6();
-    extern void isr7();
-    extern void isr8();
-    extern void isr9();
-    extern void isr10();
-    extern void isr11();
-    extern void isr12();
-    extern void isr13();
-    extern void isr14();
-    extern void isr15();
-    extern void isr16();
-    extern void isr17();
-    extern void isr18();
-    extern void isr19();
-    extern void isr20();
-    extern void isr21();
-    extern void isr22();
-    extern void isr23();
-    extern void isr24();
-    extern void isr25();
-    extern void isr26();
-    extern void isr27();
-    extern void isr28();
-    extern void isr29();
-    extern void isr30();
-    extern void isr31();
-    extern void irq32();
-    extern void irq33();
-    extern void irq34();
-    extern void irq35();
-    extern void irq36();
-    extern void irq37();
-    extern void irq38();
-    extern void irq39();
-    extern void irq40();
-    extern void irq41();
-    extern void irq42();
-    extern void irq43();
-    extern void irq44();
-    extern void irq45();
-    extern void irq46();
-    extern void irq47();
-}
-
-// IDT Entry structure (must match x86 IDT format)
-struct IDTEntry {
-    uint16_t offset_low;
-    uint16_t selector;
-    uint8_t  zero;
-    uint8_t  type_attr;
-    uint16_t offset_high;
-} __attribute__((packed));
-
-// External IDT (defined in crt0.s)
-extern "C" {
-    extern IDTEntry idt[256];
-}
-
-/**
- * Set an IDT entry
- */
-static void idt_set_gate(uint8_t num, uint32_t base, uint16_t selector, uint8_t flags) {
-    idt[num].offset_low  = (base & 0xFFFF);
-    idt[num].offset_high = (base >> 16) & 0xFFFF;
-    idt[num].selector    = selector;
-    idt[num].zero        = 0;
-    idt[num].type_attr   = flags;
-}
-
-/**
- * Initialize the Interrupt Descriptor Table
- */
-extern "C" void init_idt() {
-    // Set up exception handlers (0-31)
-    idt_set_gate(0,  (uint32_t)isr0,  0x08, 0x8E);  // Divide by Zero
-    idt_set_gate(1,  (uint32_t)isr1,  0x08, 0x8E);  // Debug
-    idt_set_gate(2,  (uint32_t)isr2,  0x08, 0x8E);  // NMI
-    idt_set_gate(3,  (uint32_t)isr3,  0x08, 0x8E);  // Breakpoint
-    idt_set_gate(4,  (uint32_t)isr4,  0x08, 0x8E);  // Overflow
-    idt_set_gate(5,  (uint32_t)isr5,  0x08, 0x8E);  // Bound Range
-    idt_set_gate(6,  (uint32_t)isr6,  0x08, 0x8E);  // Invalid Opcode
-    idt_set_gate(7,  (uint32_t)isr7,  0x08, 0x8E);  // Device Not Available
-    idt_set_gate(8,  (uint32_t)isr8,  0x08, 0x8E);  // Double Fault
-    idt_set_gate(9,  (uint32_t)isr9,  0x08, 0x8E);  // Coprocessor Segment
-    idt_set_gate(10, (uint32_t)isr10, 0x08, 0x8E);  // Invalid TSS
-    idt_set_gate(11, (uint32_t)isr11, 0x08, 0x8E);  // Segment Not Present
-    idt_set_gate(12, (uint32_t)isr12, 0x08, 0x8E);  // Stack Fault
-    idt_set_gate(13, (uint32_t)isr13, 0x08, 0x8E);  // General Protection Fault
-    idt_set_gate(14, (uint32_t)isr14, 0x08, 0x8E);  // Page Fault
-    idt_set_gate(15, (uint32_t)isr15, 0x08, 0x8E);  // Reserved
-    idt_set_gate(16, (uint32_t)isr16, 0x08, 0x8E);  // x87 FPU Error
-    idt_set_gate(17, (uint32_t)isr17, 0x08, 0x8E);  // Alignment Check
-    idt_set_gate(18, (uint32_t)isr18, 0x08, 0x8E);  // Machine Check
-    idt_set_gate(19, (uint32_t)isr19, 0x08, 0x8E);  // SIMD Exception
-    idt_set_gate(20, (uint32_t)isr20, 0x08, 0x8E);  // Virtualization
-    idt_set_gate(21, (uint32_t)isr21, 0x08, 0x8E);  // Control Protection
-    idt_set_gate(22, (uint32_t)isr22, 0x08, 0x8E);  // Reserved
-    idt_set_gate(23, (uint32_t)isr23, 0x08, 0x8E);  // Reserved
-    idt_set_gate(24, (uint32_t)isr24, 0x08, 0x8E);  // Reserved
-    idt_set_gate(25, (uint32_t)isr25, 0x08, 0x8E);  // Reserved
-    idt_set_gate(26, (uint32_t)isr26, 0x08, 0x8E);  // Reserved
-    idt_set_gate(27, (uint32_t)isr27, 0x08, 0x8E);  // Reserved
-    idt_set_gate(28, (uint32_t)isr28, 0x08, 0x8E);  // Hypervisor
-    idt_set_gate(29, (uint32_t)isr29, 0x08, 0x8E);  // VMM Communication
-    idt_set_gate(30, (uint32_t)isr30, 0x08, 0x8E);  // Security
-    idt_set_gate(31, (uint32_t)isr31, 0x08, 0x8E);  // Reserved
-    
-    // Set up IRQ handlers (32-47)
-    idt_set_gate(32, (uint32_t)irq32, 0x08, 0x8E);  // Timer (IRQ0)
-    idt_set_gate(33, (uint32_t)irq33, 0x08, 0x8E);  // Keyboard (IRQ1)
-    idt_set_gate(34, (uint32_t)irq34, 0x08, 0x8E);  // Cascade (IRQ2)
-    idt_set_gate(35, (uint32_t)irq35, 0x08, 0x8E);  // COM2 (IRQ3)
-    idt_set_gate(36, (uint32_t)irq36, 0x08, 0x8E);  // COM1 (IRQ4)
-    idt_set_gate(37, (uint32_t)irq37, 0x08, 0x8E);  // LPT2 (IRQ5)
-    idt_set_gate(38, (uint32_t)irq38, 0x08, 0x8E);  // Floppy (IRQ6)
-    idt_set_gate(39, (uint32_t)irq39, 0x08, 0x8E);  // LPT1 (IRQ7)
-    idt_set_gate(40, (uint32_t)irq40, 0x08, 0x8E);  // CMOS (IRQ8)
-    idt_set_gate(41, (uint32_t)irq41, 0x08, 0x8E);  // Free (IRQ9)
-    idt_set_gate(42, (uint32_t)irq42, 0x08, 0x8E);  // Free (IRQ10)
-    idt_set_gate(43, (uint32_t)irq43, 0x08, 0x8E);  // Free (IRQ11)
-    idt_set_gate(44, (uint32_t)irq44, 0x08, 0x8E);  // PS/2 Mouse (IRQ12)
-    idt_set_gate(45, (uint32_t)irq45, 0x08, 0x8E);  // FPU (IRQ13)
-    idt_set_gate(46, (uint32_t)irq46, 0x08, 0x8E);  // Primary ATA (IRQ14)
-    idt_set_gate(47, (uint32_t)irq47, 0x08, 0x8E);  // Secondary ATA (IRQ15)
-}
+// The IDT and the ISR/IRQ stubs it points to are defined in crt0.s, which
+// builds the table at assembly time and loads it before kernel_main
 
 /**
  * Initialize the Programmable Interrupt Controller (PIC)
@@ -291,8 +164,11 @@ void disable_irq(uint8_t irq) {
 /**
  * IRQ Handler - called from assembly ISR stubs
  * Routes IRQs to appropriate device drivers
+ * 
+ * @param irq IRQ number (0-15)
+ * @param cs Code segment of the interrupted code (RPL 3 = ring-3 process)
  */
-extern "C" void irq_handler(uint8_t irq) {
+extern "C" void irq_handler(uint8_t irq, uint32_t cs) {
     switch (irq) {
         case IRQ_TIMER:
             // Timer interrupt - increment system clock tick counter
@@ -305,6 +181,9 @@ extern "C" void irq_handler(uint8_t irq) {
             uint8_t scan_code;
             asm volatile("inb %1, %0" : "=a"(scan_code) : "Nd"((uint16_t)0x60));
             keyboard.handle_interrupt(scan_code);
+            if (keyboard.take_interrupt()) {
+                task_interrupt_foreground();  // Ctrl+C
+            }
             break;
         }
         
@@ -315,6 +194,11 @@ extern "C" void irq_handler(uint8_t irq) {
     
     // Send End of Interrupt to PIC
     send_eoi(irq);
+    
+    // Only user code may be switched out here: kernel tasks are cooperative
+    if (irq == IRQ_TIMER && (cs & 3) == 3) {
+        task_preempt_user();
+    }
 }
 
 /**
@@ -357,45 +241,6 @@ static const char* exception_names[32] = {
     "Reserved (31)"
 };
 
-/**
- * Helper function to convert number to hex string
- */
-static void uint32_to_hex(uint32_t value, char* buffer) {
-    buffer[0] = '0';
-    buffer[1] = 'x';
-    for (int i = 7; i >= 0; i--) {
-        uint8_t nibble = (value >> (i * 4)) & 0xF;
-        buffer[9 - i] = (nibble < 10) ? ('0' + nibble) : ('A' + nibble - 10);
-    }
-    buffer[10] = '\0';
-}
-
-/**
- * Helper function to convert number to decimal string
- */
-static void uint32_to_string(uint32_t value, char* buffer) {
-    if (value == 0) {
-        buffer[0] = '0';
-        buffer[1] = '\0';
-        return;
-    }
-    
-    char rev_buf[16];
-    int rev_pos = 0;
-    uint32_t temp = value;
-    
-    while (temp > 0) {
-        rev_buf[rev_pos++] = '0' + (temp % 10);
-        temp /= 10;
-    }
-    
-    int pos = 0;
-    for (int i = rev_pos - 1; i >= 0; i--) {
-        buffer[pos++] = rev_buf[i];
-    }
-    buffer[pos] = '\0';
-}
-
 /**
  * Exception Handler - called from assembly ISR stubs for CPU exceptions
  * 
@@ -403,10 +248,13 @@ static void uint32_to_string(uint32_t value, char* buffer) {
  * - Exception name
  * - Exception vector number
  * - Error code (if applicable)
+ * - Faulting address (EIP, and CR2 for page faults)
+ * 
+ * Exceptions raised in ring 3 kill the offending process and return to
+ * the kernel; exceptions raised in the kernel halt the system.
  */
-extern "C" void exception_handler(uint8_t vector, uint32_t error_code) {
-    char num_buf[32];
-    char hex_buf[16];
+extern "C" void exception_handler(uint8_t vector, uint32_t error_code, uint32_t eip, uint32_t cs) {
+    char line[64];
     
     terminal.write("\n=== EXCEPTION ===\n");
     
@@ -418,29 +266,37 @@ extern "C" void exception_handler(uint8_t vector, uint32_t error_code) {
     }
     
     // Display vector number
-    terminal.write("Vector: ");
-    uint32_to_string((uint32_t)vector, num_buf);
-    terminal.write(num_buf);
-    terminal.write("\n");
+    ksnprintf(line, sizeof(line), "Vector: %u\n", (uint32_t)vector);
+    terminal.write(line);
     
     // Display error code (if applicable)
     // Some exceptions don't push an error code, but we'll display it anyway
     // The error code is meaningful for exceptions 8, 10-14, 17, 21
     if (vector == 8 || (vector >= 10 && vector <= 14) || vector == 17 || vector == 21) {
-        terminal.write("Error Code: ");
-        uint32_to_hex(error_code, hex_buf);
-        terminal.write(hex_buf);
-        terminal.write(" (");
-        uint32_to_string(error_code, num_buf);
-        terminal.write(num_buf);
-        terminal.write(")\n");
+        ksnprintf(line, sizeof(line), "Error Code: 0x%08X (%u)\n", error_code, error_code);
+        terminal.write(line);
+    }
+    
+    // Display faulting instruction (and faulting address for page faults)
+    ksnprintf(line, sizeof(line), "EIP: 0x%08X\n", eip);
+    terminal.write(line);
+    if (vector == 14) {
+        uintptr_t cr2;
+        asm volatile("mov %%cr2, %0" : "=r"(cr2));
+        ksnprintf(line, sizeof(line), "Address: 0x%08lX\n", cr2);
+        terminal.write(line);
     }
     
     terminal.write("==================\n");
     
-    // Halt for exceptions (except page fault, double fault which we might want to handle)
-    if (vector != 14) {  // Don't halt on page fault (not implemented yet)
-        terminal.write("System halted.\n");
+    // Faults in user mode only take down the process
+    if ((cs & 3) == 3 && process_current()) {
+        process_fault(vector, error_code, eip);  // Does not return
+    }
+    
+    // Kernel faults are fatal (returning would re-execute the faulting instruction)
+    terminal.write("System halted.\n");
+    for (;;) {
         asm volatile("cli; hlt");  // Disable interrupts and halt
     }
 }
@@ -468,13 +324,17 @@ void disable_interrupts() {
 /**
  * Initialize the Programmable Interval Timer (PIT)
  * 
- * Configures the PIT channel 0 to generate interrupts at the default frequency
- * (~18.2 Hz). This is called automatically during system initialization.
+ * Configures the PIT channel 0 to generate interrupts at the pit_hz kernel
+ * parameter (default PIT_DEFAULT_FREQUENCY, ~18.2 Hz). This is called
+ * automatically during system initialization.
  */
 void init_pit() {
-    set_pit_frequency(PIT_DEFAULT_FREQUENCY);
+    set_pit_frequency((uint16_t)param_get(PARAM_PIT_HZ));
 }
 
+// Channel 0 divisor in effect (the BIOS default of 65536 until init_pit)
+static uint32_t pit_divisor = 65536;
+
 /**
  * Set PIT frequency
  * 
@@ -495,6 +355,7 @@ void set_pit_frequency(uint16_t frequency) {
     
     // Calculate divisor
     uint16_t divisor = (uint16_t)(PIT_BASE_FREQUENCY / frequency);
+    pit_divisor = divisor;
     
     // Disable interrupts temporarily during PIT configuration
     disable_interrupts();
@@ -536,29 +397,90 @@ uint64_t get_ticks() {
 /**
  * Get elapsed seconds since boot
  * 
- * Calculates seconds based on tick count. Assumes PIT frequency of ~18.2 Hz
- * (approximately 18.2 ticks per second).
+ * Calculates seconds based on tick count and the programmed PIT divisor
+ * (each tick lasts divisor / PIT_BASE_FREQUENCY seconds).
  * 
  * @return Elapsed seconds since boot
  */
 uint64_t get_seconds() {
-    // PIT runs at ~18.2 Hz, so divide ticks by 18.2 (or multiply by 10/182)
-    // Using integer math: ticks * 10 / 182 ≈ ticks / 18.2
-    return (system_ticks * 10) / 182;
+    return div_u64(system_ticks * pit_divisor, PIT_BASE_FREQUENCY);
 }
 
 /**
  * Get elapsed milliseconds since boot
  * 
- * Calculates milliseconds based on tick count. Assumes PIT frequency of ~18.2 Hz
- * (approximately 54.9 ms per tick).
+ * Calculates milliseconds based on tick count and the programmed PIT
+ * divisor, so any pit_hz setting reports real time.
  * 
  * @return Elapsed milliseconds since boot
  */
 uint64_t get_milliseconds() {
-    // PIT runs at ~18.2 Hz, so each tick is ~54.9 ms
-    // Using integer math: ticks * 549 / 10 ≈ ticks * 54.9
-    return (system_ticks * 549) / 10;
+    return div_u64(system_ticks * pit_divisor * 1000, PIT_BASE_FREQUENCY);
+}
+
+/**
+ * ============================================================================
+ * Time-Stamp Counter Calibration
+ * ============================================================================
+ */
+
+static uint32_t tsc_khz = 0;
+
+/**
+ * Calibrate the TSC against the PIT
+ * 
+ * Runs PIT channel 2 as a one-shot (mode 0) for TSC_CALIBRATE_MS and counts
+ * the TSC cycles until its output (port 0x61 bit 5) goes high. Channel 2 is
+ * gated through port 0x61 and raises no interrupt, so channel 0 (the system
+ * clock) is undisturbed.
+ */
+void calibrate_tsc() {
+    const uint16_t count = PIT_BASE_FREQUENCY / (1000 / TSC_CALIBRATE_MS);
+    uint8_t port61;
+    asm volatile("inb %1, %0" : "=a"(port61) : "Nd"((uint16_t)PIT_GATE_PORT));
+    uint8_t saved = port61;
+    port61 = (port61 & ~0x02) | 0x01;       // Speaker off, channel 2 gate on
+    asm volatile("outb %0, %1" : : "a"(port61), "Nd"((uint16_t)PIT_GATE_PORT));
+    
+    // Channel 2, low byte then high byte, mode 0 (interrupt on terminal count), binary
+    asm volatile("outb %0, %1" : : "a"((uint8_t)0xB0), "Nd"((uint16_t)PIT_COMMAND));
+    asm volatile("outb %0, %1" : : "a"((uint8_t)(count & 0xFF)), "Nd"((uint16_t)PIT_CH2_DATA));
+    asm volatile("outb %0, %1" : : "a"((uint8_t)(count >> 8)), "Nd"((uint16_t)PIT_CH2_DATA));
+    
+    uint64_t start = read_tsc();
+    uint32_t spins = 0;
+    do {
+        asm volatile("inb %1, %0" : "=a"(port61) : "Nd"((uint16_t)PIT_GATE_PORT));
+    } while (!(port61 & 0x20) && ++spins < 0x1000000);
+    uint64_t elapsed = read_tsc() - start;
+    
+    asm volatile("outb %0, %1" : : "a"(saved), "Nd"((uint16_t)PIT_GATE_PORT));
+    tsc_khz = (uint32_t)div_u64(elapsed, TSC_CALIBRATE_MS);
+}
+
+/**
+ * Get TSC Frequency
+ * 
+ * @return TSC frequency in kHz (0 if calibration has not run)
+ */
+uint32_t get_tsc_khz() {
+    return tsc_khz;
+}
+
+/**
+ * Convert TSC Cycles to Microseconds
+ * 
+ * @param cycles Cycle count (e.g. the difference of two read_tsc() values)
+ * @return Elapsed microseconds (0 if the TSC is not calibrated)
+ */
+uint64_t tsc_to_us(uint64_t cycles) {
+    if (tsc_khz == 0) {
+        return 0;
+    }
+    // Split to keep cycles * 1000 from overflowing for long intervals
+    uint64_t ms = div_u64(cycles, tsc_khz);
+    uint64_t rest = cycles - ms * tsc_khz;
+    return ms * 1000 + div_u64(rest * 1000, tsc_khz);
 }
 
 /**
@@ -627,6 +549,25 @@ static bool wait_rtc_update() {
     return false;  // Timeout
 }
 
+/**
+ * Days in a Month
+ * 
+ * @param month 1-12
+ * @param year Two-digit year (leap years simplified - assumes 2000s)
+ */
+static uint8_t rtc_days_in_month(uint8_t month, uint8_t year) {
+    if (month == 2) {
+        // February: check for leap year
+        return (year % 4 == 0) ? 29 : 28;
+    }
+    if (month == 4 || month == 6 || month == 9 || month == 11) {
+        // April, June, September, November
+        return 30;
+    }
+    // All other months
+    return 31;
+}
+
 /**
  * Get current Real-Time Clock time
  * 
@@ -756,29 +697,36 @@ bool get_rtc_time(RTCTime* time) {
         }
     }
     
-    // Apply timezone offset (RTC typically stores UTC time)
-    hour += RTC_TIMEZONE_OFFSET;
-    if (hour >= 24) {
-        hour -= 24;
+    // Apply timezone offset (RTC typically stores UTC time; tz kernel parameter)
+    int32_t local_hour = (int32_t)hour + param_get(PARAM_TZ_OFFSET);
+    if (local_hour >= 0 && local_hour < 24) {
+        hour = (uint8_t)local_hour;
+    } else if (local_hour < 0) {
+        hour = (uint8_t)(local_hour + 24);
+        // Handle day rollback
+        day--;
+        if (day == 0) {
+            month--;
+            if (month == 0) {
+                month = 12;
+                if (year == 0) {
+                    year = 99;
+                    if (century > 0) {
+                        century--;
+                    }
+                } else {
+                    year--;
+                }
+            }
+            day = rtc_days_in_month(month, year);
+        }
+    } else if (local_hour >= 24) {
+        hour = (uint8_t)(local_hour - 24);
         // Handle day rollover
         day++;
         
-        // Get number of days in current month
-        uint8_t days_in_month;
-        if (month == 2) {
-            // February: check for leap year (simplified - assumes 2000s)
-            bool is_leap = (year % 4 == 0);
-            days_in_month = is_leap ? 29 : 28;
-        } else if (month == 4 || month == 6 || month == 9 || month == 11) {
-            // April, June, September, November
-            days_in_month = 30;
-        } else {
-            // All other months
-            days_in_month = 31;
-        }
-        
         // Handle month rollover
-        if (day > days_in_month) {
+        if (day > rtc_days_in_month(month, year)) {
             day = 1;
             month++;
             if (month > 12) {
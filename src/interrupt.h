@@ -44,7 +44,9 @@
 
 // PIT Configuration
 #define PIT_BASE_FREQUENCY  1193182   // PIT base frequency in Hz
-#define PIT_DEFAULT_FREQUENCY 18      // Default frequency (~18.2 Hz)
+#define PIT_DEFAULT_FREQUENCY 18      // Default frequency (~18.2 Hz; pit_hz kernel parameter)
+#define PIT_GATE_PORT   0x61          // Channel 2 gate (bit 0) / output (bit 5), speaker enable (bit 1)
+#define TSC_CALIBRATE_MS 10           // Length of the TSC calibration window
 
 // ============================================================================
 // RTC (Real-Time Clock) / CMOS I/O Ports
@@ -73,7 +75,7 @@
 // Timezone offset (hours from UTC)
 // Helsinki, Finland: UTC+2 (EET) or UTC+3 (EEST during daylight saving)
 // Adjust this value if needed: +2 for EET, +3 for EEST
-#define RTC_TIMEZONE_OFFSET  2  // Hours to add to UTC time
+#define RTC_TIMEZONE_OFFSET  2  // Hours to add to UTC time (default of the tz kernel parameter)
 
 // ============================================================================
 // IRQ Definitions (Hardware Interrupt Requests)
@@ -99,11 +101,6 @@
 #define IRQ_PRIMARY_ATA 14    // Primary ATA hard disk (IRQ14) - Slave PIC
 #define IRQ_SECONDARY_ATA 15  // Secondary ATA hard disk (IRQ15) - Slave PIC
 
-// Function declarations
-extern "C" {
-    void init_idt();  // Called from assembly, needs C linkage
-}
-
 // C++ functions
 void init_pic();
 void enable_interrupts();
@@ -119,14 +116,29 @@ void init_pit();                          // Initialize PIT with default frequen
 void set_pit_frequency(uint16_t frequency); // Set PIT frequency in Hz
 
 // IRQ handler functions (called from assembly ISR stubs)
-extern "C" void irq_handler(uint8_t irq);
-extern "C" void exception_handler(uint8_t vector, uint32_t error_code);
+extern "C" void irq_handler(uint8_t irq, uint32_t cs);
+extern "C" void exception_handler(uint8_t vector, uint32_t error_code, uint32_t eip, uint32_t cs);
 
 // System clock functions
 uint64_t get_ticks();           // Get current tick count
 uint64_t get_seconds();         // Get elapsed seconds since boot
 uint64_t get_milliseconds();    // Get elapsed milliseconds since boot
 
+/**
+ * Read the CPU Time-Stamp Counter
+ * @return Cycles since reset
+ */
+static inline uint64_t read_tsc() {
+    uint32_t low, high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+}
+
+// TSC calibration
+void calibrate_tsc();                   // Measure the TSC frequency with PIT channel 2
+uint32_t get_tsc_khz();                 // TSC frequency in kHz (0 if uncalibrated)
+uint64_t tsc_to_us(uint64_t cycles);    // Convert a cycle count to microseconds
+
 // Real-Time Clock (RTC) structure
 struct RTCTime {
     uint8_t second;     // 0-59
@@ -12,9 +12,10 @@
  *   - Integration with command-line interface and filesystem
  * 
  * Architecture:
- *   - Runs in 32-bit protected mode
+ *   - Runs in 32-bit protected mode (64-bit long mode in the x86-64 build)
  *   - Uses interrupt-driven I/O (keyboard via IRQ1)
  *   - Timer interrupt (IRQ0) available for future scheduling
+ *   - Cooperative kernel tasks run pipeline stages (the shell is task 0)
  *   - All hardware access via direct I/O port operations
  * 
  * Version: 1.0.1
@@ -27,6 +28,18 @@
 #include "filesystem.h"
 #include "command.h"
 #include "interrupt.h"
+#include "gdt.h"
+#include "paging.h"
+#include "syscall.h"
+#include "initrd.h"
+#include "task.h"
+#include "serial.h"
+#include "output.h"
+#include "boottime.h"
+#include "bootinfo.h"
+#include "params.h"
+#include "virtual_disk.h"
+#include "format.h"
 
 /* ============================================================================
  * HARDWARE CONSTANTS & MACROS
@@ -45,13 +58,6 @@
 #define CRTC_CURSOR_HIGH 0x0E  // Cursor location high byte
 #define CRTC_CURSOR_LOW  0x0F  // Cursor location low byte
 
-// Serial Port (COM1) Constants
-#define SERIAL_PORT     0x3F8
-#define SERIAL_BAUD_DIV 0x01   // Divisor for 115200 baud
-#define SERIAL_IER      (SERIAL_PORT + 1)
-#define SERIAL_FCR      (SERIAL_PORT + 2)
-#define SERIAL_LCR      (SERIAL_PORT + 3)
-
 // PS/2 Keyboard Port Constants
 #define KBD_DATA_PORT   0x60
 #define KBD_STAT_PORT   0x64
@@ -69,7 +75,7 @@
 // VGA Color Attributes (GREEN bg, BLACK text)
 #define VGA_GREEN_BLACK 0x2000
 
-// Timing Constants (loop counts for delays)
+// Timing Constants (loop counts for delays and polling timeouts)
 #define DELAY_SHORT     10000
 #define DELAY_MEDIUM    100000
 
@@ -85,7 +91,6 @@ extern KeyboardDriver keyboard;
  * ============================================================================ */
 
 static void set_cursor_position(uint8_t row, uint8_t col);
-static void serial_write(const char* str);
 
 /* ============================================================================
  * INLINE I/O PORT OPERATIONS
@@ -111,6 +116,21 @@ static inline void outb(uint16_t port, uint8_t value) {
     __asm__ __volatile__("outb %0, %1" : : "a"(value), "Nd"(port));
 }
 
+/**
+ * Fixed settle delay
+ *
+ * A FAST_BOOT build skips these blind waits; where the hardware has to be
+ * ready, the caller also polls its status bit.
+ * @param loops Busy-loop iterations
+ */
+static inline void boot_delay(int loops) {
+#ifndef FAST_BOOT
+    for (volatile int i = 0; i < loops; i++);
+#else
+    (void)loops;
+#endif
+}
+
 /* ============================================================================
  * SIMPLE VGA TEXT PRINTER
  * ============================================================================ */
@@ -327,7 +347,7 @@ bool poll_keyboard() {
             if (command_system.is_input_complete()) {
                 command_system.execute_command();
                 command_system.reset_input();
-                terminal.write("> ");  // Display prompt for next command (newline already printed by process_input)
+                terminal.write(command_system.prompt());  // Display prompt for next command (newline already printed by process_input)
             }
         }
     }
@@ -342,51 +362,6 @@ bool poll_keyboard() {
  * HARDWARE INITIALIZATION
  * ============================================================================ */
 
-/**
- * Write a string to serial port for debugging
- * 
- * Used during boot to provide status messages.
- * Output appears on COM1 (115200 baud).
- * 
- * @param str Null-terminated string to output
- */
-static void serial_write(const char* str) {
-    while (*str) {
-        outb(SERIAL_PORT, *str);
-        // Small delay to ensure output completes
-        for (volatile int i = 0; i < DELAY_SHORT; i++);
-        str++;
-    }
-}
-
-/**
- * ============================================================================
- * Initialize Serial Port (COM1)
- * ============================================================================
- * 
- * Configures COM1 (serial port) for debugging output at 115200 baud.
- * Serial output appears on COM1 and can be captured via QEMU's -serial option.
- * 
- * Configuration:
- *   - Port: COM1 (0x3F8)
- *   - Baud rate: 115200 (divisor = 1)
- *   - Data bits: 8
- *   - Parity: None
- *   - Stop bits: 1
- *   - FIFO: Enabled (14-byte threshold)
- * 
- * All kernel initialization messages are sent here for debugging.
- * ============================================================================
- */
-static void init_serial() {
-    outb(SERIAL_IER, 0x00);        // Disable all interrupts
-    outb(SERIAL_LCR, 0x80);        // Enable DLAB (set baud rate divisor)
-    outb(SERIAL_PORT, SERIAL_BAUD_DIV);     // Set divisor low byte (115200 baud)
-    outb(SERIAL_IER, 0x00);        // Set divisor high byte to 0
-    outb(SERIAL_LCR, 0x03);        // Disable DLAB, set 8 bits, no parity, 1 stop
-    outb(SERIAL_FCR, 0xC7);        // Enable FIFO, clear it, set level to 14 bytes
-}
-
 /**
  * ============================================================================
  * Initialize VGA Text Mode Display
@@ -401,7 +376,7 @@ static void init_serial() {
  * Initialization Steps:
  *   1. Fill entire VGA buffer (80x25 = 2000 characters) with spaces
  *      This ensures the display is initialized and visible
- *   2. Wait for hardware to stabilize (delay loop)
+ *   2. Wait for hardware to stabilize (delay loop, skipped by FAST_BOOT)
  *   3. Access VGA status register to confirm display is active
  *   4. Set initial cursor position to (0, 0) via CRTC registers
  * 
@@ -421,12 +396,12 @@ static void init_vga() {
     }
     
     // Small delay to ensure writes are processed
-    for (volatile int delay = 0; delay < DELAY_MEDIUM; delay++);
+    boot_delay(DELAY_MEDIUM);
     
     // Step 2: Access VGA status register to confirm display is active
     // uint8_t status = inb(VGA_STATUS_PORT);
     // (void)status;  // Suppress unused variable warning
-    for (volatile int i = 0; i < DELAY_SHORT; i++);
+    boot_delay(DELAY_SHORT);
     
     // Step 3: Set initial cursor position to 0,0 via CRTC registers
     outb(VGA_CRTC_INDEX, CRTC_CURSOR_HIGH);
@@ -434,7 +409,7 @@ static void init_vga() {
     outb(VGA_CRTC_INDEX, CRTC_CURSOR_LOW);
     outb(VGA_CRTC_DATA, 0x00);
     
-    for (volatile int i = 0; i < DELAY_SHORT; i++);
+    boot_delay(DELAY_SHORT);
 }
 
 /**
@@ -455,7 +430,7 @@ static void set_cursor_position(uint8_t row, uint8_t col) {
     outb(VGA_CRTC_INDEX, CRTC_CURSOR_LOW);
     outb(VGA_CRTC_DATA, (uint8_t)(pos & 0xFF));
     
-    for (volatile int i = 0; i < DELAY_SHORT; i++);
+    boot_delay(DELAY_SHORT);
 }
 
 /**
@@ -506,8 +481,9 @@ static bool wait_kbd_data() {
  * ============================================================================
  */
 static void init_keyboard() {
-    // Wait for keyboard controller to be ready
-    for (volatile int i = 0; i < DELAY_MEDIUM; i++);
+    // Wait for keyboard controller to be ready (input buffer empty)
+    boot_delay(DELAY_MEDIUM);
+    wait_kbd_ready();
     
     // Clear any pending data from keyboard buffer
     // This is important to avoid processing stale scan codes
@@ -517,7 +493,7 @@ static void init_keyboard() {
         } else {
             break;
         }
-        for (volatile int j = 0; j < DELAY_SHORT; j++);
+        boot_delay(DELAY_SHORT);
     }
     
     // Reset shift state
@@ -526,6 +502,27 @@ static void init_keyboard() {
     last_scan_code = 0;
 }
 
+/**
+ * Reserve Memory Sized by Kernel Parameters
+ * 
+ * Runs after init_paging(): the heap (beyond its static pool) and the
+ * virtual disk take their memory from the region above the kernel image.
+ */
+static void reserve_boot_memory() {
+    uint32_t heap_bytes = (uint32_t)param_get(PARAM_HEAP_KB) * 1024;
+    if (heap_bytes > HEAP_POOL_SIZE) {
+        void* region = reserve_kernel_memory(heap_bytes);
+        if (region) {
+            heap_add_region(region, heap_bytes);
+        } else {
+            serial_write("heap_kb: not enough memory, keeping the static heap\n");
+        }
+    }
+    if (!vdisk.init((uint32_t)param_get(PARAM_VDISK_SECTORS))) {
+        serial_write("vdisk_sectors: not enough memory, virtual disk disabled\n");
+    }
+}
+
 /* ============================================================================
  * KERNEL MAIN ENTRY POINT
  * ============================================================================ */
@@ -538,27 +535,47 @@ static void init_keyboard() {
  * This is the main entry point called by the loader after entering protected mode.
  * It performs all system initialization and then enters the main event loop.
  * 
+ * @param magic BOOT_INFO_MAGIC, or a Multiboot magic (see multiboot.h)
+ * @param info_addr The loader's boot information block or Multiboot information
+ * 
  * Initialization Sequence:
- *   1. Initialize serial port (COM1) for debug output
+ *   1. Initialize serial port (COM1) for debug output, read kernel parameters
  *   2. Initialize VGA text mode display
  *   3. Set up terminal interface and display welcome screen
  *   4. Initialize interrupt handling (PIC, IDT)
- *   5. Initialize keyboard driver and clear buffer
- *   6. Enable interrupts (STI)
- *   7. Enter main event loop (interrupt-driven)
+ *   5. Install GDT/TSS, enable paging, reserve parameter-sized memory,
+ *      set up system calls, mount initrd
+ *   6. Initialize keyboard driver and clear buffer
+ *   7. Enable interrupts (STI)
+ *   8. Enter main event loop (interrupt-driven)
  * 
- * The kernel runs in 32-bit protected mode with interrupts enabled.
+ * The kernel runs in 32-bit protected mode (long mode on x86-64) with
+ * interrupts enabled.
  * Hardware I/O is interrupt-driven (keyboard via IRQ1, timer via IRQ0).
  * ============================================================================
  */
-extern "C" void kernel_main() {
+extern "C" void kernel_main(uint32_t magic, uint32_t info_addr) {
     // ========================================================================
     // Phase 1: Serial Port Initialization
     // ========================================================================
     // Initialize serial port for debugging output (COM1, 115200 baud)
     // All initialization messages are sent to serial for debugging purposes
+    boot_timeline_init();    // Copy the loader's stamps before low memory is reused
     init_serial();
+    #ifdef __x86_64__
+    serial_write("===== RusticOS Kernel Starting (v1.0.1, x86-64) =====\n");
+#else
     serial_write("===== RusticOS Kernel Starting (v1.0.1) =====\n");
+#endif
+    if (boot_info_init(magic, info_addr)) {
+        kprintf(serial_sink, "Boot info: %llu KiB usable RAM, command line \"%s\"\n",
+                boot_usable_memory() >> 10, boot_cmdline());
+    } else {
+        serial_write("No boot information from the loader\n");
+    }
+    params_init(boot_cmdline());   // Kernel parameters, read by the init code below
+    params_print(serial_sink);
+    boot_stamp("serial");
     
     // ========================================================================
     // Phase 2: VGA Display Initialization
@@ -568,6 +585,7 @@ extern "C" void kernel_main() {
     // This triggers QEMU/VGA hardware initialization
     serial_write("Initializing VGA text mode display...\n");
     init_vga();
+    boot_stamp("vga");
     
     // ========================================================================
     // Phase 3: Terminal Setup
@@ -587,6 +605,7 @@ extern "C" void kernel_main() {
     terminal.writeAt("> ", 0, 5);
     terminal.setCursor(2, 5);  // Position cursor after "> " prompt
     serial_write("Terminal interface ready.\n");
+    boot_stamp("terminal");
     
     // ========================================================================
     // Phase 4: Interrupt System Initialization
@@ -595,23 +614,49 @@ extern "C" void kernel_main() {
     serial_write("Initializing interrupt handling system...\n");
     init_pic();              // Initialize Programmable Interrupt Controller (remap IRQs)
     init_pit();              // Initialize Programmable Interval Timer (PIT)
-    // Note: IDT is already initialized in crt0.s via init_idt() call
+    calibrate_tsc();         // Measure the TSC rate against PIT channel 2
+    // Note: the IDT is a static table in crt0.s, loaded before kernel_main
+    boot_stamp("pic, pit, tsc calibration");
     
     // ========================================================================
-    // Phase 5: Keyboard Driver Initialization
+    // Phase 5: Protection and User Mode Support
+    // ========================================================================
+    // Install the kernel GDT (ring-3 segments + TSS), enable paging and
+    // program the system call entry points used by user processes
+    serial_write("Initializing GDT, paging and system calls...\n");
+    init_gdt();
+    init_paging();
+    reserve_boot_memory();
+    init_syscalls();
+    serial_write(syscall_has_sysenter() ? "System calls: SYSENTER fast path\n"
+                                        : "System calls: INT 0x80 fallback\n");
+    boot_stamp("gdt, paging, syscalls");
+    
+    // The boot context becomes task 0; pipelines spawn further tasks
+    init_tasks();
+    
+    // Publish the user programs from the initial ramdisk in /bin
+    serial_write(init_initrd() ? "Initrd mounted at /bin\n" : "No initrd found\n");
+    boot_stamp("tasks, initrd");
+    
+    // ========================================================================
+    // Phase 6: Keyboard Driver Initialization
     // ========================================================================
     // Initialize keyboard driver and clear any stale scan codes
     serial_write("Initializing keyboard driver...\n");
-    keyboard.init();         // Initialize keyboard driver internal state
+    keyboard.init(param_get(PARAM_KBD_BUFFER));  // Initialize keyboard driver internal state
     init_keyboard();         // Clear keyboard buffer and reset controller state
+    boot_stamp("keyboard");
     
     // ========================================================================
-    // Phase 6: Enable Interrupts and Start System
+    // Phase 7: Enable Interrupts and Start System
     // ========================================================================
     // Enable interrupts (STI) - system is now fully operational
     serial_write("Enabling interrupts...\n");
     enable_interrupts();
+    boot_stamp("interrupts enabled");
     serial_write("===== RusticOS Kernel Ready (Interrupt-driven) =====\n");
+    boot_timeline_print(serial_sink);
     
     // ========================================================================
     // Main Kernel Event Loop
@@ -622,6 +667,12 @@ extern "C" void kernel_main() {
     // than polling the keyboard port directly.
     // ========================================================================
     while (true) {
+        // Ctrl+C at the prompt discards the line being typed
+        if (task_cancelled()) {
+            command_system.reset_input();  // Prints "^C"
+            terminal.write(command_system.prompt());
+        }
+        
         // Check for keyboard events (filled by interrupt handler)
         KeyEvent event;
         if (keyboard.get_key_event(event)) {
@@ -634,11 +685,14 @@ extern "C" void kernel_main() {
                 if (command_system.is_input_complete()) {
                     command_system.execute_command();
                     command_system.reset_input();
-                    terminal.write("> ");  // Display prompt for next command
+                    terminal.write(command_system.prompt());  // Display prompt for next command
                 }
             }
         }
         
+        // Let background jobs run between keystrokes
+        task_yield();
+        
         // Small delay to prevent excessive CPU usage when no events are pending
         // This allows the CPU to enter a lower power state between events
         // Much more efficient than the previous polling approach
@@ -24,20 +24,25 @@
 static bool key_state[256];
 
 KeyboardDriver::KeyboardDriver()
-    : head(0), tail(0), shift_pressed(false), ctrl_pressed(false), alt_pressed(false)
+    : capacity(KEYBOARD_BUFFER_DEFAULT), head(0), tail(0), shift_pressed(false), ctrl_pressed(false), alt_pressed(false),
+      interrupt_requested(false)
 {
     for (int i = 0; i < 256; ++i) {
         key_state[i] = false;
     }
 }
 
-void KeyboardDriver::init()
+void KeyboardDriver::init(uint32_t buffer_size)
 {
+    if (buffer_size < 2) buffer_size = 2;
+    if (buffer_size > KEYBOARD_BUFFER_MAX) buffer_size = KEYBOARD_BUFFER_MAX;
+    capacity = buffer_size;
     head = 0;
     tail = 0;
     shift_pressed = false;
     ctrl_pressed = false;
     alt_pressed = false;
+    interrupt_requested = false;
     
     for (int i = 0; i < 256; ++i) {
         key_state[i] = false;
@@ -130,6 +135,12 @@ void KeyboardDriver::handle_interrupt(uint8_t scan_code)
     // Update global key state table
     key_state[code] = !released;
 
+    // Ctrl+C interrupts the foreground job instead of producing input
+    if (!released && ctrl_pressed && code == KEY_C) {
+        interrupt_requested = true;
+        return;
+    }
+
     // Only queue events for key press (not release)
     if (!released) {
         KeyEvent event;
@@ -141,10 +152,10 @@ void KeyboardDriver::handle_interrupt(uint8_t scan_code)
         event.alt = alt_pressed;
 
         // Push to circular buffer
-        uint32_t next = (head + 1) % KEYBOARD_BUFFER_SIZE;
+        uint32_t next = (head + 1 == capacity) ? 0 : head + 1;
         if (next == tail) {
             // Buffer full, drop oldest event
-            tail = (tail + 1) % KEYBOARD_BUFFER_SIZE;
+            tail = (tail + 1 == capacity) ? 0 : tail + 1;
         }
         buffer[head] = event;
         head = next;
@@ -158,7 +169,16 @@ bool KeyboardDriver::get_key_event(KeyEvent& event)
     }
 
     event = buffer[tail];
-    tail = (tail + 1) % KEYBOARD_BUFFER_SIZE;
+    tail = (tail + 1 == capacity) ? 0 : tail + 1;
+    return true;
+}
+
+bool KeyboardDriver::take_interrupt()
+{
+    if (!interrupt_requested) {
+        return false;
+    }
+    interrupt_requested = false;
     return true;
 }
 
@@ -22,6 +22,11 @@
 
 #include "types.h"
 
+// Event queue length: KEYBOARD_BUFFER_DEFAULT unless the kbd_buffer kernel
+// parameter asks for another length (up to KEYBOARD_BUFFER_MAX)
+#define KEYBOARD_BUFFER_DEFAULT 256
+#define KEYBOARD_BUFFER_MAX     1024
+
 /**
  * Key Event Structure
  * 
@@ -70,26 +75,28 @@ enum KeyCode {
 
 class KeyboardDriver {
 private:
-    static const uint32_t KEYBOARD_BUFFER_SIZE = 256;
-    KeyEvent buffer[KEYBOARD_BUFFER_SIZE];
+    KeyEvent buffer[KEYBOARD_BUFFER_MAX];
+    uint32_t capacity;              // Entries in use as the ring (one stays empty)
     uint32_t head;
     uint32_t tail;
     bool shift_pressed;
     bool ctrl_pressed;
     bool alt_pressed;
+    volatile bool interrupt_requested;   // Ctrl+C seen, not yet taken
 
     uint8_t scan_code_to_ascii(uint8_t scan_code, bool shift);
 
 public:
     KeyboardDriver();
 
-    void init();
+    void init(uint32_t buffer_size = KEYBOARD_BUFFER_DEFAULT);  // Reset; clamped to 2..KEYBOARD_BUFFER_MAX
     void handle_interrupt(uint8_t scan_code);
     bool get_key_event(KeyEvent& event);
     bool is_key_pressed(uint8_t scan_code);
     bool is_shift_pressed() const { return shift_pressed; }
     bool is_ctrl_pressed()  const { return ctrl_pressed; }
     bool is_alt_pressed()   const { return alt_pressed; }
+    bool take_interrupt();          // True once per Ctrl+C (not queued as a key event)
 };
 
 extern KeyboardDriver keyboard;
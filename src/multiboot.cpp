@@ -0,0 +1,236 @@
+/*
+ * ============================================================================
+ * RusticOS Multiboot Support Implementation (multiboot.cpp)
+ * ============================================================================
+ *
+ * The loader's structures may lie anywhere in memory, including right above
+ * the kernel image where the initrd and reserve_kernel_memory() go, so
+ * everything is copied into the BootInfo before the module is placed.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "multiboot.h"
+#include "initrd.h"
+#include "paging.h"
+
+extern "C" char __image_end[];
+extern "C" char __initrd_start[];
+
+/**
+ * Multiboot Information Structure (the fields used here)
+ */
+struct MultibootInfo {
+    uint32_t flags;                 // MULTIBOOT_INFO_*
+    uint32_t mem_lower, mem_upper;
+    uint32_t boot_device;           // BIOS drive in the top byte
+    uint32_t cmdline;
+    uint32_t mods_count, mods_addr;
+    uint32_t syms[4];
+    uint32_t mmap_length, mmap_addr;
+} __attribute__((packed));
+
+struct MultibootModule {
+    uint32_t mod_start, mod_end;
+    uint32_t string, reserved;
+} __attribute__((packed));
+
+struct MultibootMmapEntry {
+    uint32_t size;                  // Bytes that follow this field
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+} __attribute__((packed));
+
+/**
+ * Multiboot2 Information Tags
+ */
+struct Multiboot2Tag {
+    uint32_t type;                  // MULTIBOOT2_TAG_*
+    uint32_t size;                  // Including this header, not the padding to 8 bytes
+};
+
+struct Multiboot2Module {
+    Multiboot2Tag tag;
+    uint32_t mod_start, mod_end;
+    char string[];
+};
+
+struct Multiboot2Mmap {
+    Multiboot2Tag tag;
+    uint32_t entry_size, entry_version;
+};
+
+struct Multiboot2MmapEntry {
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+    uint32_t reserved;
+};
+
+// ============================================================================
+// Translation Helpers
+// ============================================================================
+
+static void add_range(BootInfo* info, uint64_t base, uint64_t length, uint32_t type) {
+    if (info->e820_count == BOOT_E820_MAX) {
+        return;
+    }
+    E820Entry& entry = info->e820[info->e820_count++];
+    entry.base = base;
+    entry.length = length;
+    entry.type = type;
+    entry.acpi = 1;                 // "Valid" in the ACPI 3.0 attribute sense
+    info->flags |= BOOT_INFO_HAS_E820;
+}
+
+/**
+ * Copy the Command Line, Dropping the Image Path
+ *
+ * Multiboot loaders put the kernel's file name in front of the arguments;
+ * a leading word without '=' is taken to be that name.
+ */
+static void set_cmdline(BootInfo* info, const char* text) {
+    const char* p = text;
+    while (*p && *p != ' ' && *p != '=') p++;
+    if (*p != '=') {
+        text = p;
+    }
+    while (*text == ' ') text++;
+    strncpy(info->cmdline, text, BOOT_CMDLINE_MAX);
+    info->cmdline[BOOT_CMDLINE_MAX - 1] = '\0';
+    if (info->cmdline[0]) {
+        info->flags |= BOOT_INFO_HAS_CMDLINE;
+    }
+}
+
+/**
+ * Make a Module the Initial Ramdisk
+ *
+ * The module is used in place when it lies between the kernel image and the
+ * frame pool (QEMU and GRUB put it right above the kernel); otherwise it is
+ * copied to __initrd_start, where the disk path relocates it too.
+ */
+static void set_initrd(BootInfo* info, uint32_t start, uint32_t end) {
+    uint32_t base = (uint32_t)(uintptr_t)__initrd_start;
+    uint32_t size = end - start;
+    if (end <= start) {
+        return;
+    }
+    if (start < base || end > FRAME_POOL_START) {
+        if (size > FRAME_POOL_START - base || (start < base + size && end > base)) {
+            return;                 // No room, or the copy would overlap itself
+        }
+        memcpy(__initrd_start, (const void*)(uintptr_t)start, size);
+        start = base;
+    }
+    initrd_base = start;
+    initrd_size = size;
+    info->image_size += size;
+}
+
+// ============================================================================
+// Multiboot and Multiboot2
+// ============================================================================
+
+static bool read_multiboot(const MultibootInfo* mbi, BootInfo* info) {
+    if (mbi->flags & MULTIBOOT_INFO_BOOTDEV) {
+        info->boot_drive = mbi->boot_device >> 24;
+    }
+    if (mbi->flags & MULTIBOOT_INFO_MMAP) {
+        uint32_t addr = mbi->mmap_addr;
+        uint32_t end = mbi->mmap_addr + mbi->mmap_length;
+        while (addr + sizeof(MultibootMmapEntry) <= end) {
+            const MultibootMmapEntry* entry = (const MultibootMmapEntry*)(uintptr_t)addr;
+            add_range(info, entry->base, entry->length, entry->type);
+            addr += entry->size + sizeof(entry->size);
+        }
+    }
+    if ((mbi->flags & MULTIBOOT_INFO_CMDLINE) && mbi->cmdline) {
+        set_cmdline(info, (const char*)(uintptr_t)mbi->cmdline);
+    }
+    if ((mbi->flags & MULTIBOOT_INFO_MODS) && mbi->mods_count > 0) {
+        const MultibootModule* module = (const MultibootModule*)(uintptr_t)mbi->mods_addr;
+        set_initrd(info, module->mod_start, module->mod_end);
+    }
+    return true;
+}
+
+static bool read_multiboot2(uint32_t info_addr, BootInfo* info) {
+    uint32_t total_size = *(const uint32_t*)(uintptr_t)info_addr;
+    if (total_size < 16) {
+        return false;
+    }
+    uint32_t module_start = 0, module_end = 0;
+    uint32_t addr = info_addr + 8;
+    uint32_t end = info_addr + total_size;
+    while (addr + sizeof(Multiboot2Tag) <= end) {
+        const Multiboot2Tag* tag = (const Multiboot2Tag*)(uintptr_t)addr;
+        if (tag->type == MULTIBOOT2_TAG_END || tag->size < sizeof(Multiboot2Tag)) {
+            break;
+        }
+        switch (tag->type) {
+            case MULTIBOOT2_TAG_CMDLINE:
+                set_cmdline(info, (const char*)(tag + 1));
+                break;
+            case MULTIBOOT2_TAG_BOOTDEV:
+                info->boot_drive = *(const uint32_t*)(tag + 1);
+                break;
+            case MULTIBOOT2_TAG_MMAP: {
+                const Multiboot2Mmap* mmap = (const Multiboot2Mmap*)tag;
+                if (mmap->entry_size < sizeof(Multiboot2MmapEntry)) {
+                    break;
+                }
+                for (uint32_t off = sizeof(Multiboot2Mmap); off + mmap->entry_size <= tag->size;
+                     off += mmap->entry_size) {
+                    const Multiboot2MmapEntry* entry = (const Multiboot2MmapEntry*)(uintptr_t)(addr + off);
+                    add_range(info, entry->base, entry->length, entry->type);
+                }
+                break;
+            }
+            case MULTIBOOT2_TAG_MODULE:
+                if (module_end == 0) {
+                    const Multiboot2Module* module = (const Multiboot2Module*)tag;
+                    module_start = module->mod_start;
+                    module_end = module->mod_end;
+                }
+                break;
+        }
+        addr += (tag->size + 7) & ~7u;
+    }
+    if (module_end) {
+        set_initrd(info, module_start, module_end);
+    }
+    return true;
+}
+
+bool multiboot_magic(uint32_t magic) {
+    return magic == MULTIBOOT_BOOTLOADER_MAGIC || magic == MULTIBOOT2_BOOTLOADER_MAGIC;
+}
+
+/**
+ * Translate a Multiboot Information Structure
+ *
+ * @param magic EAX at kernel entry
+ * @param info_addr EBX at kernel entry
+ * @param info Block to fill (fields the loader cannot provide stay zero)
+ * @return false if magic is not a Multiboot magic or the structure is unusable
+ */
+bool multiboot_read_info(uint32_t magic, uint32_t info_addr, BootInfo* info) {
+    if (!multiboot_magic(magic) || info_addr == 0) {
+        return false;
+    }
+    memset(info, 0, sizeof(BootInfo));
+    info->magic = BOOT_INFO_MAGIC;
+    info->version = BOOT_INFO_VERSION;
+    info->size = sizeof(BootInfo);
+    info->flags = BOOT_INFO_MULTIBOOT;
+    info->kernel_addr = MULTIBOOT_KERNEL_ADDR;
+    info->kernel_size = (uint32_t)(uintptr_t)__image_end - MULTIBOOT_KERNEL_ADDR;
+    info->image_size = info->kernel_size;
+    if (magic == MULTIBOOT_BOOTLOADER_MAGIC) {
+        return read_multiboot((const MultibootInfo*)(uintptr_t)info_addr, info);
+    }
+    return read_multiboot2(info_addr, info);
+}
@@ -0,0 +1,52 @@
+/*
+ * ============================================================================
+ * RusticOS Multiboot Support Header (multiboot.h)
+ * ============================================================================
+ *
+ * Besides the RusticOS boot sector and loader, the kernel ELF can be started
+ * by any Multiboot (QEMU -kernel/-initrd) or Multiboot2 (GRUB 2) loader;
+ * crt0.s carries both headers. Such a loader puts its magic in EAX and an
+ * information structure in EBX. multiboot_read_info() translates that
+ * structure into the BootInfo block the RusticOS loader would have passed,
+ * so the rest of the kernel sees one format:
+ *
+ *   - memory map          -> e820[] (same range types)
+ *   - command line        -> cmdline (the image path in front is dropped)
+ *   - boot device         -> boot_drive
+ *   - first module        -> the initial ramdisk (initrd_base/initrd_size)
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef MULTIBOOT_H
+#define MULTIBOOT_H
+
+#include "types.h"
+#include "bootinfo.h"
+
+// ============================================================================
+// Multiboot Constants
+// ============================================================================
+#define MULTIBOOT_BOOTLOADER_MAGIC  0x2BADB002  // EAX from a Multiboot loader
+#define MULTIBOOT2_BOOTLOADER_MAGIC 0x36D76289  // EAX from a Multiboot2 loader
+#define MULTIBOOT_KERNEL_ADDR       0x00100000  // Load address (linker.ld)
+
+// Multiboot information flags
+#define MULTIBOOT_INFO_BOOTDEV      0x002
+#define MULTIBOOT_INFO_CMDLINE      0x004
+#define MULTIBOOT_INFO_MODS         0x008
+#define MULTIBOOT_INFO_MMAP         0x040
+
+// Multiboot2 information tag types
+#define MULTIBOOT2_TAG_END          0
+#define MULTIBOOT2_TAG_CMDLINE      1
+#define MULTIBOOT2_TAG_MODULE       3
+#define MULTIBOOT2_TAG_BOOTDEV      5
+#define MULTIBOOT2_TAG_MMAP         6
+
+// Multiboot support functions
+bool multiboot_magic(uint32_t magic);      // EAX came from a Multiboot or Multiboot2 loader
+bool multiboot_read_info(uint32_t magic, uint32_t info_addr, BootInfo* info);  // Fill a BootInfo; false if malformed
+
+#endif // MULTIBOOT_H
@@ -0,0 +1,86 @@
+/*
+ * ============================================================================
+ * RusticOS Output Sink Implementation (output.cpp)
+ * ============================================================================
+ *
+ * Implements the buffered sinks (terminal and file) and the serial sink.
+ * Pipe sinks live in pipe.cpp.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "output.h"
+#include "terminal.h"
+#include "filesystem.h"
+#include "serial.h"
+
+extern Terminal terminal;
+
+// ============================================================================
+// BufferedSink
+// ============================================================================
+
+void BufferedSink::write(const char* data, uint32_t len) {
+    if (used + len > OUTPUT_BLOCK_SIZE) {
+        flush();
+        if (len >= OUTPUT_BLOCK_SIZE) {
+            write_block(data, len);
+            return;
+        }
+    }
+    memcpy(buffer + used, data, len);
+    used += len;
+}
+
+void BufferedSink::flush() {
+    if (used > 0) {
+        write_block(buffer, used);
+        used = 0;
+    }
+}
+
+// ============================================================================
+// TerminalSink
+// ============================================================================
+
+void TerminalSink::write_block(const char* data, uint32_t len) {
+    terminal.write(data, len);
+}
+
+TerminalSink terminal_sink;
+
+// ============================================================================
+// SerialSink
+// ============================================================================
+
+void SerialSink::write(const char* data, uint32_t len) {
+    serial_write(data, len);
+}
+
+SerialSink serial_sink;
+
+// ============================================================================
+// FileSink
+// ============================================================================
+
+void FileSink::open(FileNode* node) {
+    file = node;
+    failed = false;
+    file->open_count++;
+}
+
+void FileSink::close() {
+    flush();
+    file->open_count--;
+    file = nullptr;
+}
+
+void FileSink::write_block(const char* data, uint32_t len) {
+    if (!file || failed) {
+        return;
+    }
+    if (!filesystem.append(file, data, len)) {
+        failed = true;
+    }
+}
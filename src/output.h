@@ -0,0 +1,101 @@
+/*
+ * ============================================================================
+ * RusticOS Output Sink Header (output.h)
+ * ============================================================================
+ *
+ * Defines the byte-stream interface commands write their output to. A
+ * command never knows where its output ends up: the shell hands it a sink
+ * that may be the terminal, a file ("cmd > file") or the write end of a
+ * pipe.
+ *
+ * Terminal and file sinks collect small writes in an OUTPUT_BLOCK_SIZE
+ * buffer and pass them on in blocks. Pipes are buffers themselves and copy
+ * each write straight into their ring.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include "types.h"
+
+struct FileNode;
+
+#define OUTPUT_BLOCK_SIZE   512     // Bytes collected before a buffered sink writes through
+
+/**
+ * OutputSink - destination for a command's output
+ *
+ * Implementations override write(data, len); the string and character
+ * helpers funnel into it.
+ */
+class OutputSink {
+public:
+    virtual void write(const char* data, uint32_t len) = 0;  // Write len bytes (may block)
+    virtual void flush() {}                                   // Push out any buffered bytes
+
+    void write(const char* str) { write(str, strlen(str)); }
+    void put(char c) { write(&c, 1); }
+};
+
+/**
+ * BufferedSink - collects writes and hands them to write_block() in blocks
+ *
+ * Writes at least as large as the buffer bypass it.
+ */
+class BufferedSink : public OutputSink {
+private:
+    char buffer[OUTPUT_BLOCK_SIZE];
+    uint32_t used;
+
+protected:
+    virtual void write_block(const char* data, uint32_t len) = 0;
+
+public:
+    BufferedSink() : used(0) {}
+    using OutputSink::write;
+    void write(const char* data, uint32_t len) override;
+    void flush() override;
+};
+
+/**
+ * TerminalSink - writes to the VGA terminal
+ */
+class TerminalSink : public BufferedSink {
+protected:
+    void write_block(const char* data, uint32_t len) override;
+};
+
+/**
+ * SerialSink - writes to COM1 (unbuffered; the port is polled per byte)
+ */
+class SerialSink : public OutputSink {
+public:
+    using OutputSink::write;
+    void write(const char* data, uint32_t len) override;
+};
+
+/**
+ * FileSink - appends to a file in the filesystem
+ */
+class FileSink : public BufferedSink {
+private:
+    FileNode* file;
+    bool failed;                    // An append ran out of memory
+
+protected:
+    void write_block(const char* data, uint32_t len) override;
+
+public:
+    FileSink() : file(nullptr), failed(false) {}
+    void open(FileNode* node);      // Start appending to node
+    void close();                   // Flush and detach
+    bool ok() const { return !failed; }
+};
+
+extern TerminalSink terminal_sink;
+extern SerialSink serial_sink;
+
+#endif // OUTPUT_H
@@ -0,0 +1,426 @@
+/*
+ * ============================================================================
+ * RusticOS Pager Implementation (pager.cpp)
+ * ============================================================================
+ *
+ * The document is data[0..size). For a file it is the file's own buffer;
+ * for a pipe it is a window of PAGER_WINDOW bytes that holds the document
+ * from offset base on. lines[] is a window of the line index as well: it
+ * holds the start offsets of lines first_line .. line_count-1, and is
+ * extended by index_lines() only up to the line the view or a search asks
+ * for, reading more input when the known text runs out.
+ *
+ * When either window fills up, slide() drops the lines before pin (the
+ * first line the current view or search still needs), keeping the last
+ * screen. A file re-indexes from its start when the view goes back past
+ * first_line; dropped piped input is gone, so the view stops at the first
+ * line still held.
+ *
+ * Every redraw writes the 24 rows straight into VGA memory with
+ * Terminal::writeRow.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "pager.h"
+#include "terminal.h"
+#include "keyboard.h"
+#include "pipe.h"
+#include "task.h"
+#include "format.h"
+
+extern Terminal terminal;
+extern KeyboardDriver keyboard;
+
+// Screen layout
+#define PAGER_WIDTH         80
+#define PAGER_FIRST_ROW     1       // Below the title bar
+#define PAGER_ROWS          23      // Text rows; the status line follows
+
+/**
+ * Pager State
+ */
+struct Pager {
+    const char* name;
+    const char* data;               // Document text from offset base on
+    uint32_t base;                  // Document offset of data[0] (0 for a file)
+    uint32_t size;                  // Document bytes known so far
+    bool complete;                  // size is the whole document
+    Pipe* input;                    // Source of piped input (nullptr for a file)
+    char* buffer;                   // Window of piped input (owned)
+    uint32_t* lines;                // Start offsets of lines first_line .. line_count-1 (owned)
+    uint32_t first_line;
+    uint32_t line_count;
+    uint32_t pin;                   // First line that must stay in the windows
+    uint32_t scanned;               // Bytes checked for line starts
+    uint32_t top;                   // First line on screen
+    char pattern[PAGER_PATTERN_LENGTH];
+    char message[PAGER_WIDTH];      // Shown in the status line until the next key
+};
+
+static Pager pg;
+
+// ============================================================================
+// Document and Line Index
+// ============================================================================
+
+/**
+ * Drop the Lines before pin
+ *
+ * The last screen of lines found so far always stays, so the view can be
+ * put at the end of the document. Piped text before the first kept line is
+ * dropped with it.
+ *
+ * @return false if nothing could be dropped
+ */
+static bool slide() {
+    uint32_t keep = pg.pin;
+    uint32_t last_screen = (pg.line_count > PAGER_ROWS) ? pg.line_count - PAGER_ROWS : 0;
+    if (keep > last_screen) keep = last_screen;
+    if (keep <= pg.first_line) {
+        return false;
+    }
+    uint32_t dropped = keep - pg.first_line;
+    uint32_t kept = pg.line_count - keep;
+    for (uint32_t i = 0; i < kept; ++i) {
+        pg.lines[i] = pg.lines[dropped + i];
+    }
+    pg.first_line = keep;
+    if (pg.input) {
+        uint32_t base = pg.lines[0];
+        uint32_t shift = base - pg.base;
+        for (uint32_t i = 0; i < pg.size - base; ++i) {
+            pg.buffer[i] = pg.buffer[shift + i];
+        }
+        pg.base = base;
+    }
+    return true;
+}
+
+/**
+ * Read More Piped Input
+ *
+ * @return false at the end of the document (or when the window is full of
+ *         lines the view still needs)
+ */
+static bool read_more() {
+    if (pg.complete) {
+        return false;
+    }
+    if (!pg.input) {
+        pg.complete = true;
+        return false;
+    }
+    if (pg.size - pg.base == PAGER_WINDOW && !slide()) {
+        ksnprintf(pg.message, sizeof(pg.message), "Lines too long: input cut short at %u bytes", pg.size);
+        pg.complete = true;
+        return false;
+    }
+    uint32_t held = pg.size - pg.base;
+    uint32_t n = pg.input->read(pg.buffer + held, PAGER_WINDOW - held);
+    if (n == 0) {
+        pg.complete = true;
+        return false;
+    }
+    pg.size += n;
+    return true;
+}
+
+/**
+ * Index Lines up to line
+ *
+ * Afterwards line_count > line, or the whole document is indexed. A line
+ * starts at every byte that follows a newline, so a final newline does not
+ * open an empty last line.
+ */
+static void index_lines(uint32_t line) {
+    while (pg.line_count <= line) {
+        if (pg.scanned == pg.size && !read_more()) {
+            return;
+        }
+        uint32_t p = pg.scanned;
+        if (p == 0 || pg.data[p - 1 - pg.base] == '\n') {
+            if (pg.line_count - pg.first_line == PAGER_INDEX_LINES && !slide()) {
+                ksnprintf(pg.message, sizeof(pg.message), "Document cut short at %u lines", pg.line_count);
+                pg.complete = true;
+                pg.size = p;
+                return;
+            }
+            pg.lines[pg.line_count++ - pg.first_line] = p;
+        }
+        pg.scanned = p + 1;
+    }
+}
+
+/**
+ * Bring a Line back into the Index Window
+ *
+ * A file is indexed again from its start; piped input before first_line
+ * is gone, so the first line still held is used instead.
+ *
+ * @return line, or the nearest line the pager can show
+ */
+static uint32_t rewind(uint32_t line) {
+    if (line >= pg.first_line) {
+        return line;
+    }
+    if (pg.input) {
+        if (!pg.message[0]) {
+            strncpy(pg.message, "Earlier input was discarded", sizeof(pg.message));
+        }
+        return pg.first_line;
+    }
+    pg.first_line = pg.line_count = 0;
+    pg.scanned = 0;
+    pg.complete = false;
+    pg.pin = line;
+    return line;
+}
+
+/**
+ * Text of an Indexed Line, without its newline
+ */
+static uint32_t line_text(uint32_t line, const char** text) {
+    index_lines(line + 1);
+    uint32_t start = pg.lines[line - pg.first_line];
+    uint32_t end = (line + 1 < pg.line_count) ? pg.lines[line + 1 - pg.first_line] : pg.size;
+    if (end > start && pg.data[end - 1 - pg.base] == '\n') end--;
+    *text = pg.data + (start - pg.base);
+    return end - start;
+}
+
+// ============================================================================
+// Navigation and Search
+// ============================================================================
+
+/**
+ * Put line at the Top, Keeping the Last Page Full
+ */
+static void scroll_to(uint32_t line) {
+    // slide() keeps the last screen, so the clamped top stays indexed too
+    line = rewind(line);
+    pg.pin = line;
+    index_lines(line + PAGER_ROWS);
+    uint32_t last = (pg.line_count > PAGER_ROWS) ? pg.line_count - PAGER_ROWS : 0;
+    pg.top = (line < last) ? line : last;
+}
+
+static bool contains(const char* text, uint32_t len, const char* pattern, uint32_t pattern_len) {
+    for (uint32_t i = 0; i + pattern_len <= len; ++i) {
+        if (text[i] != pattern[0]) continue;
+        uint32_t j = 1;
+        while (j < pattern_len && text[i + j] == pattern[j]) j++;
+        if (j == pattern_len) return true;
+    }
+    return false;
+}
+
+/**
+ * Search Forward from the Line after the Top
+ *
+ * Lines are indexed (and piped input read) only as far as the match.
+ */
+static void search() {
+    uint32_t pattern_len = strlen(pg.pattern);
+    if (pattern_len == 0) {
+        return;
+    }
+    for (uint32_t line = pg.top + 1;; ++line) {
+        if (task_poll()) {
+            return;
+        }
+        pg.pin = line;
+        index_lines(line);
+        if (line >= pg.line_count) {
+            strncpy(pg.message, "Pattern not found", sizeof(pg.message));
+            return;
+        }
+        const char* text;
+        uint32_t len = line_text(line, &text);
+        if (contains(text, len, pg.pattern, pattern_len)) {
+            scroll_to(line);
+            return;
+        }
+    }
+}
+
+// ============================================================================
+// Drawing
+// ============================================================================
+
+static void draw_status(const char* text) {
+    char cells[PAGER_WIDTH + 1];
+    ksnprintf(cells, sizeof(cells), "%-80s", text);
+    terminal.writeRow(PAGER_FIRST_ROW + PAGER_ROWS, cells, BLACK, LIGHT_GREY);
+}
+
+static void draw() {
+    pg.top = rewind(pg.top);
+    pg.pin = pg.top;
+    index_lines(pg.top + PAGER_ROWS);
+    char cells[PAGER_WIDTH];
+    for (uint32_t row = 0; row < PAGER_ROWS; ++row) {
+        memset(cells, ' ', sizeof(cells));
+        uint32_t line = pg.top + row;
+        if (line < pg.line_count) {
+            const char* text;
+            uint32_t len = line_text(line, &text);
+            for (uint32_t x = 0; x < len && x < PAGER_WIDTH; ++x) {
+                char c = text[x];
+                cells[x] = (c >= 32 && c <= 126) ? c : (c == '\t' ? ' ' : '?');
+            }
+        } else {
+            cells[0] = '~';
+        }
+        terminal.writeRow(PAGER_FIRST_ROW + row, cells, LIGHT_GREY, BLACK);
+    }
+
+    char status[PAGER_WIDTH + 1];
+    uint32_t last = pg.top + PAGER_ROWS;
+    if (last > pg.line_count) last = pg.line_count;
+    bool at_end = pg.complete && last == pg.line_count;
+    if (pg.message[0]) {
+        ksnprintf(status, sizeof(status), " %s", pg.message);
+    } else if (pg.complete) {
+        ksnprintf(status, sizeof(status), " %s  lines %u-%u of %u%s", pg.name,
+                  pg.top + 1, last, pg.line_count, at_end ? "  (END)" : "");
+    } else {
+        ksnprintf(status, sizeof(status), " %s  lines %u-%u", pg.name, pg.top + 1, last);
+    }
+    draw_status(status);
+    terminal.setCursor(0, PAGER_FIRST_ROW + PAGER_ROWS);
+}
+
+// ============================================================================
+// Main Loop
+// ============================================================================
+
+/**
+ * Wait for a Key
+ *
+ * @return false if the job was cancelled (Ctrl+C)
+ */
+static bool next_key(KeyEvent& event) {
+    while (!keyboard.get_key_event(event)) {
+        if (task_poll()) {
+            return false;
+        }
+        task_yield();
+    }
+    return !task_cancelled();
+}
+
+/**
+ * Read a Search Pattern on the Status Line
+ *
+ * @return false if the search was abandoned (Escape or Ctrl+C)
+ */
+static bool read_pattern() {
+    char entry[PAGER_PATTERN_LENGTH];
+    uint32_t len = 0;
+    entry[0] = '\0';
+    while (true) {
+        char prompt[PAGER_WIDTH + 1];
+        ksnprintf(prompt, sizeof(prompt), "/%s", entry);
+        draw_status(prompt);
+        terminal.setCursor(len + 1, PAGER_FIRST_ROW + PAGER_ROWS);
+        KeyEvent event;
+        if (!next_key(event) || event.scan_code == KEY_ESCAPE) {
+            return false;
+        }
+        char c = (char)event.ascii;
+        if (c == '\n') {
+            break;
+        }
+        if (c == 0x08) {
+            if (len > 0) entry[--len] = '\0';
+        } else if (c >= 32 && c <= 126 && len < PAGER_PATTERN_LENGTH - 1) {
+            entry[len++] = c;
+            entry[len] = '\0';
+        }
+    }
+    if (len > 0) {
+        memcpy(pg.pattern, entry, len + 1);
+    }
+    return true;
+}
+
+/**
+ * Page through a Document
+ *
+ * @param name Shown in the status line
+ * @param data File contents (ignored when input is given)
+ * @param size Bytes in data
+ * @param input Pipe to read the document from, or nullptr
+ * @return 0, 1 if out of memory, or 130 if cancelled with Ctrl+C
+ */
+int32_t pager_run(const char* name, const char* data, uint32_t size, Pipe* input) {
+    pg.lines = new uint32_t[PAGER_INDEX_LINES];
+    pg.buffer = input ? new char[PAGER_WINDOW] : nullptr;
+    if (!pg.lines || (input && !pg.buffer)) {
+        delete[] pg.lines;
+        delete[] pg.buffer;
+        terminal.write("Error: out of memory\n");
+        return 1;
+    }
+    pg.name = name;
+    pg.input = input;
+    pg.data = input ? pg.buffer : data;
+    pg.base = 0;
+    pg.size = input ? 0 : size;
+    pg.complete = false;
+    pg.first_line = pg.line_count = 0;
+    pg.pin = 0;
+    pg.scanned = 0;
+    pg.top = 0;
+    pg.message[0] = '\0';
+
+    int32_t status = 0;
+    bool cancelled = false;
+    while (!cancelled) {
+        draw();
+        KeyEvent event;
+        if (!next_key(event)) {
+            cancelled = true;
+            break;
+        }
+        pg.message[0] = '\0';
+        char c = (char)event.ascii;
+        if (c == 'q') {
+            break;
+        }
+        if (c == ' ' || c == 'f' || event.scan_code == KEY_KEYPAD_3) {
+            scroll_to(pg.top + PAGER_ROWS);
+        } else if (c == 'b' || event.scan_code == KEY_KEYPAD_9) {
+            scroll_to(pg.top > PAGER_ROWS ? pg.top - PAGER_ROWS : 0);
+        } else if (c == '\n' || c == 'j' || event.scan_code == KEY_KEYPAD_2) {
+            scroll_to(pg.top + 1);
+        } else if (c == 'k' || event.scan_code == KEY_KEYPAD_8) {
+            scroll_to(pg.top > 0 ? pg.top - 1 : 0);
+        } else if (c == 'g' || event.scan_code == KEY_KEYPAD_7) {
+            scroll_to(0);
+        } else if (c == 'G' || event.scan_code == KEY_KEYPAD_1) {
+            pg.pin = 0xFFFFFFFF;
+            index_lines(0xFFFFFFFF);
+            scroll_to(pg.line_count);
+        } else if (c == '/') {
+            if (read_pattern()) {
+                search();
+            }
+        } else if (c == 'n') {
+            search();
+        }
+        cancelled = task_cancelled();
+    }
+    if (cancelled) {
+        status = 130;
+    }
+
+    delete[] pg.lines;
+    delete[] pg.buffer;
+    pg.lines = nullptr;
+    pg.buffer = nullptr;
+    terminal.clear();
+    return status;
+}
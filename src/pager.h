@@ -0,0 +1,49 @@
+/*
+ * ============================================================================
+ * RusticOS Pager Header (pager.h)
+ * ============================================================================
+ *
+ * Screen-at-a-time viewer run by "more" and "less", for a file or for the
+ * output of a pipeline ("lsd | more"). Files are shown straight from their
+ * in-memory data; piped input is read only as far as the view (or a search)
+ * needs. Line start offsets are indexed incrementally in the same way, so
+ * opening a large file costs nothing until the user scrolls through it.
+ *
+ * Keys:
+ *   Space, PgDn, f          Next page
+ *   b, PgUp                 Previous page
+ *   Enter, j, Down          Next line
+ *   k, Up                   Previous line
+ *   g, Home / G, End        First / last page
+ *   /pattern Enter          Search forward; n repeats the search
+ *   q, Ctrl+C               Quit
+ *
+ * Lines longer than the screen are cut off at the right edge.
+ *
+ * Piped input of any length is paged through a window of PAGER_WINDOW
+ * bytes, and the line index keeps PAGER_INDEX_LINES lines; scrolling back
+ * stops at the oldest line still held. Only a screen of lines that does not
+ * fit in the window cuts the document short, which the status line says.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef PAGER_H
+#define PAGER_H
+
+#include "types.h"
+
+class Pipe;
+
+// ============================================================================
+// Pager Constants
+// ============================================================================
+#define PAGER_PATTERN_LENGTH    64      // Search pattern including the terminator
+#define PAGER_WINDOW            (32768 - HEAP_BLOCK_HEADER)         // Piped input held (one 32 KB heap block)
+#define PAGER_INDEX_LINES       ((8192 - HEAP_BLOCK_HEADER) / 4)    // Line index entries held (one 8 KB block)
+
+// Pager functions
+int32_t pager_run(const char* name, const char* data, uint32_t size, Pipe* input);  // data for a file, input for a pipe; returns the exit status
+
+#endif // PAGER_H
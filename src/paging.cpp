@@ -0,0 +1,311 @@
+/*
+ * ============================================================================
+ * RusticOS Paging Implementation (paging.cpp)
+ * ============================================================================
+ *
+ * Implements the frame allocator and page-table management described in
+ * paging.h. The kernel's identity mapping is built once at boot; every user
+ * address space reuses the same kernel tables (supervisor-only) and only
+ * owns the tables that describe its user range. Table walks are written
+ * once for both builds, stepping down PAGE_LEVELS levels of PAGE_ENTRIES
+ * entries each.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "paging.h"
+#include "initrd.h"
+
+extern "C" char __initrd_start[];
+
+// Kernel top-level table and the page tables for the identity-mapped range
+static PageEntry kernel_directory[PAGE_ENTRIES] __attribute__((aligned(PAGE_SIZE)));
+static PageEntry kernel_tables[KERNEL_PDE_COUNT][PAGE_ENTRIES] __attribute__((aligned(PAGE_SIZE)));
+#ifdef __x86_64__
+// Intermediate levels leading to the page directory of the first GiB
+static PageEntry kernel_pdpt[PAGE_ENTRIES] __attribute__((aligned(PAGE_SIZE)));
+static PageEntry kernel_pd[PAGE_ENTRIES] __attribute__((aligned(PAGE_SIZE)));
+#endif
+
+// Frame allocator bitmap (1 bit per frame, 1 = in use)
+static uint32_t frame_bitmap[FRAME_POOL_FRAMES / 32];
+static uint32_t frames_free = 0;
+static uint32_t frame_search_hint = 0;      // First bitmap word that may contain a free frame
+
+// Next free byte for reserve_kernel_memory() (above the kernel image and initrd)
+static uint32_t reserve_next = 0;
+
+/**
+ * Initialize Paging
+ *
+ * Identity-maps the first KERNEL_IDENTITY_LIMIT bytes as supervisor pages,
+ * resets the frame allocator and loads CR3. On i686 this also sets CR0.PG;
+ * on x86-64 paging is already on (crt0 enters long mode through boot page
+ * tables), so loading CR3 replaces those tables.
+ *
+ * An initrd that reaches into the frame pool is dropped (initrd_size = 0):
+ * its pages would be handed out as user frames while /bin still pointed
+ * at them.
+ */
+void init_paging() {
+    // Built from scratch on every call, not relying on .bss being zero
+    PageEntry* directory = kernel_directory;
+#ifdef __x86_64__
+    for (uint32_t i = 0; i < PAGE_ENTRIES; ++i) {
+        kernel_directory[i] = 0;
+        kernel_pdpt[i] = 0;
+    }
+    kernel_directory[0] = (uintptr_t)kernel_pdpt | PAGE_PRESENT | PAGE_WRITABLE;
+    kernel_pdpt[0] = (uintptr_t)kernel_pd | PAGE_PRESENT | PAGE_WRITABLE;
+    directory = kernel_pd;
+#endif
+    for (uint32_t i = 0; i < PAGE_ENTRIES; ++i) {
+        directory[i] = 0;
+    }
+    for (uint32_t t = 0; t < KERNEL_PDE_COUNT; ++t) {
+        for (uint32_t i = 0; i < PAGE_ENTRIES; ++i) {
+            uintptr_t paddr = (uintptr_t)(t * PAGE_ENTRIES + i) * PAGE_SIZE;
+            kernel_tables[t][i] = paddr | PAGE_PRESENT | PAGE_WRITABLE;
+        }
+        directory[t] = (uintptr_t)kernel_tables[t] | PAGE_PRESENT | PAGE_WRITABLE;
+    }
+
+    for (uint32_t i = 0; i < FRAME_POOL_FRAMES / 32; ++i) {
+        frame_bitmap[i] = 0;
+    }
+    frames_free = FRAME_POOL_FRAMES;
+    frame_search_hint = 0;
+
+    if (initrd_size && (initrd_base > FRAME_POOL_START || initrd_size > FRAME_POOL_START - initrd_base)) {
+        initrd_size = 0;
+    }
+    reserve_next = initrd_size ? initrd_base + initrd_size : (uint32_t)(uintptr_t)__initrd_start;
+    reserve_next = PAGE_ALIGN_UP(reserve_next);
+
+    switch_address_space(kernel_directory);
+
+#ifndef __x86_64__
+    uint32_t cr0;
+    asm volatile("movl %%cr0, %0" : "=r"(cr0));
+    cr0 |= 0x80000000;                      // CR0.PG
+    asm volatile("movl %0, %%cr0" : : "r"(cr0) : "memory");
+#endif
+}
+
+/**
+ * Allocate a Physical Frame
+ *
+ * Scans the bitmap a word at a time starting from the search hint, so the
+ * common case (low frames in use, high frames free) skips 32 frames per step.
+ *
+ * @return Physical address of a zeroed frame, or 0 if the pool is exhausted
+ */
+uint32_t alloc_frame() {
+    for (uint32_t w = frame_search_hint; w < FRAME_POOL_FRAMES / 32; ++w) {
+        if (frame_bitmap[w] == 0xFFFFFFFF) {
+            continue;
+        }
+        uint32_t bit = __builtin_ctz(~frame_bitmap[w]);
+        frame_bitmap[w] |= (1u << bit);
+        frames_free--;
+        frame_search_hint = w;
+
+        uint32_t frame = FRAME_POOL_START + (w * 32 + bit) * PAGE_SIZE;
+        memset((void*)(uintptr_t)frame, 0, PAGE_SIZE);
+        return frame;
+    }
+    return 0;  // Out of frames
+}
+
+/**
+ * Free a Physical Frame
+ *
+ * @param frame Physical address previously returned by alloc_frame()
+ */
+void free_frame(uint32_t frame) {
+    if (frame < FRAME_POOL_START || frame >= FRAME_POOL_END) {
+        return;  // Not a pool frame (e.g. a shared kernel page)
+    }
+    uint32_t index = (frame - FRAME_POOL_START) / PAGE_SIZE;
+    uint32_t w = index / 32;
+    uint32_t mask = 1u << (index % 32);
+    if (frame_bitmap[w] & mask) {
+        frame_bitmap[w] &= ~mask;
+        frames_free++;
+        if (w < frame_search_hint) {
+            frame_search_hint = w;
+        }
+    }
+}
+
+uint32_t free_frame_count() {
+    return frames_free;
+}
+
+/**
+ * Reserve Kernel Memory
+ *
+ * Hands out identity-mapped memory between the end of the kernel image (or
+ * the relocated initrd) and FRAME_POOL_START, for buffers whose size is only
+ * known once the kernel parameters have been read. The memory is not
+ * cleared.
+ *
+ * @param bytes Size of the block (rounded up to whole pages)
+ * @return Page-aligned block, nullptr if it would reach the frame pool
+ */
+void* reserve_kernel_memory(uint32_t bytes) {
+    uint32_t size = PAGE_ALIGN_UP(bytes);
+    if (size < bytes || reserve_next > FRAME_POOL_START || size > FRAME_POOL_START - reserve_next) {
+        return nullptr;
+    }
+    void* block = (void*)(uintptr_t)reserve_next;
+    reserve_next += size;
+    return block;
+}
+
+PageEntry* kernel_page_directory() {
+    return kernel_directory;
+}
+
+/**
+ * Create a User Address Space
+ *
+ * The entries below KERNEL_SHARED_LIMIT are copied from the kernel and
+ * marked PAGE_SHARED, so destroy_address_space() leaves those tables alone.
+ * On x86-64 that takes a private PML4 and PDPT whose first entry points at
+ * the kernel's page directory.
+ *
+ * @return New page directory with the kernel mappings installed, or nullptr
+ */
+PageEntry* create_address_space() {
+    PageEntry* dir = (PageEntry*)(uintptr_t)alloc_frame();
+    if (!dir) {
+        return nullptr;
+    }
+#ifdef __x86_64__
+    PageEntry* pdpt = (PageEntry*)(uintptr_t)alloc_frame();
+    if (!pdpt) {
+        free_frame((uint32_t)(uintptr_t)dir);
+        return nullptr;
+    }
+    dir[0] = (uintptr_t)pdpt | PAGE_PRESENT | PAGE_WRITABLE | PAGE_USER;
+    pdpt[0] = kernel_pdpt[0] | PAGE_SHARED;
+#else
+    for (uint32_t i = 0; i < KERNEL_PDE_COUNT; ++i) {
+        dir[i] = kernel_directory[i] | PAGE_SHARED;
+    }
+#endif
+    return dir;
+}
+
+/**
+ * Free a Table and Everything it Owns
+ *
+ * Entries marked PAGE_SHARED (borrowed frames and the kernel's tables) are
+ * skipped.
+ *
+ * @param table Table to release, including its own frame
+ * @param level 1 for a page table, PAGE_LEVELS for the top-level directory
+ */
+static void free_table(PageEntry* table, uint32_t level) {
+    for (uint32_t i = 0; i < PAGE_ENTRIES; ++i) {
+        PageEntry entry = table[i];
+        if (!(entry & PAGE_PRESENT) || (entry & PAGE_SHARED)) {
+            continue;
+        }
+        if (level == 1) {
+            free_frame((uint32_t)(entry & PAGE_FRAME_MASK));
+        } else {
+            free_table((PageEntry*)(entry & PAGE_FRAME_MASK), level - 1);
+        }
+    }
+    free_frame((uint32_t)(uintptr_t)table);
+}
+
+/**
+ * Destroy a User Address Space
+ *
+ * Frees every frame owned by the user mappings (pages marked PAGE_SHARED
+ * are borrowed and left alone), the user page tables and the directory.
+ */
+void destroy_address_space(PageEntry* dir) {
+    if (!dir || dir == kernel_directory) {
+        return;
+    }
+    free_table(dir, PAGE_LEVELS);
+}
+
+/**
+ * Load a Page Directory into CR3
+ */
+void switch_address_space(PageEntry* dir) {
+    asm volatile("mov %0, %%cr3" : : "r"(dir) : "memory");
+}
+
+/**
+ * Find the Page Table Entry for an Address
+ *
+ * Walks from the top-level directory down to the page table, creating
+ * missing tables on the way if asked to. New intermediate entries stay
+ * permissive; the page table entry decides access.
+ *
+ * @param dir Page directory
+ * @param vaddr Virtual address
+ * @param create Allocate missing tables (false: return nullptr instead)
+ * @return Page table entry for vaddr, or nullptr if missing or out of frames
+ */
+static PageEntry* page_entry(PageEntry* dir, uint32_t vaddr, bool create) {
+    PageEntry* table = dir;
+    for (uint32_t level = PAGE_LEVELS; level > 1; --level) {
+        uint32_t shift = PAGE_SHIFT + (level - 1) * PAGE_INDEX_BITS;
+        PageEntry& entry = table[((uintptr_t)vaddr >> shift) & (PAGE_ENTRIES - 1)];
+        if (!(entry & PAGE_PRESENT)) {
+            uint32_t frame = create ? alloc_frame() : 0;
+            if (!frame) {
+                return nullptr;
+            }
+            entry = frame | PAGE_PRESENT | PAGE_WRITABLE | PAGE_USER;
+        }
+        table = (PageEntry*)(entry & PAGE_FRAME_MASK);
+    }
+    return &table[(vaddr >> PAGE_SHIFT) & (PAGE_ENTRIES - 1)];
+}
+
+/**
+ * Map a Page
+ *
+ * Creates the page tables on demand. Mappings below KERNEL_SHARED_LIMIT are
+ * refused so a user address space can never alias kernel tables.
+ *
+ * @param dir Page directory to modify
+ * @param vaddr Virtual address (page aligned)
+ * @param paddr Physical frame address (page aligned)
+ * @param flags PAGE_* flags (PAGE_PRESENT is implied)
+ * @return true on success, false if out of frames or vaddr is in the kernel range
+ */
+bool map_page(PageEntry* dir, uint32_t vaddr, uint32_t paddr, uint32_t flags) {
+    if (!dir || vaddr < KERNEL_SHARED_LIMIT) {
+        return false;
+    }
+    PageEntry* entry = page_entry(dir, vaddr, true);
+    if (!entry) {
+        return false;
+    }
+    *entry = (paddr & PAGE_FRAME_MASK) | (flags & 0xFFF) | PAGE_PRESENT;
+    asm volatile("invlpg (%0)" : : "r"((uintptr_t)vaddr) : "memory");
+    return true;
+}
+
+/**
+ * Translate a Virtual Address
+ *
+ * @return Physical address backing vaddr in dir, or 0 if not mapped
+ */
+uint32_t translate_address(PageEntry* dir, uint32_t vaddr) {
+    PageEntry* entry = dir ? page_entry(dir, vaddr, false) : nullptr;
+    if (!entry || !(*entry & PAGE_PRESENT)) {
+        return 0;
+    }
+    return (uint32_t)(*entry & PAGE_FRAME_MASK) | (vaddr & (PAGE_SIZE - 1));
+}
@@ -0,0 +1,89 @@
+/*
+ * ============================================================================
+ * RusticOS Paging Header (paging.h)
+ * ============================================================================
+ *
+ * Defines the physical frame allocator and the x86 page tables used to
+ * give every user process its own address space: two levels of 32-bit
+ * entries on i686, four levels of 64-bit entries on x86-64 (where the
+ * "page directory" of an address space is its top-level PML4 table).
+ *
+ * Memory model:
+ *   - The first KERNEL_IDENTITY_LIMIT bytes of physical memory are identity
+ *     mapped (virtual == physical) as supervisor-only pages in every address
+ *     space. The kernel can therefore touch any frame or page table directly
+ *     through its physical address.
+ *   - Frames handed to user processes come from a bitmap-managed pool
+ *     [FRAME_POOL_START, FRAME_POOL_END) inside the identity-mapped range.
+ *   - User mappings live above KERNEL_SHARED_LIMIT and are private to each
+ *     page directory. Below it, every address space points at the kernel's
+ *     own tables (entries marked PAGE_SHARED).
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef PAGING_H
+#define PAGING_H
+
+#include "types.h"
+
+// ============================================================================
+// Paging Constants
+// ============================================================================
+#define PAGE_SIZE               4096
+#define PAGE_SHIFT              12
+#ifdef __x86_64__
+#define PAGE_LEVELS             4               // PML4, PDPT, page directory, page table
+#define PAGE_INDEX_BITS         9
+#else
+#define PAGE_LEVELS             2               // Page directory, page table
+#define PAGE_INDEX_BITS         10
+#endif
+#define PAGE_ENTRIES            (1 << PAGE_INDEX_BITS)  // Entries per table at every level
+
+// A page table entry at any level (pointer-sized: 32 or 64 bits)
+typedef uintptr_t PageEntry;
+
+// Page directory / page table entry flags
+#define PAGE_PRESENT            0x001           // Mapping is valid
+#define PAGE_WRITABLE           0x002           // Writes allowed
+#define PAGE_USER               0x004           // Accessible from ring 3
+#define PAGE_SHARED             0x200           // OS-available bit: frame/table is not owned by this mapping
+#define PAGE_FRAME_MASK         (~(PageEntry)0xFFF)
+
+// Physical memory layout
+#define KERNEL_IDENTITY_LIMIT   0x01000000      // Identity-map the first 16 MiB
+#define KERNEL_PDE_COUNT        (KERNEL_IDENTITY_LIMIT / (PAGE_ENTRIES * PAGE_SIZE))  // Kernel page tables
+#ifdef __x86_64__
+#define KERNEL_SHARED_LIMIT     0x40000000      // First GiB: the kernel page directory is shared
+#else
+#define KERNEL_SHARED_LIMIT     KERNEL_IDENTITY_LIMIT   // The kernel page tables are shared
+#endif
+#define FRAME_POOL_START        0x00800000      // Frames for user memory: 8 MiB ..
+#define FRAME_POOL_END          0x01000000      // .. 16 MiB
+#define FRAME_POOL_FRAMES       ((FRAME_POOL_END - FRAME_POOL_START) / PAGE_SIZE)
+
+#define PAGE_ALIGN_DOWN(x)      ((x) & PAGE_FRAME_MASK)
+#define PAGE_ALIGN_UP(x)        (((x) + PAGE_SIZE - 1) & PAGE_FRAME_MASK)
+
+// Paging functions
+void init_paging();                         // Build kernel page tables and enable paging
+
+// Physical frame allocator
+uint32_t alloc_frame();                     // Allocate a zeroed frame, 0 if exhausted
+void free_frame(uint32_t frame);            // Return a frame to the pool
+uint32_t free_frame_count();                // Number of frames still available
+
+// Boot-time kernel memory (sized by kernel parameters, never freed)
+void* reserve_kernel_memory(uint32_t bytes);  // Page-aligned block between the image and the frame pool, nullptr if full
+
+// Address spaces
+PageEntry* kernel_page_directory();         // Directory containing only kernel mappings
+PageEntry* create_address_space();          // New directory sharing the kernel mappings
+void destroy_address_space(PageEntry* dir); // Free user page tables and owned frames
+void switch_address_space(PageEntry* dir);  // Load CR3
+bool map_page(PageEntry* dir, uint32_t vaddr, uint32_t paddr, uint32_t flags);
+uint32_t translate_address(PageEntry* dir, uint32_t vaddr);  // Virtual -> physical, 0 if unmapped
+
+#endif // PAGING_H
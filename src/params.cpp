@@ -0,0 +1,201 @@
+/*
+ * ============================================================================
+ * RusticOS Kernel Parameters Implementation (params.cpp)
+ * ============================================================================
+ *
+ * The registry is a constant table; only the current values live in .bss
+ * (set by params_init()). Problems with the command line (unknown names,
+ * malformed or out-of-range values) are reported on the serial port and
+ * leave the parameter at its default.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "params.h"
+#include "fwcfg.h"
+#include "interrupt.h"
+#include "keyboard.h"
+#include "virtual_disk.h"
+#include "output.h"
+#include "format.h"
+#include "serial.h"
+
+#define FW_CFG_CMDLINE_FILE "opt/rusticos/cmdline"
+
+/**
+ * Registry Entry
+ */
+struct ParamSpec {
+    const char* name;
+    ParamType type;
+    int32_t default_value;
+    int32_t min;
+    int32_t max;
+    const char* help;
+};
+
+static constexpr ParamSpec param_table[PARAM_COUNT] = {
+    { "pit_hz",        PARAM_UINT, PIT_DEFAULT_FREQUENCY,   18, 10000, "Timer interrupt rate (Hz)" },
+    { "heap_kb",       PARAM_UINT, HEAP_DEFAULT_SIZE / 1024, 64, 2048, "Kernel heap size (KiB)" },
+    { "vdisk_sectors", PARAM_UINT, VDISK_NUM_SECTORS,       64, 8192,  "Virtual disk size (512-byte sectors)" },
+    { "kbd_buffer",    PARAM_UINT, KEYBOARD_BUFFER_DEFAULT, 16, KEYBOARD_BUFFER_MAX, "Keyboard event queue length" },
+    { "tz",            PARAM_INT,  RTC_TIMEZONE_OFFSET,     -12, 14,   "Hours added to the RTC's UTC time" },
+};
+
+static int32_t param_values[PARAM_COUNT];
+static char cmdline[PARAM_CMDLINE_MAX];
+
+// ============================================================================
+// Parsing
+// ============================================================================
+
+/**
+ * Parse a Decimal or 0x-Prefixed Hex Number
+ *
+ * @return false if the text is empty, malformed or overflows 31 bits
+ */
+static bool parse_number(const char* text, uint32_t len, bool allow_negative, int32_t* value) {
+    bool negative = false;
+    if (allow_negative && len > 0 && text[0] == '-') {
+        negative = true;
+        text++;
+        len--;
+    }
+    uint32_t base = 10;
+    if (len > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        base = 16;
+        text += 2;
+        len -= 2;
+    }
+    if (len == 0) {
+        return false;
+    }
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < len; ++i) {
+        char c = text[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (base == 16 && c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (base == 16 && c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            return false;
+        }
+        if (result > (0x7FFFFFFFu - digit) / base) {
+            return false;
+        }
+        result = result * base + digit;
+    }
+    *value = negative ? -(int32_t)result : (int32_t)result;
+    return true;
+}
+
+static bool name_equals(const char* name, const char* text, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) {
+        if (name[i] != text[i]) {
+            return false;
+        }
+    }
+    return name[len] == '\0';
+}
+
+static void report_word(const char* problem, const char* word, uint32_t len) {
+    serial_write("params: ");
+    serial_write(problem);
+    serial_write(" '");
+    serial_write(word, len);
+    serial_write("'\n");
+}
+
+/**
+ * Apply one "name=value" Word
+ */
+static void apply_word(const char* word, uint32_t len) {
+    uint32_t eq = 0;
+    while (eq < len && word[eq] != '=') {
+        eq++;
+    }
+    if (eq == len) {
+        report_word("ignoring", word, len);
+        return;
+    }
+    for (uint32_t id = 0; id < PARAM_COUNT; ++id) {
+        const ParamSpec& spec = param_table[id];
+        if (!name_equals(spec.name, word, eq)) {
+            continue;
+        }
+        int32_t value;
+        if (!parse_number(word + eq + 1, len - eq - 1, spec.type == PARAM_INT, &value) ||
+            value < spec.min || value > spec.max) {
+            kprintf(serial_sink, "params: %s needs a value in %d..%d, keeping %d\n",
+                    spec.name, spec.min, spec.max, param_values[id]);
+            return;
+        }
+        param_values[id] = value;
+        return;
+    }
+    report_word("unknown parameter", word, eq);
+}
+
+/**
+ * Append a Command Line Source to cmdline (space separated)
+ */
+static void append_source(const char* text, uint32_t len) {
+    while (len > 0 && (text[len - 1] == '\0' || text[len - 1] == '\n' || text[len - 1] == ' ')) {
+        len--;
+    }
+    uint32_t used = strlen(cmdline);
+    if (len == 0 || used + 1 + len >= PARAM_CMDLINE_MAX) {
+        return;
+    }
+    if (used > 0) {
+        cmdline[used++] = ' ';
+    }
+    memcpy(cmdline + used, text, len);
+    cmdline[used + len] = '\0';
+}
+
+// ============================================================================
+// Registry
+// ============================================================================
+
+void params_init(const char* boot_cmdline) {
+    for (uint32_t id = 0; id < PARAM_COUNT; ++id) {
+        param_values[id] = param_table[id].default_value;
+    }
+
+    cmdline[0] = '\0';
+    append_source(boot_cmdline, strlen(boot_cmdline));
+    char fw_text[PARAM_CMDLINE_MAX];
+    append_source(fw_text, fw_cfg_read_file(FW_CFG_CMDLINE_FILE, fw_text, sizeof(fw_text) - 1));
+
+    const char* p = cmdline;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == '\n') p++;
+        const char* word = p;
+        while (*p && *p != ' ' && *p != '\t' && *p != '\n') p++;
+        if (p > word) {
+            apply_word(word, p - word);
+        }
+    }
+}
+
+int32_t param_get(ParamId id) {
+    return param_values[id];
+}
+
+const char* params_cmdline() {
+    return cmdline;
+}
+
+void params_print(OutputSink& out) {
+    kprintf(out, "Command line: %s\n", cmdline[0] ? cmdline : "(empty)");
+    for (uint32_t id = 0; id < PARAM_COUNT; ++id) {
+        const ParamSpec& spec = param_table[id];
+        kprintf(out, "  %-14s %6d  (default %d, %d..%d)  %s\n", spec.name, param_values[id],
+                spec.default_value, spec.min, spec.max, spec.help);
+    }
+}
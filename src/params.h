@@ -0,0 +1,60 @@
+/*
+ * ============================================================================
+ * RusticOS Kernel Parameters Header (params.h)
+ * ============================================================================
+ *
+ * Boot-time tunables that used to be compile-time constants. Each parameter
+ * has an entry in the registry (params.cpp) with its name, type, default and
+ * allowed range; params_init() resets all of them to their defaults and
+ * then applies "name=value" words from the kernel command line:
+ *
+ *   1. the boot information block: make CMDLINE="..." for the RusticOS
+ *      loader, -append "..." for QEMU -kernel, or the Multiboot loader's
+ *      command line
+ *   2. QEMU fw_cfg: -fw_cfg name=opt/rusticos/cmdline,string="..."
+ *      (later words override earlier ones)
+ *
+ * Values are read with param_get(). They only take effect where a subsystem
+ * reads them during boot, so changing a setting needs a reboot, not a
+ * rebuild.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef PARAMS_H
+#define PARAMS_H
+
+#include "types.h"
+
+class OutputSink;
+
+// ============================================================================
+// Kernel Parameter Constants
+// ============================================================================
+#define PARAM_CMDLINE_MAX   512     // Combined command line from all sources
+
+/**
+ * Registered parameters (index into the registry)
+ */
+enum ParamId {
+    PARAM_PIT_HZ,                   // pit_hz: timer interrupt rate
+    PARAM_HEAP_KB,                  // heap_kb: kernel heap size
+    PARAM_VDISK_SECTORS,            // vdisk_sectors: virtual disk size
+    PARAM_KBD_BUFFER,               // kbd_buffer: keyboard event queue length
+    PARAM_TZ_OFFSET,                // tz: hours added to the RTC's UTC time
+    PARAM_COUNT
+};
+
+enum ParamType {
+    PARAM_UINT,                     // Decimal (or 0x hex) number
+    PARAM_INT                       // Optional leading '-'
+};
+
+// Kernel parameter functions
+void params_init(const char* boot_cmdline);  // Defaults, then the command line(s); reports on serial
+int32_t param_get(ParamId id);
+const char* params_cmdline();               // The combined command line that was applied
+void params_print(OutputSink& out);         // Registry with current values (params command)
+
+#endif // PARAMS_H
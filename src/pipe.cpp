@@ -0,0 +1,107 @@
+/*
+ * ============================================================================
+ * RusticOS Pipe Implementation (pipe.cpp)
+ * ============================================================================
+ *
+ * Data moves in blocks: each write/read copies at most two contiguous
+ * spans (before and after the wrap point) with memcpy.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "pipe.h"
+#include "task.h"
+
+static Pipe pipe_pool[MAX_PIPES];
+
+/**
+ * Allocate a Pipe
+ *
+ * @return Empty pipe with both ends open, or nullptr if the pool is exhausted
+ */
+Pipe* pipe_create() {
+    for (uint32_t i = 0; i < MAX_PIPES; ++i) {
+        Pipe* pipe = &pipe_pool[i];
+        if (!pipe->in_use) {
+            pipe->head = 0;
+            pipe->tail = 0;
+            pipe->write_open = true;
+            pipe->read_open = true;
+            pipe->in_use = true;
+            return pipe;
+        }
+    }
+    return nullptr;
+}
+
+void Pipe::release_if_closed() {
+    if (!write_open && !read_open) {
+        in_use = false;
+    }
+}
+
+/**
+ * Write to the Pipe
+ *
+ * Yields to other tasks whenever the buffer is full. If the reader has
+ * closed its end (or the writer's job was cancelled) the data is dropped,
+ * so a producer feeding e.g. `head` still runs to completion.
+ */
+void Pipe::write(const char* data, uint32_t len) {
+    while (len > 0) {
+        if (!read_open || task_cancelled()) {
+            return;
+        }
+        uint32_t space = PIPE_BUFFER_SIZE - (head - tail);
+        if (space == 0) {
+            task_yield();
+            continue;
+        }
+        uint32_t chunk = (len < space) ? len : space;
+        uint32_t index = head & (PIPE_BUFFER_SIZE - 1);
+        uint32_t first = PIPE_BUFFER_SIZE - index;
+        if (first > chunk) first = chunk;
+        memcpy(buffer + index, data, first);
+        memcpy(buffer, data + first, chunk - first);
+        head += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ * Read from the Pipe
+ *
+ * @param data Destination buffer
+ * @param max Buffer size
+ * @return Bytes read (at least 1), or 0 once the writer has closed and the
+ *         buffer is drained (or the reader's job was cancelled)
+ */
+uint32_t Pipe::read(char* data, uint32_t max) {
+    while (head == tail) {
+        if (!write_open || task_cancelled()) {
+            return 0;
+        }
+        task_yield();
+    }
+    uint32_t available = head - tail;
+    uint32_t chunk = (max < available) ? max : available;
+    uint32_t index = tail & (PIPE_BUFFER_SIZE - 1);
+    uint32_t first = PIPE_BUFFER_SIZE - index;
+    if (first > chunk) first = chunk;
+    memcpy(data, buffer + index, first);
+    memcpy(data + first, buffer, chunk - first);
+    tail += chunk;
+    return chunk;
+}
+
+void Pipe::close_write() {
+    write_open = false;
+    release_if_closed();
+}
+
+void Pipe::close_read() {
+    read_open = false;
+    release_if_closed();
+}
@@ -0,0 +1,61 @@
+/*
+ * ============================================================================
+ * RusticOS Pipe Header (pipe.h)
+ * ============================================================================
+ *
+ * Bounded ring-buffer pipes connecting pipeline stages. The writer blocks
+ * (yields to other tasks) while the buffer is full and the reader blocks
+ * while it is empty, so data streams through PIPE_BUFFER_SIZE bytes of
+ * memory no matter how much the producer writes.
+ *
+ * Pipes come from a static pool; a pipe is released once both ends are
+ * closed.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef PIPE_H
+#define PIPE_H
+
+#include "types.h"
+#include "output.h"
+
+// ============================================================================
+// Pipe Constants
+// ============================================================================
+#define PIPE_BUFFER_SIZE    4096    // Must be a power of two
+#define MAX_PIPES           8
+
+/**
+ * Pipe - single-producer, single-consumer byte stream
+ *
+ * head and tail are free-running counters: head - tail is the fill level
+ * and the buffer index is the counter masked by PIPE_BUFFER_SIZE - 1.
+ */
+class Pipe : public OutputSink {
+private:
+    char buffer[PIPE_BUFFER_SIZE];
+    uint32_t head;                  // Total bytes written
+    uint32_t tail;                  // Total bytes read
+    bool write_open;
+    bool read_open;
+    bool in_use;
+
+    friend Pipe* pipe_create();
+    void release_if_closed();
+
+public:
+    using OutputSink::write;
+    void write(const char* data, uint32_t len) override;   // Blocks while full; discards if the reader is gone
+    uint32_t read(char* data, uint32_t max);                // Blocks while empty; 0 = end of stream
+
+    void close_write();             // Producer finished (reader sees end of stream)
+    void close_read();              // Consumer finished (further writes are discarded)
+    bool reader_closed() const { return !read_open; }
+};
+
+// Pipe functions
+Pipe* pipe_create();                // Allocate a pipe from the pool (nullptr if exhausted)
+
+#endif // PIPE_H
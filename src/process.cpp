@@ -0,0 +1,287 @@
+/*
+ * ============================================================================
+ * RusticOS User Process Implementation (process.cpp)
+ * ============================================================================
+ *
+ * Creates, runs and tears down ring-3 processes. A process runs to
+ * completion: process_run() saves the kernel context, drops to ring 3 with
+ * IRET and only returns once the process calls SYS_EXIT or is killed by a
+ * CPU exception, at which point user_return() unwinds straight back to the
+ * saved kernel context.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "process.h"
+#include "paging.h"
+#include "gdt.h"
+#include "syscall.h"
+#include "interrupt.h"
+#include "terminal.h"
+
+extern Terminal terminal;
+
+static Process process_table[MAX_PROCESSES];
+static uint8_t process_kernel_stacks[MAX_PROCESSES][PROCESS_KERNEL_STACK_SIZE] __attribute__((aligned(16)));
+static Process* current_process = nullptr;
+static PageEntry* active_directory = nullptr;   // Page directory currently in CR3
+static uint32_t next_pid = 1;
+
+/**
+ * Create a Process
+ *
+ * Allocates a process slot and an address space containing only the kernel
+ * mappings, the system call trampoline and an empty user stack.
+ *
+ * @param name Process name (truncated to PROCESS_NAME_LENGTH - 1)
+ * @return New process in PROCESS_READY state, or nullptr on failure
+ */
+Process* process_create(const char* name) {
+    Process* proc = nullptr;
+    uint32_t slot = 0;
+    for (; slot < MAX_PROCESSES; ++slot) {
+        if (process_table[slot].state == PROCESS_UNUSED) {
+            proc = &process_table[slot];
+            break;
+        }
+    }
+    if (!proc) {
+        return nullptr;  // Process table full
+    }
+
+    proc->page_directory = create_address_space();
+    if (!proc->page_directory) {
+        return nullptr;
+    }
+
+    proc->pid = next_pid++;
+    strncpy(proc->name, name ? name : "", PROCESS_NAME_LENGTH - 1);
+    proc->name[PROCESS_NAME_LENGTH - 1] = '\0';
+    proc->entry = USER_BASE;
+    proc->user_esp = USER_STACK_TOP;
+    proc->kernel_context = 0;
+    proc->kernel_stack = process_kernel_stacks[slot];
+    proc->exit_status = 0;
+    proc->state = PROCESS_READY;
+
+    uint32_t stack_size = USER_STACK_PAGES * PAGE_SIZE;
+    if (!process_map(proc, USER_STACK_TOP - stack_size, stack_size, PAGE_WRITABLE | PAGE_USER) ||
+        !syscall_map_vsyscall(proc->page_directory)) {
+        process_destroy(proc);
+        return nullptr;
+    }
+    return proc;
+}
+
+/**
+ * Map Zeroed User Memory
+ *
+ * Pages that are already mapped are left untouched, so overlapping requests
+ * (e.g. two ELF segments sharing a page) are safe.
+ *
+ * @param proc Target process
+ * @param vaddr Start address (need not be page aligned)
+ * @param size Number of bytes
+ * @param flags PAGE_* flags for new pages
+ * @return true on success, false if the range is outside user space or frames ran out
+ */
+bool process_map(Process* proc, uint32_t vaddr, uint32_t size, uint32_t flags) {
+    if (!proc || !process_user_range_ok(vaddr, size)) {
+        return false;
+    }
+    uint32_t end = PAGE_ALIGN_UP(vaddr + size);
+    for (uint32_t page = PAGE_ALIGN_DOWN(vaddr); page < end; page += PAGE_SIZE) {
+        if (translate_address(proc->page_directory, page)) {
+            continue;
+        }
+        uint32_t frame = alloc_frame();
+        if (!frame || !map_page(proc->page_directory, page, frame, flags)) {
+            if (frame) free_frame(frame);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Copy Data into User Memory
+ *
+ * Works without switching address spaces: each destination page is
+ * translated to its physical frame, which the kernel reaches through the
+ * identity mapping.
+ */
+bool process_copy_to(Process* proc, uint32_t vaddr, const void* src, uint32_t len) {
+    if (!proc || !process_user_range_ok(vaddr, len)) {
+        return false;
+    }
+    const uint8_t* s = (const uint8_t*)src;
+    while (len > 0) {
+        uint32_t paddr = translate_address(proc->page_directory, vaddr);
+        if (!paddr) {
+            return false;
+        }
+        uint32_t chunk = PAGE_SIZE - (vaddr & (PAGE_SIZE - 1));
+        if (chunk > len) chunk = len;
+        memcpy((void*)(uintptr_t)paddr, s, chunk);
+        s += chunk;
+        vaddr += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+/**
+ * Push a Word onto the Initial User Stack
+ */
+bool process_push(Process* proc, uint32_t value) {
+    if (!proc || proc->user_esp - 4 < USER_STACK_TOP - USER_STACK_PAGES * PAGE_SIZE) {
+        return false;  // Stack overflow
+    }
+    proc->user_esp -= 4;
+    return process_copy_to(proc, proc->user_esp, &value, 4);
+}
+
+/**
+ * Build the Initial argc/argv Frame
+ *
+ * Copies the argument strings to the top of the user stack, followed by the
+ * NULL-terminated argv array. On entry the program sees:
+ *   [esp] = argc, [esp + 4] = argv
+ *
+ * @param proc Process (stack still untouched)
+ * @param argc Number of arguments (at most PROCESS_MAX_ARGS)
+ * @param argv Argument strings
+ * @return true on success, false if the arguments do not fit
+ */
+bool process_push_args(Process* proc, uint32_t argc, const char* const* argv) {
+    if (!proc || argc > PROCESS_MAX_ARGS) {
+        return false;
+    }
+    uint32_t user_argv[PROCESS_MAX_ARGS + 1];
+    uint32_t sp = proc->user_esp;
+    uint32_t stack_floor = USER_STACK_TOP - USER_STACK_PAGES * PAGE_SIZE;
+
+    for (uint32_t i = argc; i-- > 0;) {
+        uint32_t len = strlen(argv[i]) + 1;
+        if (sp - stack_floor < len + PAGE_SIZE) {
+            return false;  // Keep at least a page of stack for the program
+        }
+        sp -= len;
+        if (!process_copy_to(proc, sp, argv[i], len)) {
+            return false;
+        }
+        user_argv[i] = sp;
+    }
+    user_argv[argc] = 0;
+
+    sp &= ~3u;
+    uint32_t array_size = (argc + 1) * sizeof(uint32_t);
+    sp -= array_size;
+    if (!process_copy_to(proc, sp, user_argv, array_size)) {
+        return false;
+    }
+    proc->user_esp = sp;
+    return process_push(proc, sp) && process_push(proc, argc);
+}
+
+/**
+ * Run a Process
+ *
+ * Activates the process (kernel stack, address space) and enters ring 3 on
+ * the calling task. Returns when the process exits.
+ *
+ * @return Exit status (PROCESS_FAULT_STATUS(vector) if killed by an exception)
+ */
+int32_t process_run(Process* proc) {
+    if (!proc || proc->state != PROCESS_READY) {
+        return -1;
+    }
+
+    Process* previous = current_process;
+    proc->state = PROCESS_RUNNING;
+    process_activate(proc);
+
+    int32_t status = user_enter(proc->entry, proc->user_esp, &proc->kernel_context);
+
+    // Back in the kernel: exit paths may arrive with interrupts disabled
+    process_activate(previous);
+    proc->state = PROCESS_EXITED;
+    proc->exit_status = status;
+    enable_interrupts();
+    return status;
+}
+
+/**
+ * Destroy a Process
+ *
+ * Releases the address space (all owned frames) and frees the slot.
+ */
+void process_destroy(Process* proc) {
+    if (!proc || proc == current_process) {
+        return;
+    }
+    destroy_address_space(proc->page_directory);
+    proc->page_directory = nullptr;
+    proc->state = PROCESS_UNUSED;
+}
+
+Process* process_current() {
+    return current_process;
+}
+
+/**
+ * Activate a Process Context
+ *
+ * Points the TSS and SYSENTER stack at the process's kernel stack and loads
+ * its page directory. Called when a process starts and whenever the kernel
+ * task running it is resumed. CR3 is only reloaded when it changes, so
+ * switching between kernel-only tasks does not flush the TLB.
+ *
+ * @param proc Process to activate, or nullptr for the kernel address space
+ */
+void process_activate(Process* proc) {
+    current_process = proc;
+    PageEntry* dir = proc ? proc->page_directory : kernel_page_directory();
+    if (proc) {
+        uintptr_t kernel_stack_top = (uintptr_t)(proc->kernel_stack + PROCESS_KERNEL_STACK_SIZE);
+        tss_set_kernel_stack(kernel_stack_top);
+        syscall_set_kernel_stack(kernel_stack_top);
+    }
+    if (dir != active_directory) {
+        switch_address_space(dir);
+        active_directory = dir;
+    }
+}
+
+/**
+ * Terminate the Current Process
+ *
+ * Never returns: unwinds to the kernel context saved by process_run().
+ */
+void process_exit(int32_t status) {
+    user_return(current_process->kernel_context, status);
+}
+
+/**
+ * Kill the Current Process after a CPU Exception in Ring 3
+ *
+ * The exception details have already been printed by exception_handler().
+ */
+void process_fault(uint8_t vector, uint32_t error_code, uint32_t eip) {
+    (void)error_code;
+    (void)eip;
+    terminal.write("Process '");
+    terminal.write(current_process->name);
+    terminal.write("' killed.\n");
+    process_exit(PROCESS_FAULT_STATUS(vector));
+}
+
+/**
+ * Validate a User Buffer
+ *
+ * @return true if [addr, addr + len) lies entirely inside user space
+ */
+bool process_user_range_ok(uint32_t addr, uint32_t len) {
+    return addr >= USER_BASE && addr <= USER_LIMIT && len <= USER_LIMIT - addr;
+}
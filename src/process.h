@@ -0,0 +1,86 @@
+/*
+ * ============================================================================
+ * RusticOS User Process Header (process.h)
+ * ============================================================================
+ *
+ * Defines ring-3 user processes. Each process owns a private page directory
+ * (sharing the supervisor-only kernel mappings), a private kernel stack used
+ * for system calls and interrupts, and runs until it exits or faults.
+ *
+ * User address space layout (a single 4 MiB page-table window):
+ *   USER_BASE        .. : Program image (code, data, bss)
+ *   .. USER_STACK_TOP   : User stack (USER_STACK_PAGES pages, grows down)
+ *   USER_VSYSCALL_ADDR  : Read-only system call trampoline page
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include "types.h"
+#include "paging.h"
+
+// ============================================================================
+// Process Constants
+// ============================================================================
+#define MAX_PROCESSES               4
+#define PROCESS_NAME_LENGTH         32
+#define PROCESS_KERNEL_STACK_SIZE   8192
+
+#define USER_BASE                   0x40000000      // Lowest user virtual address
+#define USER_LIMIT                  0x40400000      // One past the highest user address
+#define USER_VSYSCALL_ADDR          0x403FF000      // Keep in sync with crt0.s
+#define USER_STACK_TOP              USER_VSYSCALL_ADDR
+#define USER_STACK_PAGES            16              // 64 KB user stack
+
+// Exit status reported for a process killed by CPU exception N
+#define PROCESS_FAULT_STATUS(vector) (128 + (vector))
+#define PROCESS_KILLED_STATUS       255             // Killed by Ctrl+C or "kill"
+
+#define PROCESS_MAX_ARGS            16              // argv entries passed to a program
+
+enum ProcessState {
+    PROCESS_UNUSED = 0,     // Slot free
+    PROCESS_READY,          // Created, image being set up
+    PROCESS_RUNNING,        // Executing in ring 3 (or in a system call)
+    PROCESS_EXITED          // Finished; exit_status is valid
+};
+
+/**
+ * Process Control Block
+ */
+struct Process {
+    uint32_t pid;
+    ProcessState state;
+    char name[PROCESS_NAME_LENGTH];
+    PageEntry* page_directory;      // Private address space
+    uint32_t entry;                 // User entry point
+    uint32_t user_esp;              // Initial user stack pointer
+    uintptr_t kernel_context;       // Kernel esp saved by user_enter(), restored on exit
+    uint8_t* kernel_stack;          // Bottom of the private kernel stack
+    int32_t exit_status;
+};
+
+// Process lifecycle
+Process* process_create(const char* name);              // Allocate a process with an empty address space
+bool process_map(Process* proc, uint32_t vaddr, uint32_t size, uint32_t flags);   // Map zeroed user pages
+bool process_copy_to(Process* proc, uint32_t vaddr, const void* src, uint32_t len); // Copy into user memory
+bool process_push(Process* proc, uint32_t value);       // Push a word onto the initial user stack
+bool process_push_args(Process* proc, uint32_t argc, const char* const* argv);  // Build argc/argv on the user stack
+int32_t process_run(Process* proc);                     // Enter ring 3; returns the exit status
+void process_destroy(Process* proc);                    // Release the address space and slot
+
+// Called from system call / exception context
+Process* process_current();                             // Currently running process (or nullptr)
+void process_activate(Process* proc);                   // Load proc's address space and kernel stack (nullptr = kernel)
+void process_exit(int32_t status) __attribute__((noreturn));
+void process_fault(uint8_t vector, uint32_t error_code, uint32_t eip) __attribute__((noreturn));
+bool process_user_range_ok(uint32_t addr, uint32_t len);  // Validate a user buffer
+
+// Assembly helpers (crt0.s)
+extern "C" int32_t user_enter(uint32_t entry, uint32_t user_esp, uintptr_t* kernel_context);
+extern "C" void user_return(uintptr_t kernel_context, int32_t status) __attribute__((noreturn));
+
+#endif // PROCESS_H
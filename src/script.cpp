@@ -0,0 +1,562 @@
+/*
+ * ============================================================================
+ * RusticOS Shell Script Implementation (script.cpp)
+ * ============================================================================
+ *
+ * script_run() copies the script into a private buffer and compiles it in
+ * one pass: every line is tokenized in place (tokens point into the copy)
+ * and becomes one Statement. Block keywords are resolved to jump targets at
+ * compile time, so if/else/end and for/end cost a single index update at
+ * run time. Only unquoted words containing '$' (or a lone "*") are
+ * expanded per execution; all other words are handed to the shell as they
+ * are.
+ *
+ * Scripts use static state, so one script runs at a time.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "script.h"
+#include "command.h"
+#include "filesystem.h"
+#include "output.h"
+#include "task.h"
+#include "format.h"
+
+extern FileSystem filesystem;
+
+enum ScriptOp : uint8_t {
+    OP_RUN,             // Run the tokens as a command line
+    OP_SET,             // name=value
+    OP_IF,              // Run the condition; jump if it fails
+    OP_JUMP,            // Skip the else branch
+    OP_FOR,             // Assign the next item, or jump past the loop
+    OP_NEXT,            // Back to the matching OP_FOR
+    OP_EXIT
+};
+
+/**
+ * Statement - one compiled script line
+ */
+struct Statement {
+    ScriptOp op;
+    uint8_t loop;                   // FOR/NEXT: loop frame (nesting level)
+    uint16_t line;                  // Source line, for error messages
+    uint16_t first;                 // First token in script_tokens
+    uint16_t count;                 // Number of tokens
+    uint16_t jump;                  // Branch target (statement index)
+    const char* name;               // SET/FOR: variable name
+};
+
+/**
+ * LoopFrame - the expanded word list of a running "for"
+ *
+ * Expanded once when the loop starts; the items are copies, so commands in
+ * the body may change the variables or the directory being iterated.
+ */
+struct LoopFrame {
+    Token items[SCRIPT_MAX_ITEMS];
+    uint32_t count;
+    uint32_t next;
+    char text[SCRIPT_EXPAND_SIZE];
+};
+
+struct ScriptVar {
+    char name[SCRIPT_VAR_NAME_LENGTH];
+    char value[SCRIPT_VAR_VALUE_LENGTH];
+};
+
+// Compiled script
+static char script_text[SCRIPT_MAX_SIZE];
+static Token script_tokens[SCRIPT_MAX_TOKENS];
+static Statement statements[SCRIPT_MAX_STATEMENTS];
+static uint32_t statement_count = 0;
+
+// Run-time state
+static bool script_running = false;
+static const char* script_path = "";
+static uint32_t script_argc = 0;
+static const char* const* script_argv = nullptr;
+static int32_t last_status = 0;
+static ScriptVar vars[SCRIPT_MAX_VARS];
+static uint32_t var_count = 0;
+static LoopFrame loops[SCRIPT_MAX_DEPTH];
+static char line_text[SCRIPT_EXPAND_SIZE];      // Expansion of the current line
+
+static bool is_name_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/**
+ * Report a Script Error as "file:line: message"
+ */
+static void script_error(uint32_t line, const char* message) {
+    kprintf(command_system.out(), "%s:%u: %s\n", script_path, line, message);
+}
+
+// ============================================================================
+// Variables
+// ============================================================================
+
+static ScriptVar* find_var(const char* name, uint32_t len) {
+    for (uint32_t i = 0; i < var_count; ++i) {
+        uint32_t k = 0;
+        while (k < len && vars[i].name[k] == name[k]) k++;
+        if (k == len && vars[i].name[len] == '\0') {
+            return &vars[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Set a Variable
+ *
+ * Values longer than SCRIPT_VAR_VALUE_LENGTH - 1 are truncated.
+ *
+ * @return false if the variable table is full
+ */
+static bool set_var(const char* name, const char* value) {
+    ScriptVar* var = find_var(name, strlen(name));
+    if (!var) {
+        if (var_count == SCRIPT_MAX_VARS) {
+            return false;
+        }
+        var = &vars[var_count++];
+        strncpy(var->name, name, SCRIPT_VAR_NAME_LENGTH - 1);
+        var->name[SCRIPT_VAR_NAME_LENGTH - 1] = '\0';
+    }
+    strncpy(var->value, value, SCRIPT_VAR_VALUE_LENGTH - 1);
+    var->value[SCRIPT_VAR_VALUE_LENGTH - 1] = '\0';
+    return true;
+}
+
+/**
+ * Resolve the Variable Reference after a '$'
+ *
+ * @param p Character after the '$'
+ * @param value Receives the value ("" for unset variables)
+ * @param number Scratch space for numeric values (12 bytes)
+ * @return Pointer past the reference
+ */
+static const char* resolve_var(const char* p, const char** value, char* number) {
+    if (*p == '?' || *p == '#') {
+        ksnprintf(number, 12, "%d", *p == '?' ? last_status : (int32_t)script_argc - 1);
+        *value = number;
+        return p + 1;
+    }
+    if (*p >= '0' && *p <= '9') {
+        uint32_t index = *p - '0';
+        *value = (index < script_argc) ? script_argv[index] : "";
+        return p + 1;
+    }
+    const char* end = p;
+    while (is_name_char(*end)) end++;
+    if (end == p) {
+        *value = "$";               // Lone '$' stays literal
+        return p;
+    }
+    ScriptVar* var = find_var(p, end - p);
+    *value = var ? var->value : "";
+    return end;
+}
+
+/**
+ * Expand the Words of a Statement
+ *
+ * Words without '$' are copied by pointer. A word that is exactly "*"
+ * becomes one word per entry of the current directory. Expanded values
+ * are not split: $x is always one word. Quoted words ("*", "$x", \$x)
+ * are literal and copied by pointer too; expansion results are marked
+ * quoted, so they are never expanded again.
+ *
+ * @param in Compiled tokens
+ * @param count Number of compiled tokens
+ * @param out Receives the expanded tokens
+ * @param max Capacity of out
+ * @param text Storage for expanded words
+ * @return Number of tokens, or -1 if out or text is too small
+ */
+static int32_t expand_words(const Token* in, uint32_t count, Token* out, uint32_t max, char* text) {
+    uint32_t n = 0;
+    uint32_t used = 0;
+    char number[12];
+    for (uint32_t i = 0; i < count; ++i) {
+        const Token& token = in[i];
+        bool literal = token.type != TOKEN_WORD || token.quoted;
+        bool glob = (!literal && strcmp(token.text, "*") == 0);
+        bool substitute = false;
+        if (!literal) {
+            for (const char* p = token.text; *p; ++p) {
+                if (*p == '$') substitute = true;
+            }
+        }
+
+        if (glob) {
+            FileNode* dir = filesystem.get_current_dir();
+            for (uint32_t c = 0; c < dir->child_count; ++c) {
+                uint32_t len = strlen(dir->children[c]->name) + 1;
+                if (n == max || used + len > SCRIPT_EXPAND_SIZE) {
+                    return -1;
+                }
+                memcpy(text + used, dir->children[c]->name, len);
+                out[n].type = TOKEN_WORD;
+                out[n].quoted = true;
+                out[n++].text = text + used;
+                used += len;
+            }
+            continue;
+        }
+        if (n == max) {
+            return -1;
+        }
+        if (!substitute) {
+            out[n++] = token;
+            continue;
+        }
+
+        char* start = text + used;
+        for (const char* p = token.text; *p;) {
+            const char* value = p;
+            uint32_t len = 1;
+            if (*p == '$') {
+                p = resolve_var(p + 1, &value, number);
+                len = strlen(value);
+            } else {
+                p++;
+            }
+            if (used + len + 1 > SCRIPT_EXPAND_SIZE) {
+                return -1;
+            }
+            memcpy(text + used, value, len);
+            used += len;
+        }
+        text[used++] = '\0';
+        out[n].type = TOKEN_WORD;
+        out[n].quoted = true;
+        out[n++].text = start;
+    }
+    return (int32_t)n;
+}
+
+// ============================================================================
+// Compiler
+// ============================================================================
+
+/**
+ * Open Block during Compilation
+ */
+struct Block {
+    ScriptOp op;                    // OP_IF, OP_JUMP (inside else) or OP_FOR
+    uint32_t index;                 // Statement that needs the jump target
+};
+
+static bool word_is(const Token& token, const char* word) {
+    return token.type == TOKEN_WORD && strcmp(token.text, word) == 0;
+}
+
+static bool valid_name(const char* name, uint32_t len) {
+    if (len == 0 || len >= SCRIPT_VAR_NAME_LENGTH || (name[0] >= '0' && name[0] <= '9')) {
+        return false;
+    }
+    for (uint32_t i = 0; i < len; ++i) {
+        if (!is_name_char(name[i])) return false;
+    }
+    return true;
+}
+
+/**
+ * Compile the Script Text
+ *
+ * @return Error message with *error_line set, or nullptr on success
+ */
+static const char* compile(uint32_t size, uint32_t* error_line) {
+    Block blocks[SCRIPT_MAX_DEPTH];
+    uint32_t depth = 0;
+    uint32_t loop_depth = 0;
+    uint32_t token_count = 0;
+    statement_count = 0;
+
+    char* p = script_text;
+    char* end = script_text + size;
+    uint32_t line = 0;
+    while (p < end) {
+        // Cut out one line; tabs separate words like spaces
+        char* text = p;
+        while (p < end && *p != '\n') {
+            if (*p == '\t' || *p == '\r') *p = ' ';
+            p++;
+        }
+        *p++ = '\0';
+        *error_line = ++line;
+
+        while (*text == ' ') text++;
+        if (*text == '#' || *text == '\0') {
+            continue;
+        }
+        Token* tokens = script_tokens + token_count;
+        uint32_t n = 0;
+        const char* error = tokenize(text, tokens, SCRIPT_MAX_TOKENS - token_count, &n);
+        if (error) {
+            return error;
+        }
+        if (n == 0) {
+            continue;
+        }
+        if (statement_count == SCRIPT_MAX_STATEMENTS) {
+            return "script too long";
+        }
+
+        uint32_t index = statement_count;
+        Statement& s = statements[index];
+        s.op = OP_RUN;
+        s.loop = 0;
+        s.line = line;
+        s.first = token_count;
+        s.count = n;
+        s.jump = 0;
+        s.name = nullptr;
+        token_count += n;
+
+        bool is_else = word_is(tokens[0], "else");
+        if (is_else || word_is(tokens[0], "end")) {
+            if (n != 1) {
+                return "unexpected words after else/end";
+            }
+            if (depth == 0 || (is_else && blocks[depth - 1].op != OP_IF)) {
+                return is_else ? "else without if" : "end without if or for";
+            }
+            Block& block = blocks[depth - 1];
+            if (is_else) {
+                s.op = OP_JUMP;                             // Then-branch skips the else-branch
+                statements[block.index].jump = index + 1;
+                block = { OP_JUMP, index };
+                statement_count++;
+            } else if (block.op == OP_FOR) {
+                s.op = OP_NEXT;
+                s.jump = block.index;
+                s.loop = statements[block.index].loop;
+                statements[block.index].jump = index + 1;
+                statement_count++;
+                loop_depth--;
+                depth--;
+            } else {
+                statements[block.index].jump = index;       // "end" of an if emits nothing
+                depth--;
+            }
+            continue;
+        }
+
+        if (word_is(tokens[0], "if") || word_is(tokens[0], "for")) {
+            if (depth == SCRIPT_MAX_DEPTH) {
+                return "blocks nested too deeply";
+            }
+            if (word_is(tokens[0], "if")) {
+                if (n < 2) {
+                    return "if needs a command";
+                }
+                s.op = OP_IF;
+                s.first += 1;
+                s.count -= 1;
+            } else {
+                if (n < 3 || tokens[1].type != TOKEN_WORD ||
+                    !valid_name(tokens[1].text, strlen(tokens[1].text)) || !word_is(tokens[2], "in")) {
+                    return "usage: for NAME in words...";
+                }
+                s.op = OP_FOR;
+                s.name = tokens[1].text;
+                s.loop = loop_depth++;
+                s.first += 3;
+                s.count -= 3;
+            }
+            blocks[depth++] = { s.op, index };
+        } else if (word_is(tokens[0], "exit")) {
+            if (n > 2) {
+                return "usage: exit [status]";
+            }
+            s.op = OP_EXIT;
+            s.first += 1;
+            s.count -= 1;
+        } else if (n == 1 && tokens[0].type == TOKEN_WORD) {
+            // NAME=value (the word lives in script_text, so it can be split in place)
+            char* word = (char*)tokens[0].text;
+            char* equals = word;
+            while (*equals && *equals != '=') equals++;
+            if (*equals == '=' && valid_name(word, equals - word)) {
+                *equals = '\0';
+                s.op = OP_SET;
+                s.name = word;
+                tokens[0].text = equals + 1;
+            }
+        }
+        statement_count++;
+    }
+
+    if (depth > 0) {
+        *error_line = statements[blocks[depth - 1].index].line;
+        return "missing end";
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Interpreter
+// ============================================================================
+
+/**
+ * Parse an Exit Status Argument
+ */
+static bool parse_status(const char* text, int32_t* value) {
+    if (*text == '\0') {
+        return false;
+    }
+    int32_t result = 0;
+    for (; *text; ++text) {
+        if (*text < '0' || *text > '9' || result > 100000) {
+            return false;
+        }
+        result = result * 10 + (*text - '0');
+    }
+    *value = result;
+    return true;
+}
+
+/**
+ * Run the Compiled Statements
+ *
+ * @return Exit status of the script
+ */
+static int32_t execute() {
+    Token line[MAX_TOKENS];
+    bool resume = false;            // OP_FOR reached from its OP_NEXT
+    uint32_t pc = 0;
+    while (pc < statement_count) {
+        if (task_poll()) {
+            return 130;
+        }
+        const Statement& s = statements[pc];
+        const Token* tokens = script_tokens + s.first;
+        int32_t n = 0;
+
+        switch (s.op) {
+            case OP_RUN:
+            case OP_IF:
+                n = expand_words(tokens, s.count, line, MAX_TOKENS, line_text);
+                if (n < 0) {
+                    script_error(s.line, "line too long after expansion");
+                    return 2;
+                }
+                last_status = command_system.run_tokens(line, n);
+                pc = (s.op == OP_IF && last_status != 0) ? s.jump : pc + 1;
+                break;
+
+            case OP_SET:
+                if (expand_words(tokens, 1, line, 1, line_text) != 1) {
+                    script_error(s.line, "value too long");
+                    return 2;
+                }
+                if (!set_var(s.name, line[0].text)) {
+                    script_error(s.line, "too many variables");
+                    return 2;
+                }
+                pc++;
+                break;
+
+            case OP_JUMP:
+                pc = s.jump;
+                break;
+
+            case OP_FOR: {
+                LoopFrame& frame = loops[s.loop];
+                if (!resume) {
+                    n = expand_words(tokens, s.count, frame.items, SCRIPT_MAX_ITEMS, frame.text);
+                    if (n < 0) {
+                        script_error(s.line, "too many loop items");
+                        return 2;
+                    }
+                    frame.count = n;
+                    frame.next = 0;
+                }
+                resume = false;
+                if (frame.next < frame.count) {
+                    if (!set_var(s.name, frame.items[frame.next++].text)) {
+                        script_error(s.line, "too many variables");
+                        return 2;
+                    }
+                    pc++;
+                } else {
+                    pc = s.jump;
+                }
+                break;
+            }
+
+            case OP_NEXT:
+                resume = true;
+                pc = s.jump;
+                break;
+
+            case OP_EXIT: {
+                if (s.count == 0) {
+                    return last_status;
+                }
+                int32_t status = 0;
+                if (expand_words(tokens, 1, line, 1, line_text) != 1 || !parse_status(line[0].text, &status)) {
+                    script_error(s.line, "exit: bad status");
+                    return 2;
+                }
+                return status;
+            }
+        }
+    }
+    return last_status;
+}
+
+/**
+ * Run a Script File
+ *
+ * Output goes to the calling command's out(), so "run x > log" captures
+ * everything the script prints.
+ *
+ * @param argc Number of arguments including the script path
+ * @param argv argv[0] = script path, argv[1..] = $1..$9
+ * @return Exit status: the script's, 2 for a compile error, 1 if the file
+ *         cannot be run, 130 if interrupted
+ */
+int32_t script_run(uint32_t argc, const char* const* argv) {
+    OutputSink& out = command_system.out();
+    if (script_running) {
+        out.write("Error: a script is already running\n");
+        return 1;
+    }
+    FileNode* file = filesystem.lookup(argv[0]);
+    if (!file || file->type != FILE_TYPE_FILE) {
+        out.write("Error: file not found: ");
+        out.write(argv[0]);
+        out.write("\n");
+        return 1;
+    }
+    if (file->size >= SCRIPT_MAX_SIZE) {
+        out.write("Error: script too large\n");
+        return 1;
+    }
+
+    script_path = argv[0];
+    memcpy(script_text, file->data, file->size);
+    script_text[file->size] = '\0';
+    uint32_t error_line = 0;
+    const char* error = compile(file->size, &error_line);
+    if (error) {
+        script_error(error_line, error);
+        return 2;
+    }
+
+    script_running = true;
+    script_argc = argc;
+    script_argv = argv;
+    last_status = 0;
+    var_count = 0;
+    int32_t status = execute();
+    script_running = false;
+    return status;
+}
@@ -0,0 +1,48 @@
+/*
+ * ============================================================================
+ * RusticOS Shell Script Header (script.h)
+ * ============================================================================
+ *
+ * Runs shell scripts stored in the filesystem ("run <file> [args...]").
+ * A script is compiled once into a flat instruction list over pre-split
+ * tokens, so loops re-run lines without tokenizing them again.
+ *
+ * Script language (one statement per line):
+ *   # comment
+ *   NAME=value                       Set a variable
+ *   command args...                  Any shell line (pipes, redirection)
+ *   if command ... [else ...] end    Branch on the command's exit status
+ *   for NAME in words... ... end     Loop; a "*" word lists the current directory
+ *   exit [status]                    Stop (default: status of the last command)
+ *
+ * Words may reference $NAME, $0..$9 (script path and arguments), $# and $?
+ * (exit status of the last command). A word with quotes or a backslash is
+ * taken literally: "$HOME", \$HOME and "*" are not expanded. Statements
+ * nest up to SCRIPT_MAX_DEPTH levels.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include "types.h"
+
+// ============================================================================
+// Script Limits
+// ============================================================================
+#define SCRIPT_MAX_SIZE         4096    // Script file size in bytes
+#define SCRIPT_MAX_TOKENS       512     // Tokens in the whole script
+#define SCRIPT_MAX_STATEMENTS   128     // Compiled instructions
+#define SCRIPT_MAX_DEPTH        8       // Nested if/for blocks
+#define SCRIPT_MAX_VARS         16
+#define SCRIPT_VAR_NAME_LENGTH  16
+#define SCRIPT_VAR_VALUE_LENGTH 64
+#define SCRIPT_MAX_ITEMS        64      // Words a "for" loop iterates over
+#define SCRIPT_EXPAND_SIZE      2048    // Expanded text of one line or loop list
+
+// Script functions
+int32_t script_run(uint32_t argc, const char* const* argv);    // argv[0] = script path; returns the exit status
+
+#endif // SCRIPT_H
@@ -0,0 +1,72 @@
+/*
+ * ============================================================================
+ * RusticOS Serial Port Implementation (serial.cpp)
+ * ============================================================================
+ *
+ * Each byte waits for the transmit holding register to drain (LSR bit 5)
+ * instead of a fixed delay loop, so output runs at line speed on real
+ * hardware and without stalls under QEMU.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "serial.h"
+
+static inline uint8_t inb(uint16_t port) {
+    uint8_t result;
+    asm volatile("inb %1, %0" : "=a"(result) : "Nd"(port));
+    return result;
+}
+
+static inline void outb(uint16_t port, uint8_t value) {
+    asm volatile("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+/**
+ * ============================================================================
+ * Initialize Serial Port (COM1)
+ * ============================================================================
+ * 
+ * Configures COM1 (serial port) for debugging output at 115200 baud.
+ * Serial output appears on COM1 and can be captured via QEMU's -serial option.
+ * 
+ * Configuration:
+ *   - Port: COM1 (0x3F8)
+ *   - Baud rate: 115200 (divisor = 1)
+ *   - Data bits: 8
+ *   - Parity: None
+ *   - Stop bits: 1
+ *   - FIFO: Enabled (14-byte threshold)
+ * ============================================================================
+ */
+void init_serial() {
+    outb(SERIAL_IER, 0x00);        // Disable all interrupts
+    outb(SERIAL_LCR, 0x80);        // Enable DLAB (set baud rate divisor)
+    outb(SERIAL_PORT, SERIAL_BAUD_DIV);     // Set divisor low byte (115200 baud)
+    outb(SERIAL_IER, 0x00);        // Set divisor high byte to 0
+    outb(SERIAL_LCR, 0x03);        // Disable DLAB, set 8 bits, no parity, 1 stop
+    outb(SERIAL_FCR, 0xC7);        // Enable FIFO, clear it, set level to 14 bytes
+}
+
+/**
+ * Write Bytes to COM1
+ * 
+ * @param data Bytes to send
+ * @param len Number of bytes
+ */
+void serial_write(const char* data, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) {
+        while (!(inb(SERIAL_LSR) & SERIAL_LSR_THR_EMPTY)) {}
+        outb(SERIAL_PORT, data[i]);
+    }
+}
+
+/**
+ * Write a string to serial port
+ * 
+ * @param str Null-terminated string to output
+ */
+void serial_write(const char* str) {
+    serial_write(str, strlen(str));
+}
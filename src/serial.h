@@ -0,0 +1,35 @@
+/*
+ * ============================================================================
+ * RusticOS Serial Port Header (serial.h)
+ * ============================================================================
+ *
+ * Polled output on COM1 (115200 baud, 8N1). Used for boot messages and for
+ * machine-readable output (benchmark results) that the host captures with
+ * QEMU's -serial option.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include "types.h"
+
+// ============================================================================
+// Serial Port (COM1) Constants
+// ============================================================================
+#define SERIAL_PORT     0x3F8
+#define SERIAL_BAUD_DIV 0x01                // Divisor for 115200 baud
+#define SERIAL_IER      (SERIAL_PORT + 1)
+#define SERIAL_FCR      (SERIAL_PORT + 2)
+#define SERIAL_LCR      (SERIAL_PORT + 3)
+#define SERIAL_LSR      (SERIAL_PORT + 5)
+#define SERIAL_LSR_THR_EMPTY    0x20        // Transmit holding register can take a byte
+
+// Serial functions
+void init_serial();                                 // Configure COM1
+void serial_write(const char* str);                 // Write a NUL-terminated string
+void serial_write(const char* data, uint32_t len);  // Write len bytes
+
+#endif // SERIAL_H
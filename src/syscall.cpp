@@ -0,0 +1,167 @@
+/*
+ * ============================================================================
+ * RusticOS System Call Implementation (syscall.cpp)
+ * ============================================================================
+ *
+ * Sets up the SYSENTER fast path (with INT 0x80 as fallback), owns the
+ * shared trampoline page mapped into every process and dispatches system
+ * calls coming from either entry stub.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "syscall.h"
+#include "process.h"
+#include "paging.h"
+#include "gdt.h"
+#include "task.h"
+#include "output.h"
+
+static bool sysenter_supported = false;
+static uint32_t vsyscall_frame = 0;     // Physical frame holding the trampoline
+
+static inline void write_msr(uint32_t msr, uint32_t low, uint32_t high) {
+    asm volatile("wrmsr" : : "c"(msr), "a"(low), "d"(high));
+}
+
+/**
+ * Check CPUID for SYSENTER/SYSEXIT support
+ *
+ * CPUID.01h:EDX bit 11 (SEP). Family 6 with model < 3 and stepping < 3
+ * (original Pentium Pro) sets the bit without supporting the instructions.
+ * A long-mode kernel additionally needs an Intel CPU: AMD processors raise
+ * #UD for SYSENTER from compatibility mode.
+ */
+static bool cpu_has_sysenter() {
+    uint32_t eax, ebx, ecx, edx;
+#ifdef __x86_64__
+    asm volatile("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(0));
+    if (ebx != 0x756E6547 || edx != 0x49656E69 || ecx != 0x6C65746E) {    // "GenuineIntel"
+        return false;
+    }
+#endif
+    asm volatile("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(1));
+    uint32_t family = (eax >> 8) & 0xF;
+    uint32_t model = (eax >> 4) & 0xF;
+    uint32_t stepping = eax & 0xF;
+    if (family == 6 && model < 3 && stepping < 3) {
+        return false;
+    }
+    return (edx & (1u << 11)) != 0;
+}
+
+/**
+ * Initialize System Calls
+ *
+ * Programs the SYSENTER MSRs when available and prepares the trampoline
+ * page. Requires paging (the trampoline lives in a pool frame) and the
+ * kernel GDT (SYSENTER derives its selectors from GDT_KERNEL_CODE).
+ */
+void init_syscalls() {
+    sysenter_supported = cpu_has_sysenter();
+    if (sysenter_supported) {
+        write_msr(MSR_SYSENTER_CS, GDT_KERNEL_CODE, 0);
+        uintptr_t entry = (uintptr_t)sysenter_entry;
+        write_msr(MSR_SYSENTER_EIP, (uint32_t)entry, (uint32_t)((uint64_t)entry >> 32));
+    }
+
+    const uint8_t* start = sysenter_supported ? vsyscall_sysenter_start : vsyscall_int80_start;
+    const uint8_t* end = sysenter_supported ? vsyscall_sysenter_end : vsyscall_int80_end;
+    vsyscall_frame = alloc_frame();
+    if (vsyscall_frame) {
+        memcpy((void*)(uintptr_t)vsyscall_frame, start, end - start);
+    }
+}
+
+bool syscall_has_sysenter() {
+    return sysenter_supported;
+}
+
+/**
+ * Set the SYSENTER Kernel Stack
+ *
+ * SYSENTER does not consult the TSS, so the stack must be kept in sync with
+ * tss_set_kernel_stack() whenever a different process is scheduled.
+ */
+void syscall_set_kernel_stack(uintptr_t esp0) {
+    if (sysenter_supported) {
+        write_msr(MSR_SYSENTER_ESP, (uint32_t)esp0, (uint32_t)((uint64_t)esp0 >> 32));
+    }
+}
+
+/**
+ * Map the Trampoline into an Address Space
+ *
+ * The page is shared by all processes, so it is mapped read-only and marked
+ * PAGE_SHARED to keep destroy_address_space() from freeing it.
+ */
+bool syscall_map_vsyscall(PageEntry* page_directory) {
+    if (!vsyscall_frame) {
+        return false;
+    }
+    return map_page(page_directory, USER_VSYSCALL_ADDR, vsyscall_frame, PAGE_USER | PAGE_SHARED);
+}
+
+/**
+ * SYS_WRITE: write(fd, buf, len)
+ *
+ * Reads the user buffer page by page through the page tables, so an
+ * unmapped pointer yields SYSCALL_EFAULT instead of a kernel page fault.
+ * Writing to a full pipe blocks the calling task.
+ */
+static uint32_t sys_write(uint32_t fd, uint32_t buf, uint32_t len) {
+    if (fd != 1 && fd != 2) {
+        return SYSCALL_EINVAL;
+    }
+    Process* proc = process_current();
+    if (!process_user_range_ok(buf, len)) {
+        return SYSCALL_EFAULT;
+    }
+
+    // stdout follows the task's sink (terminal, file or pipe); stderr is always the terminal
+    OutputSink* out = (fd == 1) ? task_current()->out : &terminal_sink;
+    uint32_t written = 0;
+    while (written < len) {
+        uint32_t vaddr = buf + written;
+        uint32_t paddr = translate_address(proc->page_directory, vaddr);
+        if (!paddr) {
+            out->flush();
+            return written ? written : SYSCALL_EFAULT;
+        }
+        uint32_t chunk = PAGE_SIZE - (vaddr & (PAGE_SIZE - 1));
+        if (chunk > len - written) chunk = len - written;
+        out->write((const char*)(uintptr_t)paddr, chunk);
+        written += chunk;
+    }
+    // Keep program output in order with kernel messages (e.g. a fault report)
+    out->flush();
+    return written;
+}
+
+/**
+ * System Call Dispatcher - called from isr128 and sysenter_entry
+ *
+ * @param frame Saved user registers; frame->eax receives the return value
+ */
+extern "C" void syscall_dispatch(SyscallFrame* frame) {
+    uint32_t result = SYSCALL_EINVAL;
+
+    switch (frame->eax) {
+        case SYS_NULL:
+            result = 0;
+            break;
+
+        case SYS_EXIT:
+            process_exit((int32_t)frame->ebx);  // Does not return
+
+        case SYS_WRITE:
+            result = sys_write(frame->ebx, frame->esi, frame->edi);
+            break;
+
+        default:
+            break;
+    }
+
+    frame->eax = result;
+}
@@ -0,0 +1,80 @@
+/*
+ * ============================================================================
+ * RusticOS System Call Interface Header (syscall.h)
+ * ============================================================================
+ *
+ * Defines the user -> kernel system call ABI.
+ *
+ * Entry paths:
+ *   - SYSENTER/SYSEXIT (fast path, used when CPUID reports SEP)
+ *   - INT 0x80 (fallback, always available)
+ *
+ * User code does not pick a path itself: it calls the trampoline mapped at
+ * USER_VSYSCALL_ADDR, which the kernel fills with whichever stub the CPU
+ * supports.
+ *
+ * Register convention (both paths):
+ *   EAX = system call number / return value
+ *   EBX = argument 1, ESI = argument 2, EDI = argument 3
+ *   (ECX/EDX are reserved: SYSEXIT takes the user ESP/EIP from them)
+ *
+ * The x86-64 build runs the same 32-bit programs in compatibility mode; its
+ * entry stubs (crt0_64.s) build the same 32-bit SyscallFrame.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef SYSCALL_H
+#define SYSCALL_H
+
+#include "types.h"
+#include "paging.h"
+
+// ============================================================================
+// System Call Numbers
+// ============================================================================
+#define SYS_NULL        0       // Do nothing (round-trip benchmark)
+#define SYS_EXIT        1       // exit(status)
+#define SYS_WRITE       2       // write(fd, buf, len) -> bytes written
+#define SYS_COUNT       3
+
+#define SYSCALL_VECTOR  0x80    // INT 0x80 fallback vector
+
+// Error return values
+#define SYSCALL_EINVAL  ((uint32_t)-1)     // Bad argument or unknown call
+#define SYSCALL_EFAULT  ((uint32_t)-2)     // Bad user pointer
+
+// Model-specific registers used by SYSENTER
+#define MSR_SYSENTER_CS     0x174
+#define MSR_SYSENTER_ESP    0x175
+#define MSR_SYSENTER_EIP    0x176
+
+/**
+ * Register frame built by the entry stubs (PUSHA layout)
+ *
+ * The handler's return value is written back into eax and restored by POPA.
+ */
+struct SyscallFrame {
+    uint32_t edi, esi, ebp, esp_unused, ebx, edx, ecx, eax;
+};
+
+// System call functions
+void init_syscalls();                               // Detect SEP and program the SYSENTER MSRs
+bool syscall_has_sysenter();                        // True if the fast path is in use
+void syscall_set_kernel_stack(uintptr_t esp0);      // SYSENTER stack for the next process
+bool syscall_map_vsyscall(PageEntry* page_directory); // Map the trampoline page into an address space
+
+// Called from the entry stubs (crt0.s)
+extern "C" void syscall_dispatch(SyscallFrame* frame);
+
+// Entry stubs and trampolines (crt0.s)
+extern "C" {
+    void isr128();
+    void sysenter_entry();
+    extern const uint8_t vsyscall_sysenter_start[], vsyscall_sysenter_end[];
+    extern const uint8_t vsyscall_int80_start[], vsyscall_int80_end[];
+    extern const uint8_t user_bench_start[], user_bench_end[];   // Null system call benchmark
+}
+
+#endif // SYSCALL_H
@@ -0,0 +1,256 @@
+/*
+ * ============================================================================
+ * RusticOS Kernel Task Implementation (task.cpp)
+ * ============================================================================
+ *
+ * Round-robin cooperative scheduler over a fixed task table with statically
+ * allocated stacks, plus job cancellation. Kernel code is only switched at
+ * task_yield(); the one forced switch is from the timer interrupt while
+ * ring-3 code runs, where no kernel state can be half-updated.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "task.h"
+#include "output.h"
+#include "process.h"
+#include "interrupt.h"
+
+static Task task_table[MAX_TASKS];
+static uint8_t task_stacks[MAX_TASKS][TASK_STACK_SIZE] __attribute__((aligned(16)));
+static Task* current_task = nullptr;
+static uint32_t next_task_id = 1;
+static volatile uint32_t foreground_job = 0;
+
+/**
+ * First code run by a new task (reached through task_switch's RET)
+ */
+static void task_start() {
+    process_activate(nullptr);
+    current_task->entry(current_task->arg);
+    task_exit();
+}
+
+/**
+ * Initialize Tasking
+ *
+ * The caller (kernel_main) becomes task 0, writing to the terminal.
+ */
+void init_tasks() {
+    for (uint32_t i = 0; i < MAX_TASKS; ++i) {
+        task_table[i].state = TASK_UNUSED;
+    }
+    Task* shell = &task_table[0];
+    shell->id = 0;
+    shell->state = TASK_READY;
+    strncpy(shell->name, "shell", TASK_NAME_LENGTH - 1);
+    shell->name[TASK_NAME_LENGTH - 1] = '\0';
+    shell->stack = nullptr;
+    shell->out = &terminal_sink;
+    shell->in = nullptr;
+    shell->process = nullptr;
+    shell->job = 0;
+    shell->cancelled = false;
+    shell->status = 0;
+    shell->slice_start = 0;
+    current_task = shell;
+}
+
+/**
+ * Create a Task
+ *
+ * The new task inherits the creator's standard input and output; the
+ * caller may redirect them before the task first runs.
+ *
+ * @param name Task name (truncated to TASK_NAME_LENGTH - 1)
+ * @param entry Function to run
+ * @param arg Argument passed to entry
+ * @return Ready task, or nullptr if the table is full
+ */
+Task* task_create(const char* name, TaskEntry entry, void* arg) {
+    for (uint32_t slot = 1; slot < MAX_TASKS; ++slot) {
+        Task* task = &task_table[slot];
+        if (task->state != TASK_UNUSED) {
+            continue;
+        }
+        task->id = next_task_id++;
+        strncpy(task->name, name ? name : "", TASK_NAME_LENGTH - 1);
+        task->name[TASK_NAME_LENGTH - 1] = '\0';
+        task->stack = task_stacks[slot];
+        task->entry = entry;
+        task->arg = arg;
+        task->out = current_task->out;
+        task->in = current_task->in;
+        task->process = nullptr;
+        task->job = current_task->job;
+        task->cancelled = false;
+        task->status = 0;
+        task->slice_start = 0;
+
+        // Initial frame popped by task_switch: eflags, edi, esi, ebx, ebp, return address
+        // (x86-64: rflags, r15, r14, r13, r12, rbx, rbp, return address)
+        uintptr_t* sp = (uintptr_t*)(task->stack + TASK_STACK_SIZE);
+        *--sp = 0;                          // Fake return address for task_start
+        *--sp = (uintptr_t)task_start;
+        *--sp = 0;                          // ebp
+        *--sp = 0;                          // ebx
+        *--sp = 0;                          // esi / r12
+        *--sp = 0;                          // edi / r13
+#ifdef __x86_64__
+        *--sp = 0;                          // r14
+        *--sp = 0;                          // r15
+#endif
+        *--sp = 0x202;                      // eflags: IF set
+        task->esp = (uintptr_t)sp;
+        task->state = TASK_READY;
+        return task;
+    }
+    return nullptr;
+}
+
+Task* task_current() {
+    return current_task;
+}
+
+/**
+ * Yield the CPU
+ *
+ * Switches to the next ready task after the current one (wrapping around).
+ * Returns immediately if no other task is ready. On return the task's
+ * user process (if any) is active again.
+ */
+void task_yield() {
+    uint32_t index = current_task - task_table;
+    for (uint32_t step = 1; step <= MAX_TASKS; ++step) {
+        Task* next = &task_table[(index + step) % MAX_TASKS];
+        if (next->state != TASK_READY || next == current_task) {
+            continue;
+        }
+        Task* prev = current_task;
+        prev->process = process_current();
+        next->slice_start = get_ticks();
+        current_task = next;
+        task_switch(&prev->esp, next->esp);
+        process_activate(current_task->process);
+        return;
+    }
+}
+
+/**
+ * Wait for a Task to Finish
+ *
+ * Keeps yielding until the task's entry function has returned, then frees
+ * its slot.
+ *
+ * @return The task's final exit status (-1 for an invalid task)
+ */
+int32_t task_wait(Task* task) {
+    if (!task || task == current_task) {
+        return -1;
+    }
+    while (task->state == TASK_READY) {
+        task_yield();
+    }
+    task->state = TASK_UNUSED;
+    return task->status;
+}
+
+/**
+ * Finish the Current Task
+ *
+ * The slot stays TASK_DONE until task_wait() reaps it.
+ */
+void task_exit() {
+    current_task->state = TASK_DONE;
+    current_task->process = nullptr;
+    task_yield();
+    for (;;) {
+        asm volatile("hlt");  // Unreachable: task 0 never exits
+    }
+}
+
+/**
+ * Count Free Task Slots
+ *
+ * Lets callers that need several tasks at once (pipelines) fail up front
+ * instead of leaving half a pipeline running.
+ */
+uint32_t task_free_slots() {
+    uint32_t count = 0;
+    for (uint32_t i = 1; i < MAX_TASKS; ++i) {
+        if (task_table[i].state == TASK_UNUSED) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// Job Control
+// ============================================================================
+
+void task_set_foreground(uint32_t job) {
+    foreground_job = job;
+}
+
+/**
+ * Ctrl+C - cancel the foreground job
+ *
+ * Runs in interrupt context, so it only sets flags.
+ */
+void task_interrupt_foreground() {
+    task_cancel_job(foreground_job);
+}
+
+void task_cancel_job(uint32_t job) {
+    for (uint32_t i = 0; i < MAX_TASKS; ++i) {
+        if (task_table[i].state != TASK_UNUSED && task_table[i].job == job) {
+            task_table[i].cancelled = true;
+        }
+    }
+}
+
+bool task_cancelled() {
+    return current_task && current_task->cancelled;
+}
+
+void task_clear_cancel() {
+    current_task->cancelled = false;
+}
+
+/**
+ * Poll Point for Long-Running Kernel Code
+ *
+ * Cheap enough to call once per loop iteration: it only yields when the
+ * task has held the CPU for TASK_SLICE_TICKS timer ticks, which keeps the
+ * shell responsive while background jobs run.
+ *
+ * @return true if the task has been cancelled and should stop
+ */
+bool task_poll() {
+    if (get_ticks() - current_task->slice_start >= TASK_SLICE_TICKS) {
+        current_task->slice_start = get_ticks();
+        task_yield();
+    }
+    return current_task->cancelled;
+}
+
+/**
+ * Timer Interrupt Taken in Ring 3
+ *
+ * Called after the EOI. A cancelled task's process is killed on the spot;
+ * otherwise the task is switched out once its slice is used up, so a busy
+ * user program cannot starve the shell.
+ */
+void task_preempt_user() {
+    if (!current_task || !process_current()) {
+        return;
+    }
+    if (current_task->cancelled) {
+        process_exit(PROCESS_KILLED_STATUS);
+    }
+    if (get_ticks() - current_task->slice_start >= TASK_SLICE_TICKS) {
+        task_yield();
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * ============================================================================
+ * RusticOS Kernel Task Header (task.h)
+ * ============================================================================
+ *
+ * Cooperative kernel tasks. Each task has its own kernel stack and runs
+ * until it calls task_yield() (directly or by blocking on a pipe), at which
+ * point the next ready task runs round-robin. The shell's main loop is task
+ * 0 and owns the boot stack.
+ *
+ * Each task carries its own standard input and output so pipeline stages
+ * can run the same command code against different streams. A task that runs
+ * a user process also remembers it, and switching back to the task restores
+ * that process's address space and kernel stack.
+ *
+ * Job control: every task belongs to a job (0 = the foreground line, n =
+ * background job n); tasks inherit the job of their creator. Ctrl+C and
+ * "kill" cancel a whole job. Kernel code notices at its poll points
+ * (task_poll(), pipe reads/writes); ring-3 code is killed, or preempted
+ * once its time slice is used up, from the timer interrupt.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#include "types.h"
+
+class OutputSink;
+class Pipe;
+struct Process;
+
+// ============================================================================
+// Task Constants
+// ============================================================================
+#define MAX_TASKS           8       // Including the shell (task 0)
+#define TASK_STACK_SIZE     16384
+#define TASK_NAME_LENGTH    32
+#define TASK_SLICE_TICKS    1       // Timer ticks a task may run before task_poll() yields
+
+enum TaskState {
+    TASK_UNUSED = 0,        // Slot free
+    TASK_READY,             // Runnable (or running)
+    TASK_DONE               // Entry function returned; waiting to be reaped
+};
+
+typedef void (*TaskEntry)(void* arg);
+
+/**
+ * Task Control Block
+ */
+struct Task {
+    uint32_t id;
+    TaskState state;
+    char name[TASK_NAME_LENGTH];
+    uintptr_t esp;                  // Saved stack pointer while switched out
+    uint8_t* stack;                 // Bottom of the private stack (nullptr for task 0)
+    TaskEntry entry;
+    void* arg;
+    OutputSink* out;                // Standard output
+    Pipe* in;                       // Standard input (nullptr = none)
+    Process* process;               // User process running on this task, if any
+    uint32_t job;                   // Job the task belongs to (0 = foreground)
+    volatile bool cancelled;        // Set by Ctrl+C / kill; checked at poll points
+    int32_t status;                 // Exit status of the last command run on this task
+    uint64_t slice_start;           // Tick count when the task was last switched in
+};
+
+// Task functions
+void init_tasks();                                      // Turn the current context into task 0
+Task* task_create(const char* name, TaskEntry entry, void* arg);  // Create a ready task
+Task* task_current();                                   // Running task
+void task_yield();                                      // Let the next ready task run
+int32_t task_wait(Task* task);                          // Yield until task is done, free it; returns its status
+void task_exit() __attribute__((noreturn));             // Finish the current task
+uint32_t task_free_slots();                             // Number of tasks that can still be created
+
+// Job control
+void task_set_foreground(uint32_t job);                 // Job that Ctrl+C cancels
+void task_interrupt_foreground();                       // Ctrl+C (called from the keyboard IRQ)
+void task_cancel_job(uint32_t job);                     // Ask every task of a job to stop
+bool task_cancelled();                                  // Has the current task been cancelled?
+void task_clear_cancel();                               // Reset the current task's cancel flag
+bool task_poll();                                       // Yield if the slice is used up; true if cancelled
+void task_preempt_user();                               // Timer IRQ taken in ring 3
+
+// Assembly helper (crt0.s): saves callee-saved registers and EFLAGS, switches stacks
+extern "C" void task_switch(uintptr_t* old_esp, uintptr_t new_esp);
+
+#endif // TASK_H
@@ -40,7 +40,8 @@ volatile uint16_t* const Terminal::VGA_BUFFER = (volatile uint16_t*)0xB8000;
 
 Terminal::Terminal()
     : cursor_x(0), cursor_y(0), foreground_color(LIGHT_GREY), background_color(BLACK),
-      cursor_visible(true), scroll_offset(0), input_pos(0), input_mode(false) {
+      cursor_visible(true), scroll_offset(0), input_pos(0), input_mode(false),
+      cursor_deferred(false), chars_written(0) {
     clear();
 }
 
@@ -96,6 +97,7 @@ void Terminal::setColor(uint8_t fg, uint8_t bg) {
 }
 
 void Terminal::putChar(char c) {
+    chars_written++;
     // Handle control characters
     if (c == '\n') {
         cursor_x = 0;
@@ -186,6 +188,17 @@ void Terminal::write(const char* str) {
     }
 }
 
+void Terminal::write(const char* data, uint32_t len) {
+    // Programming the hardware cursor costs four port writes, so do it once
+    // per block instead of once per character
+    cursor_deferred = true;
+    for (uint32_t i = 0; i < len; ++i) {
+        putChar(data[i]);
+    }
+    cursor_deferred = false;
+    update_cursor();
+}
+
 void Terminal::writeAt(const char* str, uint16_t x, uint16_t y) {
     // Write a string starting at position (x, y) without disturbing cursor state
     if (x >= VGA_WIDTH || y >= VGA_HEIGHT) return;
@@ -204,6 +217,17 @@ void Terminal::writeAt(const char* str, uint16_t x, uint16_t y) {
     redraw_title_bar();
 }
 
+void Terminal::writeRow(uint16_t y, const char* cells, uint8_t fg, uint8_t bg) {
+    // Full-screen programs redraw whole rows: store the cells straight into
+    // VGA memory, without control characters, wrapping or cursor updates
+    if (y == 0 || y >= VGA_HEIGHT) return;
+    uint16_t attr = (uint16_t)((bg << 4) | fg) << 8;
+    volatile uint16_t* row = VGA_BUFFER + y * VGA_WIDTH;
+    for (uint16_t x = 0; x < VGA_WIDTH; ++x) {
+        row[x] = (uint8_t)cells[x] | attr;
+    }
+}
+
 void Terminal::setCursor(uint16_t x, uint16_t y) {
     if (x >= VGA_WIDTH) x = VGA_WIDTH - 1;
     if (y >= VGA_HEIGHT) y = VGA_HEIGHT - 1;
@@ -233,6 +257,7 @@ void Terminal::showCursor(bool show) {
 
 void Terminal::update_cursor() {
     // Program VGA hardware cursor to follow cursor_x/cursor_y
+    if (cursor_deferred) return;
     uint16_t pos = (uint16_t)(cursor_y * VGA_WIDTH + cursor_x);
     outb(0x3D4, 0x0F);
     outb(0x3D5, (uint8_t)(pos & 0xFF));
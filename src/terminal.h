@@ -66,6 +66,8 @@ private:
     char input_buffer[INPUT_BUFFER_SIZE];
     uint16_t input_pos;
     bool input_mode;
+    bool cursor_deferred;            // Skip hardware cursor updates during a block write
+    uint32_t chars_written;          // Characters output since boot (for "time")
 
     // Internal helpers
     void scroll_up();
@@ -81,7 +83,9 @@ public:
     void setColor(uint8_t fg, uint8_t bg = BLACK);
     void putChar(char c);
     void write(const char* str);
+    void write(const char* data, uint32_t len);  // Block write, one cursor update
     void writeAt(const char* str, uint16_t x, uint16_t y);
+    void writeRow(uint16_t y, const char* cells, uint8_t fg, uint8_t bg);  // Exactly one row of cells; no cursor/scroll
 
     // Cursor control
     void setCursor(uint16_t x, uint16_t y);
@@ -104,6 +108,7 @@ public:
     uint16_t getHeight() const { return VGA_HEIGHT; }
     uint16_t getCursorX() const { return cursor_x; }
     uint16_t getCursorY() const { return cursor_y; }
+    uint32_t getCharsWritten() const { return chars_written; }
 
     // Drawing helpers
     void drawBox(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, char border_char = '#');
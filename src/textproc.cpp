@@ -0,0 +1,348 @@
+/*
+ * ============================================================================
+ * RusticOS Text Processing Implementation (textproc.cpp)
+ * ============================================================================
+ *
+ * Word-at-a-time scanning reads four bytes per load through an unaligned,
+ * may_alias type; x86 handles the unaligned loads in hardware.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "textproc.h"
+#include "pipe.h"
+#include "format.h"
+
+typedef uint32_t __attribute__((may_alias, aligned(1))) unaligned_u32;
+
+#define SORT_INSERTION_LIMIT    16      // Ranges this short are insertion sorted
+
+// ============================================================================
+// Counting
+// ============================================================================
+
+/**
+ * Count Newlines a Word at a Time
+ *
+ * XOR with "\n\n\n\n" turns newline bytes into zero bytes. The classic
+ * exact zero-byte test then leaves 0x80 in each such byte, and a multiply
+ * by 0x01010101 adds the four flags into the top byte.
+ */
+uint32_t text_count_lines(const char* data, uint32_t len) {
+    uint32_t count = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        uint32_t word = *(const unaligned_u32*)(data + i) ^ 0x0A0A0A0Au;
+        uint32_t zero = ~(((word & 0x7F7F7F7Fu) + 0x7F7F7F7Fu) | word) & 0x80808080u;
+        count += ((zero >> 7) * 0x01010101u) >> 24;
+    }
+    for (; i < len; ++i) {
+        if (data[i] == '\n') count++;
+    }
+    return count;
+}
+
+static inline bool is_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * Count Lines, Words and Bytes of a Block
+ *
+ * A word split between two blocks is counted once: counts.in_word carries
+ * the state over.
+ */
+void text_count(const char* data, uint32_t len, TextCounts& counts) {
+    counts.lines += text_count_lines(data, len);
+    counts.bytes += len;
+    bool in_word = counts.in_word;
+    uint32_t words = 0;
+    for (uint32_t i = 0; i < len; ++i) {
+        bool space = is_space(data[i]);
+        words += (!space && !in_word) ? 1 : 0;
+        in_word = !space;
+    }
+    counts.words += words;
+    counts.in_word = in_word;
+}
+
+// ============================================================================
+// Sorting
+// ============================================================================
+
+/**
+ * Split a Document into Lines
+ *
+ * A final line without a newline is included; a final newline does not
+ * start an empty line.
+ */
+uint32_t text_split_lines(const char* data, uint32_t len, LineRef* lines, uint32_t max_lines) {
+    uint32_t count = 0;
+    uint32_t start = 0;
+    for (uint32_t i = 0; i < len && count < max_lines; ++i) {
+        if (data[i] == '\n') {
+            lines[count].offset = start;
+            lines[count].length = i - start;
+            count++;
+            start = i + 1;
+        }
+    }
+    if (start < len && count < max_lines) {
+        lines[count].offset = start;
+        lines[count].length = len - start;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Compare two Lines Byte-wise (a shorter prefix sorts first)
+ */
+static inline bool line_less(const char* data, const LineRef& a, const LineRef& b) {
+    const uint8_t* x = (const uint8_t*)data + a.offset;
+    const uint8_t* y = (const uint8_t*)data + b.offset;
+    uint32_t n = (a.length < b.length) ? a.length : b.length;
+    for (uint32_t i = 0; i < n; ++i) {
+        if (x[i] != y[i]) return x[i] < y[i];
+    }
+    return a.length < b.length;
+}
+
+static inline void swap_lines(LineRef& a, LineRef& b) {
+    LineRef t = a;
+    a = b;
+    b = t;
+}
+
+static void insertion_sort(const char* data, LineRef* lines, uint32_t count) {
+    for (uint32_t i = 1; i < count; ++i) {
+        LineRef value = lines[i];
+        uint32_t j = i;
+        for (; j > 0 && line_less(data, value, lines[j - 1]); --j) {
+            lines[j] = lines[j - 1];
+        }
+        lines[j] = value;
+    }
+}
+
+static void sift_down(const char* data, LineRef* lines, uint32_t root, uint32_t count) {
+    while (true) {
+        uint32_t child = root * 2 + 1;
+        if (child >= count) return;
+        if (child + 1 < count && line_less(data, lines[child], lines[child + 1])) child++;
+        if (!line_less(data, lines[root], lines[child])) return;
+        swap_lines(lines[root], lines[child]);
+        root = child;
+    }
+}
+
+static void heap_sort(const char* data, LineRef* lines, uint32_t count) {
+    for (uint32_t i = count / 2; i-- > 0;) {
+        sift_down(data, lines, i, count);
+    }
+    for (uint32_t end = count; end-- > 1;) {
+        swap_lines(lines[0], lines[end]);
+        sift_down(data, lines, 0, end);
+    }
+}
+
+/**
+ * Quicksort with a Depth Limit
+ *
+ * Median-of-three pivot and Hoare partitioning. The smaller side recurses
+ * and the larger side loops, so the stack depth stays logarithmic; past
+ * depth_limit (adversarial input) the range is heap sorted instead.
+ * Ranges of SORT_INSERTION_LIMIT lines or fewer are left for the final
+ * insertion sort pass.
+ */
+static void introsort(const char* data, LineRef* lines, uint32_t count, uint32_t depth_limit) {
+    while (count > SORT_INSERTION_LIMIT) {
+        if (depth_limit == 0) {
+            heap_sort(data, lines, count);
+            return;
+        }
+        depth_limit--;
+
+        uint32_t mid = count / 2;
+        if (line_less(data, lines[mid], lines[0])) swap_lines(lines[mid], lines[0]);
+        if (line_less(data, lines[count - 1], lines[0])) swap_lines(lines[count - 1], lines[0]);
+        if (line_less(data, lines[count - 1], lines[mid])) swap_lines(lines[count - 1], lines[mid]);
+        LineRef pivot = lines[mid];
+
+        uint32_t i = 0;
+        uint32_t j = count - 1;
+        while (true) {
+            while (line_less(data, lines[i], pivot)) i++;
+            while (line_less(data, pivot, lines[j])) j--;
+            if (i >= j) break;
+            swap_lines(lines[i], lines[j]);
+            i++;
+            j--;
+        }
+        uint32_t left = j + 1;              // lines[0..left) <= pivot <= lines[left..count)
+        if (left < count - left) {
+            introsort(data, lines, left, depth_limit);
+            lines += left;
+            count -= left;
+        } else {
+            introsort(data, lines + left, count - left, depth_limit);
+            count = left;
+        }
+    }
+}
+
+/**
+ * Sort a Line Table
+ *
+ * Only the LineRef entries move; the text is not touched.
+ */
+void text_sort_lines(const char* data, LineRef* lines, uint32_t count) {
+    uint32_t depth_limit = 0;
+    for (uint32_t n = count; n > 1; n >>= 1) {
+        depth_limit += 2;
+    }
+    introsort(data, lines, count, depth_limit);
+    insertion_sort(data, lines, count);
+}
+
+// ============================================================================
+// head / tail
+// ============================================================================
+
+/**
+ * Length of the First Lines of a Block
+ *
+ * @param lines In: lines still wanted; out: reduced by the newlines found
+ * @return Bytes up to and including the last wanted newline (len if the
+ *         block ends first)
+ */
+uint32_t text_head_length(const char* data, uint32_t len, uint32_t* lines) {
+    uint32_t wanted = *lines;
+    for (uint32_t i = 0; i < len && wanted > 0; ++i) {
+        if (data[i] == '\n' && --wanted == 0) {
+            *lines = 0;
+            return i + 1;
+        }
+    }
+    *lines = wanted;
+    return wanted ? len : 0;
+}
+
+/**
+ * Start of the Last Lines
+ *
+ * Scans backwards from the end, so only the returned lines are read. A
+ * final newline belongs to the last line rather than starting a new one.
+ */
+uint32_t text_tail_offset(const char* data, uint32_t len, uint32_t lines) {
+    if (lines == 0 || len == 0) {
+        return len;
+    }
+    uint32_t i = len;
+    if (data[i - 1] == '\n') i--;
+    while (i > 0) {
+        if (data[i - 1] == '\n' && --lines == 0) {
+            return i;
+        }
+        i--;
+    }
+    return 0;
+}
+
+// ============================================================================
+// LineReader
+// ============================================================================
+
+LineReader::LineReader(const char* data, uint32_t size)
+    : data(data), size(size), pos(0), input(nullptr) {
+}
+
+LineReader::LineReader(Pipe* input)
+    : data(buffer), size(0), pos(0), input(input) {
+}
+
+bool LineReader::next(const char** line, uint32_t* len) {
+    uint32_t scanned = pos;
+    while (true) {
+        for (uint32_t i = scanned; i < size; ++i) {
+            if (data[i] == '\n') {
+                *line = data + pos;
+                *len = i - pos;
+                pos = i + 1;
+                return true;
+            }
+        }
+        if (!input || size - pos == TEXT_LINE_BUFFER) {
+            // End of the data, or a line filling the whole buffer: hand it out as is
+            if (pos == size) {
+                return false;
+            }
+            *line = data + pos;
+            *len = size - pos;
+            pos = size;
+            return true;
+        }
+        // Move the partial line to the front and read more behind it
+        uint32_t partial = size - pos;
+        if (pos > 0) {
+            for (uint32_t i = 0; i < partial; ++i) {
+                buffer[i] = buffer[pos + i];
+            }
+            pos = 0;
+            size = partial;
+        }
+        uint32_t n = input->read(buffer + size, TEXT_LINE_BUFFER - size);
+        if (n == 0) {
+            input = nullptr;
+        }
+        scanned = size;
+        size += n;
+    }
+}
+
+// ============================================================================
+// uniq
+// ============================================================================
+
+/**
+ * Collapse Runs of Equal Lines
+ *
+ * Lines of file data stay valid, so the previous line is compared where it
+ * lies, whatever its length. Piped lines are only valid until the next
+ * call and are copied to the caller's saved buffer; the reader hands them
+ * out in pieces of at most TEXT_LINE_BUFFER bytes.
+ */
+void text_uniq(LineReader& reader, char* saved, bool counts, OutputSink& out) {
+    const char* previous = saved;
+    uint32_t previous_len = 0;
+    uint32_t repeats = 0;
+    const char* line;
+    uint32_t len;
+    while (true) {
+        bool more = reader.next(&line, &len);
+        bool same = more && repeats > 0 && len == previous_len;
+        for (uint32_t i = 0; same && i < len; ++i) {
+            same = line[i] == previous[i];
+        }
+        if (same) {
+            repeats++;
+            continue;
+        }
+        if (repeats > 0) {
+            if (counts) kprintf(out, "%7u ", repeats);
+            out.write(previous, previous_len);
+            out.put('\n');
+        }
+        if (!more) break;
+        if (reader.lines_persist()) {
+            previous = line;
+            previous_len = len;
+        } else {
+            previous_len = (len < TEXT_LINE_BUFFER) ? len : TEXT_LINE_BUFFER;
+            memcpy(saved, line, previous_len);
+            previous = saved;
+        }
+        repeats = 1;
+    }
+}
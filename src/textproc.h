@@ -0,0 +1,93 @@
+/*
+ * ============================================================================
+ * RusticOS Text Processing Header (textproc.h)
+ * ============================================================================
+ *
+ * Kernels behind the wc, sort, uniq, head and tail commands. They work on
+ * text in place: a file is processed straight from its in-memory data,
+ * lines are described by offset/length pairs into that data, and piped
+ * input is read through one fixed buffer. No function allocates per line.
+ *
+ *   text_count_lines     Newlines, four bytes per step (SWAR compare)
+ *   text_count           Lines, words and bytes; resumable across blocks
+ *   text_split_lines     Line table for sorting
+ *   text_sort_lines      Introsort: quicksort, heapsort past a depth limit,
+ *                        insertion sort for short ranges
+ *   text_head_length     Bytes that make up the first n lines
+ *   text_tail_offset     Start of the last n lines, found scanning backwards
+ *   text_uniq            Collapse runs of equal lines
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef TEXTPROC_H
+#define TEXTPROC_H
+
+#include "types.h"
+
+class Pipe;
+class OutputSink;
+
+// ============================================================================
+// Text Processing Constants
+// ============================================================================
+#define TEXT_LINE_BUFFER    4096    // LineReader buffer; longer lines are split
+#define TEXT_TAIL_WINDOW    8192    // Bytes of piped input "tail" keeps
+
+/**
+ * Running counts for wc (zero-initialize, then feed blocks to text_count)
+ */
+struct TextCounts {
+    uint32_t lines;
+    uint32_t words;
+    uint32_t bytes;
+    bool in_word;                   // Previous block ended inside a word
+};
+
+/**
+ * LineRef - one line of a document (without its newline)
+ */
+struct LineRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+// Counting
+uint32_t text_count_lines(const char* data, uint32_t len);              // Number of '\n' bytes
+void text_count(const char* data, uint32_t len, TextCounts& counts);    // Add a block to counts
+
+// Line tables and sorting
+uint32_t text_split_lines(const char* data, uint32_t len, LineRef* lines, uint32_t max_lines);  // Returns the line count (at most max_lines)
+void text_sort_lines(const char* data, LineRef* lines, uint32_t count);  // Byte-wise ascending, stable not guaranteed
+
+// head / tail
+uint32_t text_head_length(const char* data, uint32_t len, uint32_t* lines);  // Bytes of up to *lines lines; *lines -= lines found
+uint32_t text_tail_offset(const char* data, uint32_t len, uint32_t lines);   // Offset of the last lines lines
+
+/**
+ * LineReader - yields the lines of a file's data or of a pipe
+ *
+ * Lines are returned without their newline. For a pipe, the pointer is
+ * valid until the next call; lines longer than TEXT_LINE_BUFFER come back
+ * in pieces.
+ */
+class LineReader {
+public:
+    LineReader(const char* data, uint32_t size);
+    explicit LineReader(Pipe* input);
+    bool next(const char** line, uint32_t* len);   // false at the end of the input
+    bool lines_persist() const { return data != buffer; }  // Lines stay valid after the next call
+
+private:
+    const char* data;
+    uint32_t size;                  // Bytes valid in data
+    uint32_t pos;                   // Start of the next line
+    Pipe* input;                    // nullptr for in-memory data
+    char buffer[TEXT_LINE_BUFFER];
+};
+
+// uniq
+void text_uniq(LineReader& reader, char* saved, bool counts, OutputSink& out);  // saved: TEXT_LINE_BUFFER bytes unless reader.lines_persist(); counts: prefix repeat counts
+
+#endif // TEXTPROC_H
@@ -20,7 +20,8 @@
 // ============================================================================
 // Fixed-Width Integer Types
 // ============================================================================
-// Standard fixed-width integer types for 32-bit architecture
+// Standard fixed-width integer types, the same on i686 and x86-64 (ILP32
+// and LP64: only long and pointers change size)
 // These ensure consistent sizes regardless of compiler settings
 
 // Unsigned integer types
@@ -39,6 +40,7 @@ typedef signed long long    int64_t;   // 64-bit signed integer
 // Standard Types
 // ============================================================================
 typedef unsigned long       size_t;    // Size type (used for object sizes and array indices)
+typedef unsigned long       uintptr_t; // Integer wide enough to hold a pointer (32 or 64 bits)
 
 // Note: bool, true, and false are built-in C++ types/constants
 // They are available in C++ without needing to define them here
@@ -60,4 +62,58 @@ extern "C" {
     size_t strlen(const char* s);                        // Get string length
 }
 
+// Heap (cxxabi.cpp): a static pool serves allocations until boot hands over
+// a larger region (heap_kb kernel parameter). One allocation holds at most
+// HEAP_MAX_ALLOCATION bytes, and only while a 64 KB block is unused or free:
+// the default region has room for several, the static pool alone (heap_kb=64)
+// has none left once the shell is up
+#define HEAP_POOL_SIZE  65536
+#define HEAP_DEFAULT_SIZE   (512 * 1024)                    // Default heap_kb region
+#define HEAP_BLOCK_HEADER   (2 * (uint32_t)sizeof(void*))   // 8 bytes on i686, 16 on x86-64
+#define HEAP_MAX_ALLOCATION (65536 - HEAP_BLOCK_HEADER)     // The 64 KB size class less its header (65528 or 65520 bytes)
+void heap_add_region(void* base, uint32_t size);
+
+// Usable bytes of the smallest heap block that holds `bytes`, or 0 past
+// HEAP_MAX_ALLOCATION. Growing buffers take these sizes: a power of two
+// plus the header would waste most of the next class up.
+static inline uint32_t heap_block_capacity(uint32_t bytes) {
+    uint32_t block = 16;
+    while (block - HEAP_BLOCK_HEADER < bytes) {
+        if (block == 65536) {
+            return 0;
+        }
+        block <<= 1;
+    }
+    return block - HEAP_BLOCK_HEADER;
+}
+
+// Heap usage counters (cxxabi.cpp), cumulative since boot
+struct HeapStats {
+    uint32_t allocations;
+    uint32_t frees;
+    uint64_t bytes_allocated;       // Block sizes, including headers
+    uint64_t bytes_freed;
+};
+void heap_get_stats(HeapStats* stats);
+
+// ============================================================================
+// 64-bit Arithmetic Helpers
+// ============================================================================
+// The kernel is not linked against libgcc, so 64-bit division by a variable
+// (__udivdi3) is unavailable on i686. div_u64 divides by a 32-bit value with
+// two 32-bit DIV instructions instead; x86-64 has a native 64-bit DIV.
+static inline uint64_t div_u64(uint64_t value, uint32_t divisor) {
+#ifdef __x86_64__
+    return value / divisor;
+#else
+    uint32_t high = (uint32_t)(value >> 32);
+    uint32_t low = (uint32_t)value;
+    uint32_t q_high = high / divisor;
+    uint32_t rem = high % divisor;
+    uint32_t q_low;
+    asm("divl %4" : "=a"(q_low), "=d"(rem) : "a"(low), "d"(rem), "rm"(divisor));
+    return ((uint64_t)q_high << 32) | q_low;
+#endif
+}
+
 #endif // TYPES_H
\ No newline at end of file
@@ -1,32 +1,42 @@
 #include "types.h"
 #include "virtual_disk.h"
-
-static uint8_t VDISK_BUFFER[VDISK_SECTOR_SIZE * VDISK_NUM_SECTORS];
+#include "paging.h"
 
 VirtualDisk vdisk;
 
-VirtualDisk::VirtualDisk() {
-    // Optionally zero on startup
+VirtualDisk::VirtualDisk() : storage(nullptr), sectors(0), reads(0), writes(0) {
+    // Storage is reserved by init() once the disk size is known
+}
+
+bool VirtualDisk::init(uint32_t num_sectors) {
+    storage = (uint8_t*)reserve_kernel_memory(num_sectors * VDISK_SECTOR_SIZE);
+    sectors = storage ? num_sectors : 0;
+    reads = 0;
+    writes = 0;
+    clear();
+    return storage != nullptr;
 }
 
 void VirtualDisk::clear() {
-    for (uint32_t i = 0; i < VDISK_SECTOR_SIZE * VDISK_NUM_SECTORS; ++i) {
-        VDISK_BUFFER[i] = 0;
+    if (storage) {
+        memset(storage, 0, sectors * VDISK_SECTOR_SIZE);
     }
 }
 
 bool VirtualDisk::read_sector(uint32_t lba, void* out_buffer) {
-    if (!out_buffer || lba >= VDISK_NUM_SECTORS) return false;
+    if (!out_buffer || lba >= sectors) return false;
     uint8_t* dst = reinterpret_cast<uint8_t*>(out_buffer);
-    const uint8_t* src = &VDISK_BUFFER[lba * VDISK_SECTOR_SIZE];
+    const uint8_t* src = &storage[lba * VDISK_SECTOR_SIZE];
     for (uint32_t i = 0; i < VDISK_SECTOR_SIZE; ++i) dst[i] = src[i];
+    reads++;
     return true;
 }
 
 bool VirtualDisk::write_sector(uint32_t lba, const void* in_buffer) {
-    if (!in_buffer || lba >= VDISK_NUM_SECTORS) return false;
+    if (!in_buffer || lba >= sectors) return false;
     const uint8_t* src = reinterpret_cast<const uint8_t*>(in_buffer);
-    uint8_t* dst = &VDISK_BUFFER[lba * VDISK_SECTOR_SIZE];
+    uint8_t* dst = &storage[lba * VDISK_SECTOR_SIZE];
     for (uint32_t i = 0; i < VDISK_SECTOR_SIZE; ++i) dst[i] = src[i];
+    writes++;
     return true;
 }
\ No newline at end of file
@@ -8,14 +8,26 @@
 // into/out of this buffer. It provides a clean block interface for the filesystem.
 
 static const uint32_t VDISK_SECTOR_SIZE = 512;
-static const uint32_t VDISK_NUM_SECTORS = 4096; // 2 MiB image
+static const uint32_t VDISK_NUM_SECTORS = 4096; // Default size (2 MiB image); see vdisk_sectors in params.h
 
 class VirtualDisk {
 public:
     VirtualDisk();
+    bool init(uint32_t num_sectors);   // Reserve and clear the storage; returns false if memory is short
     void clear();
+    uint32_t sector_count() const { return sectors; }
     bool read_sector(uint32_t lba, void* out_buffer);     // returns false if out of range
     bool write_sector(uint32_t lba, const void* in_buffer); // returns false if out of range
+
+    // I/O counters (sectors transferred since boot)
+    uint32_t sectors_read() const { return reads; }
+    uint32_t sectors_written() const { return writes; }
+
+private:
+    uint8_t* storage;
+    uint32_t sectors;
+    uint32_t reads;
+    uint32_t writes;
 };
 
 extern VirtualDisk vdisk;
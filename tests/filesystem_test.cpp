@@ -0,0 +1,120 @@
+/*
+ * ============================================================================
+ * RusticOS Filesystem Tests (tests/filesystem_test.cpp)
+ * ============================================================================
+ *
+ * FileSystem::append growing a file up to the largest heap block, and
+ * failing cleanly (false, content intact) past it or when the heap runs
+ * out; FileSystem::replace from two pieces; an open file cannot be removed
+ * or moved. The heap continues in a 512 KB region, as after boot.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "test.h"
+#include "../src/filesystem.h"
+#include "../src/terminal.h"
+
+// filesystem.cpp reports some errors on the terminal; drop them
+Terminal::Terminal() {}
+void Terminal::write(const char*) {}
+Terminal terminal;
+
+static uint8_t heap_region[HEAP_DEFAULT_SIZE] __attribute__((aligned(16)));
+static char chunk[1000];
+
+/**
+ * Append chunk until append fails
+ *
+ * @return Bytes appended
+ */
+static uint32_t fill(FileNode* file) {
+    uint32_t total = 0;
+    while (filesystem.append(file, chunk, sizeof(chunk))) {
+        total += sizeof(chunk);
+    }
+    // The last, partial chunk up to the limit
+    while (filesystem.append(file, chunk + total % sizeof(chunk), 1)) {
+        total++;
+    }
+    return total;
+}
+
+static bool content_intact(const FileNode* file) {
+    for (uint32_t i = 0; i < file->size; ++i) {
+        if (file->data[i] != chunk[i % sizeof(chunk)]) return false;
+    }
+    return file->data[file->size] == '\0';
+}
+
+static void test_append_to_largest_block() {
+    CHECK(filesystem.create_file("big", ""));
+    FileNode* file = filesystem.lookup("big");
+    CHECK(file != nullptr);
+    if (!file) return;
+    CHECK(fill(file) == HEAP_MAX_ALLOCATION - 1);
+    CHECK(file->size == HEAP_MAX_ALLOCATION - 1);
+    CHECK(!filesystem.append(file, chunk, 1));
+    CHECK(content_intact(file));
+}
+
+static void test_replace_from_two_pieces() {
+    CHECK(filesystem.create_file("gap", "old"));
+    FileNode* file = filesystem.lookup("gap");
+    CHECK(file != nullptr);
+    if (!file) return;
+    CHECK(filesystem.replace(file, "ab", 2, "cde", 3));
+    CHECK(file->size == 5 && strcmp(file->data, "abcde") == 0);
+
+    // A buffer that is large enough is reused
+    const char* data = file->data;
+    CHECK(filesystem.replace(file, "x", 1, "", 0));
+    CHECK(file->data == data && strcmp(file->data, "x") == 0);
+
+    // Past the largest heap block the content stays as it was
+    CHECK(!filesystem.replace(file, chunk, HEAP_MAX_ALLOCATION - 1, "z", 1));
+    CHECK(strcmp(file->data, "x") == 0);
+}
+
+static void test_open_file_stays() {
+    CHECK(filesystem.create_file("held", "data"));
+    FileNode* file = filesystem.lookup("held");
+    CHECK(file != nullptr);
+    if (!file) return;
+    file->open_count++;
+    CHECK(!filesystem.remove("held"));
+    CHECK(!filesystem.move("held", "other"));
+    CHECK(filesystem.lookup("held") == file);
+    file->open_count--;
+    CHECK(filesystem.move("held", "other"));
+    CHECK(filesystem.remove("other"));
+    CHECK(filesystem.lookup("other") == nullptr);
+}
+
+static void test_append_out_of_memory() {
+    // Each full file holds a 64 KB block; the region runs out first
+    char name[] = "f0";
+    bool short_file = false;
+    for (uint32_t i = 0; i < 10 && !short_file; ++i) {
+        name[1] = (char)('0' + i);
+        if (!filesystem.create_file(name, "")) break;
+        FileNode* file = filesystem.lookup(name);
+        CHECK(file != nullptr);
+        if (!file) return;
+        short_file = fill(file) < HEAP_MAX_ALLOCATION - 1;
+        CHECK(content_intact(file));
+    }
+    CHECK(short_file);
+}
+
+void run_tests() {
+    heap_add_region(heap_region, sizeof(heap_region));
+    for (uint32_t i = 0; i < sizeof(chunk); ++i) {
+        chunk[i] = (char)('a' + i % 26);
+    }
+    test_append_to_largest_block();
+    test_replace_from_two_pieces();
+    test_open_file_stays();
+    test_append_out_of_memory();
+}
@@ -0,0 +1,66 @@
+/*
+ * ============================================================================
+ * RusticOS Heap Tests (tests/heap_test.cpp)
+ * ============================================================================
+ *
+ * Drives the size-class heap (src/cxxabi.cpp) to exhaustion: new must then
+ * return nullptr, the null checks after it must survive the optimizer, and
+ * a freed block must be handed out again.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "test.h"
+
+static uint32_t constructed;
+
+struct Counted {
+    uint32_t value;
+    Counted() : value(1) { constructed++; }
+};
+
+/**
+ * Allocate the Way Kernel Code Does
+ *
+ * @return false if new returned nullptr
+ */
+static bool try_alloc(uint32_t size, char** out) {
+    char* p = new char[size];
+    if (!p) {
+        return false;
+    }
+    p[0] = 'x';
+    p[size - 1] = 'y';
+    *out = p;
+    return true;
+}
+
+static void test_largest_block() {
+    // Nothing has been allocated yet: the whole static pool is one 64 KB block
+    char* big = nullptr;
+    CHECK(try_alloc(HEAP_MAX_ALLOCATION, &big));
+    CHECK(big != nullptr);
+
+    char* again = nullptr;
+    CHECK(!try_alloc(HEAP_MAX_ALLOCATION, &again));
+    CHECK(again == nullptr);
+    CHECK(!try_alloc(HEAP_MAX_ALLOCATION + 1, &again));
+    CHECK(!try_alloc(16, &again));
+
+    // An object whose allocation fails is not constructed
+    constructed = 0;
+    Counted* obj = new Counted;
+    CHECK(obj == nullptr);
+    CHECK(constructed == 0);
+
+    // The freed block comes back from its free list
+    delete[] big;
+    CHECK(try_alloc(HEAP_MAX_ALLOCATION, &again));
+    CHECK(again == big);
+    delete[] again;
+}
+
+void run_tests() {
+    test_largest_block();
+}
@@ -0,0 +1,145 @@
+/*
+ * ============================================================================
+ * RusticOS Pager Tests (tests/pager_test.cpp)
+ * ============================================================================
+ *
+ * Drives pager_run with scripted keys over a document of PAGER_TEST_LINES
+ * lines, larger than both the piped-input window and the line index, and
+ * checks the rows it draws: the last page, a search far past the first
+ * window, and scrolling back (a file is re-indexed, piped input stops at
+ * the oldest line held).
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "test.h"
+#include "../src/pager.h"
+#include "../src/pipe.h"
+#include "../src/terminal.h"
+#include "../src/keyboard.h"
+#include "../src/format.h"
+
+#define PAGER_TEST_LINES    6000
+#define SCREEN_WIDTH        80
+#define SCREEN_ROWS         25
+
+static char screen[SCREEN_ROWS][SCREEN_WIDTH + 1];
+
+// The pager draws through writeRow; the rest of the terminal is not needed
+Terminal::Terminal() {}
+void Terminal::write(const char*) {}
+void Terminal::clear() {}
+void Terminal::setCursor(uint16_t, uint16_t) {}
+void Terminal::writeRow(uint16_t y, const char* cells, uint8_t, uint8_t) {
+    memcpy(screen[y], cells, SCREEN_WIDTH);
+    screen[y][SCREEN_WIDTH] = '\0';
+}
+Terminal terminal;
+
+// Keys come from a script; an exhausted script quits
+static const char* keys;
+
+KeyboardDriver::KeyboardDriver() {}
+bool KeyboardDriver::get_key_event(KeyEvent& event) {
+    memset(&event, 0, sizeof(event));
+    event.pressed = true;
+    event.ascii = (uint8_t)((keys && *keys) ? *keys++ : 'q');
+    return true;
+}
+KeyboardDriver keyboard;
+
+static char document[PAGER_TEST_LINES * 10];
+static uint32_t document_size;
+
+// Producer side of the pipe: a few lines whenever the pager waits for input
+static Pipe* feed_pipe;
+static uint32_t fed;
+
+static void feed() {
+    if (fed == document_size) {
+        feed_pipe->close_write();
+        return;
+    }
+    uint32_t chunk = document_size - fed;
+    if (chunk > 300) chunk = 300;
+    feed_pipe->write(document + fed, chunk);
+    fed += chunk;
+}
+
+/**
+ * Does a Screen Row Start with text (followed by blanks)?
+ */
+static bool row_is(uint32_t row, const char* text) {
+    uint32_t len = strlen(text);
+    for (uint32_t x = 0; x < SCREEN_WIDTH; ++x) {
+        char want = (x < len) ? text[x] : ' ';
+        if (screen[row][x] != want) return false;
+    }
+    return true;
+}
+
+static bool status_starts(const char* text) {
+    uint32_t len = strlen(text);
+    for (uint32_t x = 0; x < len; ++x) {
+        if (screen[SCREEN_ROWS - 1][x] != text[x]) return false;
+    }
+    return true;
+}
+
+static int32_t page_pipe(const char* script) {
+    feed_pipe = pipe_create();
+    fed = 0;
+    keys = script;
+    test_yield_hook = feed;
+    int32_t status = pager_run("(standard input)", nullptr, 0, feed_pipe);
+    test_yield_hook = nullptr;
+    feed_pipe->close_read();
+    if (fed < document_size) feed_pipe->close_write();
+    return status;
+}
+
+static int32_t page_file(const char* script) {
+    keys = script;
+    return pager_run("doc", document, document_size, nullptr);
+}
+
+static void test_pipe_last_page() {
+    // The final draw is the one before the scripted 'q'
+    CHECK(page_pipe("G") == 0);
+    CHECK(row_is(1, "line 5977"));
+    CHECK(row_is(23, "line 5999"));
+    CHECK(status_starts(" (standard input)  lines 5978-6000 of 6000  (END)"));
+}
+
+static void test_pipe_search_and_back() {
+    CHECK(page_pipe("/line 5000\n") == 0);
+    CHECK(row_is(1, "line 5000"));
+    CHECK(row_is(2, "line 5001"));
+
+    CHECK(page_pipe("/line 5000\ng") == 0);
+    CHECK(status_starts(" Earlier input was discarded"));
+    CHECK(!row_is(1, "line 0"));
+}
+
+static void test_file_search_and_back() {
+    CHECK(page_file("/line 4000\nb") == 0);
+    CHECK(row_is(1, "line 3977"));
+
+    CHECK(page_file("Gg") == 0);
+    CHECK(row_is(1, "line 0"));
+    CHECK(status_starts(" doc  lines 1-23"));
+
+    CHECK(page_file("G/line 12\n") == 0);
+    CHECK(status_starts(" Pattern not found"));
+}
+
+void run_tests() {
+    for (uint32_t i = 0; i < PAGER_TEST_LINES; ++i) {
+        document_size += ksnprintf(document + document_size, sizeof(document) - document_size,
+                                   "line %u\n", i);
+    }
+    test_pipe_last_page();
+    test_pipe_search_and_back();
+    test_file_search_and_back();
+}
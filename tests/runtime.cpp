@@ -0,0 +1,112 @@
+/*
+ * ============================================================================
+ * RusticOS Host Test Runtime (tests/runtime.cpp)
+ * ============================================================================
+ *
+ * Entry point and Linux system calls (INT 0x80, or SYSCALL in the
+ * ARCH=x86_64 build) for the host tests, plus
+ * stand-ins for the task switcher: a test runs as the only task, so
+ * nothing is ever cancelled and yielding only runs test_yield_hook (a test
+ * can set it to play the other end of a pipe).
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "test.h"
+
+#ifdef __x86_64__
+#define LINUX_SYS_EXIT      60
+#define LINUX_SYS_WRITE     1
+#else
+#define LINUX_SYS_EXIT      1
+#define LINUX_SYS_WRITE     4
+#endif
+#define LINUX_STDOUT        1
+
+static uint32_t checks;
+static uint32_t failures;
+
+static int32_t linux_syscall(uintptr_t nr, uintptr_t a, uintptr_t b, uintptr_t c) {
+    int32_t result;
+#ifdef __x86_64__
+    asm volatile("syscall"
+                 : "=a"(result)
+                 : "a"(nr), "D"(a), "S"(b), "d"(c)
+                 : "rcx", "r11", "memory");
+#else
+    asm volatile("int $0x80"
+                 : "=a"(result)
+                 : "a"(nr), "b"(a), "c"(b), "d"(c)
+                 : "memory");
+#endif
+    return result;
+}
+
+void test_print(const char* text) {
+    linux_syscall(LINUX_SYS_WRITE, LINUX_STDOUT, (uintptr_t)text, strlen(text));
+}
+
+static void print_uint(uint32_t value) {
+    char digits[11];
+    uint32_t i = sizeof(digits) - 1;
+    digits[i] = '\0';
+    do {
+        digits[--i] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    test_print(digits + i);
+}
+
+void test_check(bool ok, const char* what, const char* file, uint32_t line) {
+    checks++;
+    if (ok) return;
+    failures++;
+    test_print(file);
+    test_print(":");
+    print_uint(line);
+    test_print(": check failed: ");
+    test_print(what);
+    test_print("\n");
+}
+
+void (*test_yield_hook)() = nullptr;
+
+// Task switcher stand-ins (src/task.h)
+void task_yield() {
+    if (test_yield_hook) test_yield_hook();
+}
+bool task_cancelled() { return false; }
+bool task_poll() { return false; }
+
+typedef void (*Constructor)();
+extern "C" Constructor __init_array_start[], __init_array_end[];  // From ld's default script
+
+extern "C" void test_start() {
+    // Global constructors (the kernel's static pools hold objects with vtables)
+    for (Constructor* ctor = __init_array_start; ctor < __init_array_end; ++ctor) {
+        (*ctor)();
+    }
+    run_tests();
+    print_uint(checks - failures);
+    test_print("/");
+    print_uint(checks);
+    test_print(" checks passed\n");
+    linux_syscall(LINUX_SYS_EXIT, failures ? 1 : 0, 0, 0);
+}
+
+#ifdef __x86_64__
+asm(".global _start\n"
+    "_start:\n"
+    "    xorl %ebp, %ebp\n"
+    "    andq $~0xF, %rsp\n"
+    "    call test_start\n"
+    "    hlt\n");
+#else
+asm(".global _start\n"
+    "_start:\n"
+    "    xorl %ebp, %ebp\n"
+    "    andl $~0xF, %esp\n"
+    "    call test_start\n"
+    "    hlt\n");
+#endif
@@ -0,0 +1,28 @@
+/*
+ * ============================================================================
+ * RusticOS Host Test Support (tests/test.h)
+ * ============================================================================
+ *
+ * Kernel modules that do not touch hardware can be linked, unchanged and
+ * with the kernel's own flags and runtime (src/cxxabi.cpp), into a
+ * freestanding i386 Linux program. tests/runtime.cpp supplies the entry
+ * point and the Linux system calls; each test file defines run_tests() and
+ * reports through CHECK. The program exits with status 1 if a check failed.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include "../src/types.h"
+
+void run_tests();                                       // Defined by each test file
+void test_print(const char* text);                      // Write to standard output
+void test_check(bool ok, const char* what, const char* file, uint32_t line);
+extern void (*test_yield_hook)();                       // Run by task_yield() (e.g. to feed a pipe)
+
+#define CHECK(expr) test_check((expr), #expr, __FILE__, __LINE__)
+
+#endif // TEST_H
@@ -0,0 +1,112 @@
+/*
+ * ============================================================================
+ * RusticOS Text Processing Tests (tests/textproc_test.cpp)
+ * ============================================================================
+ *
+ * text_uniq over file data and over a pipe, including lines longer than
+ * the TEXT_LINE_BUFFER bytes the pipe reader holds.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "test.h"
+#include "../src/textproc.h"
+#include "../src/pipe.h"
+
+#define LONG_LINE   (TEXT_LINE_BUFFER + 904)
+
+/**
+ * CaptureSink - collects output for comparison
+ */
+class CaptureSink : public OutputSink {
+public:
+    char data[3 * LONG_LINE];
+    uint32_t size;
+
+    CaptureSink() : size(0) {}
+    using OutputSink::write;
+    void write(const char* bytes, uint32_t len) override {
+        for (uint32_t i = 0; i < len && size < sizeof(data); ++i) {
+            data[size++] = bytes[i];
+        }
+    }
+};
+
+static char input[3 * LONG_LINE];
+static char expected[3 * LONG_LINE];
+static char saved[TEXT_LINE_BUFFER];       // uniq's copy of the previous piped line
+
+static bool output_is(const CaptureSink& sink, const char* text, uint32_t len) {
+    if (sink.size != len) return false;
+    for (uint32_t i = 0; i < len; ++i) {
+        if (sink.data[i] != text[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * Append count copies of c and a newline
+ */
+static uint32_t put_line(char* buffer, uint32_t pos, char c, uint32_t count) {
+    memset(buffer + pos, c, count);
+    buffer[pos + count] = '\n';
+    return pos + count + 1;
+}
+
+static void uniq_file(CaptureSink& sink, uint32_t size, bool counts) {
+    sink.size = 0;
+    LineReader reader(input, size);
+    text_uniq(reader, nullptr, counts, sink);
+}
+
+static void test_uniq_short_lines() {
+    CaptureSink sink;
+    const char text[] = "a\na\nb\na\n";
+    memcpy(input, text, sizeof(text) - 1);
+    uniq_file(sink, sizeof(text) - 1, false);
+    CHECK(output_is(sink, "a\nb\na\n", 6));
+    uniq_file(sink, sizeof(text) - 1, true);
+    const char counted[] = "      2 a\n      1 b\n      1 a\n";
+    CHECK(output_is(sink, counted, sizeof(counted) - 1));
+}
+
+static void test_uniq_long_file_lines() {
+    CaptureSink sink;
+    // Two equal lines longer than the pipe buffer collapse into one
+    uint32_t size = put_line(input, 0, 'x', LONG_LINE);
+    size = put_line(input, size, 'x', LONG_LINE);
+    size = put_line(input, size, 'y', 3);
+    uniq_file(sink, size, false);
+    uint32_t want = put_line(expected, 0, 'x', LONG_LINE);
+    want = put_line(expected, want, 'y', 3);
+    CHECK(output_is(sink, expected, want));
+
+    // Lines that only differ past TEXT_LINE_BUFFER stay apart
+    size = put_line(input, 0, 'x', LONG_LINE);
+    size = put_line(input, size, 'x', LONG_LINE);
+    input[size - 2] = 'z';
+    uniq_file(sink, size, false);
+    CHECK(output_is(sink, input, size));
+}
+
+static void test_uniq_pipe() {
+    Pipe* pipe = pipe_create();
+    CHECK(pipe != nullptr);
+    if (!pipe) return;
+    const char text[] = "one\none\none\ntwo\n";
+    pipe->write(text, sizeof(text) - 1);
+    pipe->close_write();
+    CaptureSink sink;
+    LineReader reader(pipe);
+    text_uniq(reader, saved, true, sink);
+    pipe->close_read();
+    const char counted[] = "      3 one\n      1 two\n";
+    CHECK(output_is(sink, counted, sizeof(counted) - 1));
+}
+
+void run_tests() {
+    test_uniq_short_lines();
+    test_uniq_long_file_lines();
+    test_uniq_pipe();
+}
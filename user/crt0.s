@@ -0,0 +1,35 @@
+# ============================================================================
+# RusticOS - User Program Startup (user/crt0.s)
+# ============================================================================
+#
+# Entry point of every user program. The kernel enters at _start with:
+#   [esp] = argc, [esp + 4] = argv (NULL terminated)
+# _start calls main(argc, argv) and passes its return value to SYS_EXIT.
+#
+# Version: 1.0.1
+# ============================================================================
+
+.set USER_VSYSCALL_ADDR, 0x403FF000    # Keep in sync with src/process.h
+.set SYS_EXIT_NR, 1                    # Keep in sync with src/syscall.h
+
+.global _start
+.extern main
+
+.section .text._start
+.code32
+
+_start:
+    xorl %ebp, %ebp          # Terminate frame pointer chains
+    movl (%esp), %eax        # argc
+    movl 4(%esp), %ecx       # argv
+    andl $~0xF, %esp         # Align the stack for main
+    subl $8, %esp
+    pushl %ecx
+    pushl %eax
+    call main
+
+    movl %eax, %ebx          # exit(main's return value)
+    movl $SYS_EXIT_NR, %eax
+    movl $USER_VSYSCALL_ADDR, %edx
+    call *%edx
+1:  jmp 1b                   # Not reached
@@ -0,0 +1,24 @@
+/*
+ * ============================================================================
+ * RusticOS User Program: hello (user/hello.cpp)
+ * ============================================================================
+ *
+ * Prints a greeting and its arguments. Exercises argv passing and SYS_WRITE.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "rustic.h"
+
+extern "C" int main(int argc, char** argv) {
+    print("Hello from user space!\n");
+    for (int i = 0; i < argc; ++i) {
+        print("  argv[");
+        print_uint(i);
+        print("] = ");
+        print(argv[i]);
+        print("\n");
+    }
+    return 0;
+}
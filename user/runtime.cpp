@@ -0,0 +1,47 @@
+/*
+ * ============================================================================
+ * RusticOS User Runtime (user/runtime.cpp)
+ * ============================================================================
+ *
+ * Freestanding helpers linked into every user program.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "rustic.h"
+
+extern "C" {
+    size_t strlen(const char* s) {
+        size_t n = 0;
+        while (s[n]) n++;
+        return n;
+    }
+
+    void* memcpy(void* dst, const void* src, size_t n) {
+        uint8_t* d = (uint8_t*)dst;
+        const uint8_t* s = (const uint8_t*)src;
+        for (size_t i = 0; i < n; ++i) d[i] = s[i];
+        return dst;
+    }
+
+    void* memset(void* p, int c, size_t n) {
+        uint8_t* d = (uint8_t*)p;
+        for (size_t i = 0; i < n; ++i) d[i] = (uint8_t)c;
+        return p;
+    }
+}
+
+int32_t print(const char* s) {
+    return sys_write(STDOUT, s, strlen(s));
+}
+
+int32_t print_uint(uint32_t value) {
+    char buf[12];
+    uint32_t pos = sizeof(buf);
+    do {
+        buf[--pos] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    return sys_write(STDOUT, buf + pos, sizeof(buf) - pos);
+}
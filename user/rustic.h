@@ -0,0 +1,72 @@
+/*
+ * ============================================================================
+ * RusticOS User Runtime Header (user/rustic.h)
+ * ============================================================================
+ *
+ * Minimal runtime for user programs: system call wrappers and a few string
+ * helpers. Programs are freestanding; there is no C library.
+ *
+ * System calls go through the kernel's trampoline page, which uses
+ * SYSENTER or INT 0x80 depending on the CPU (see src/syscall.h).
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#ifndef RUSTIC_H
+#define RUSTIC_H
+
+// ============================================================================
+// Types and Constants (keep in sync with src/types.h and src/syscall.h)
+// ============================================================================
+typedef unsigned char       uint8_t;
+typedef unsigned int        uint32_t;
+typedef signed int          int32_t;
+typedef unsigned long       size_t;
+
+#define USER_VSYSCALL_ADDR  0x403FF000
+
+#define SYS_NULL            0
+#define SYS_EXIT            1
+#define SYS_WRITE           2
+
+#define STDOUT              1
+#define STDERR              2
+
+/**
+ * Issue a System Call
+ *
+ * EAX = number, EBX/ESI/EDI = arguments; the trampoline preserves every
+ * register except EAX.
+ */
+static inline uint32_t syscall3(uint32_t nr, uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t ret;
+    asm volatile("call *%%edx"
+                 : "=a"(ret)
+                 : "a"(nr), "b"(a), "S"(b), "D"(c), "d"(USER_VSYSCALL_ADDR)
+                 : "memory", "cc");
+    return ret;
+}
+
+// System call wrappers
+static inline int32_t sys_write(uint32_t fd, const void* buf, uint32_t len) {
+    return (int32_t)syscall3(SYS_WRITE, fd, (uint32_t)buf, len);
+}
+
+static inline void sys_exit(int32_t status) {
+    syscall3(SYS_EXIT, (uint32_t)status, 0, 0);
+    for (;;) {}
+}
+
+// Runtime helpers (runtime.cpp)
+extern "C" {
+    size_t strlen(const char* s);
+    void* memcpy(void* dst, const void* src, size_t n);
+    void* memset(void* p, int c, size_t n);
+}
+int32_t print(const char* s);                   // Write a string to stdout
+int32_t print_uint(uint32_t value);             // Write a decimal number to stdout
+
+extern "C" int main(int argc, char** argv);
+
+#endif // RUSTIC_H
@@ -0,0 +1,18 @@
+/*
+ * ============================================================================
+ * RusticOS User Program: true (user/true.cpp)
+ * ============================================================================
+ *
+ * Exits immediately with status 0. Used to measure exec latency.
+ *
+ * Version: 1.0.1
+ * ============================================================================
+ */
+
+#include "rustic.h"
+
+extern "C" int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    return 0;
+}